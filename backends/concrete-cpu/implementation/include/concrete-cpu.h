@@ -131,6 +131,21 @@ ScratchStatus concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(size_t *stack_si
                                                                 size_t polynomial_size,
                                                                 const struct Fft *fft);
 
+void concrete_cpu_bootstrap_many_lut_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                        const uint64_t *ct_in,
+                                                        const uint64_t *accumulator,
+                                                        const c64 *fourier_bsk,
+                                                        size_t decomposition_level_count,
+                                                        size_t decomposition_base_log,
+                                                        size_t glwe_dimension,
+                                                        size_t polynomial_size,
+                                                        size_t input_lwe_dimension,
+                                                        size_t lut_count,
+                                                        size_t lut_stride,
+                                                        const struct Fft *fft,
+                                                        uint8_t *stack,
+                                                        size_t stack_size);
+
 void concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(uint64_t *ct_out_vec,
                                                                                 const uint64_t *ct_in_vec,
                                                                                 const uint64_t *lut,
@@ -284,11 +299,19 @@ void concrete_cpu_fill_with_random_gaussian(uint64_t *buffer,
                                             double variance,
                                             struct Csprng *csprng);
 
+void concrete_cpu_fork_encryption_csprng(struct EncCsprng *parent, struct EncCsprng *child);
+
 size_t concrete_cpu_fourier_bootstrap_key_size_u64(size_t decomposition_level_count,
                                                    size_t glwe_dimension,
                                                    size_t polynomial_size,
                                                    size_t input_lwe_dimension);
 
+size_t concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(size_t decomposition_level_count,
+                                                             size_t glwe_dimension,
+                                                             size_t polynomial_size,
+                                                             size_t input_lwe_dimension,
+                                                             size_t grouping_factor);
+
 size_t concrete_cpu_ggsw_ciphertext_size_u64(size_t glwe_dimension,
                                              size_t polynomial_size,
                                              size_t decomposition_level_count);
@@ -333,6 +356,19 @@ void concrete_cpu_init_lwe_keyswitch_key_u64(uint64_t *lwe_ksk,
                                              double variance,
                                              struct EncCsprng *csprng);
 
+void concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(uint64_t *lwe_bsk,
+                                                       const uint64_t *input_lwe_sk,
+                                                       const uint64_t *output_glwe_sk,
+                                                       size_t input_lwe_dimension,
+                                                       size_t output_polynomial_size,
+                                                       size_t output_glwe_dimension,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t grouping_factor,
+                                                       double variance,
+                                                       Parallelism parallelism,
+                                                       struct EncCsprng *csprng);
+
 void concrete_cpu_init_secret_key_u64(uint64_t *sk, size_t dimension, struct SecCsprng *csprng);
 
 void concrete_cpu_init_seeded_lwe_bootstrap_key_u64(uint64_t *seeded_lwe_bsk,
@@ -397,6 +433,55 @@ void concrete_cpu_mul_cleartext_lwe_ciphertext_u64(uint64_t *ct_out,
                                                    uint64_t cleartext,
                                                    size_t lwe_dimension);
 
+void concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(const uint64_t *standard_bsk,
+                                                                 c64 *fourier_bsk,
+                                                                 size_t decomposition_level_count,
+                                                                 size_t decomposition_base_log,
+                                                                 size_t glwe_dimension,
+                                                                 size_t polynomial_size,
+                                                                 size_t input_lwe_dimension,
+                                                                 size_t grouping_factor,
+                                                                 Parallelism parallelism);
+
+size_t concrete_cpu_multi_bit_bootstrap_key_size_u64(size_t decomposition_level_count,
+                                                     size_t glwe_dimension,
+                                                     size_t polynomial_size,
+                                                     size_t input_lwe_dimension,
+                                                     size_t grouping_factor);
+
+void concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                         const uint64_t *ct_in,
+                                                         const uint64_t *accumulator,
+                                                         const c64 *fourier_bsk,
+                                                         size_t decomposition_level_count,
+                                                         size_t decomposition_base_log,
+                                                         size_t glwe_dimension,
+                                                         size_t polynomial_size,
+                                                         size_t input_lwe_dimension,
+                                                         size_t grouping_factor,
+                                                         size_t thread_count);
+
+void concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                                  const uint64_t *ct_in,
+                                                                  const uint64_t *accumulator,
+                                                                  const c64 *fourier_bsk,
+                                                                  size_t decomposition_level_count,
+                                                                  size_t decomposition_base_log,
+                                                                  size_t glwe_dimension,
+                                                                  size_t polynomial_size,
+                                                                  size_t input_lwe_dimension,
+                                                                  size_t grouping_factor,
+                                                                  size_t lut_count,
+                                                                  size_t lut_stride,
+                                                                  size_t thread_count,
+                                                                  uint8_t *stack,
+                                                                  size_t stack_size);
+
+ScratchStatus concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64_scratch(size_t *stack_size,
+                                                                                   size_t *stack_align,
+                                                                                   size_t glwe_dimension,
+                                                                                   size_t polynomial_size);
+
 void concrete_cpu_negate_lwe_ciphertext_u64(uint64_t *ct_out,
                                             const uint64_t *ct_in,
                                             size_t lwe_dimension);
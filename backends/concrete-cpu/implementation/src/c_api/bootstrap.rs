@@ -5,7 +5,7 @@ use tfhe::core_crypto::prelude::*;
 
 use crate::c_api::types::{EncCsprng, Parallelism, ScratchStatus, Uint128};
 use core::slice;
-use dyn_stack::PodStack;
+use dyn_stack::{PodStack, StackReq};
 
 use super::csprng::new_dyn_seeder;
 use super::secret_key::{
@@ -14,6 +14,8 @@ use super::secret_key::{
 };
 use super::utils::nounwind;
 
+const CACHELINE_ALIGN: usize = 128;
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_init_lwe_bootstrap_key_u64(
     // bootstrap key
@@ -413,6 +415,97 @@ pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_u64(
     })
 }
 
+/// Evaluates `lut_count` lookup tables packed in a single accumulator with one blind rotation.
+///
+/// The accumulator holds the tables interleaved with a spacing of `lut_stride` coefficients, the
+/// `i`-th output ciphertext being extracted at degree `i * lut_stride` of the rotated accumulator.
+/// `ct_out` must hold `lut_count` contiguous output ciphertexts. The scratch requirements are the
+/// ones of `concrete_cpu_bootstrap_lwe_ciphertext_u64`.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_bootstrap_many_lut_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // packing parameters
+    lut_count: usize,
+    lut_stride: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        let output_lwe_size = glwe_dimension * polynomial_size + 1;
+
+        assert!(lut_count * lut_stride <= polynomial_size);
+
+        let fourier = FourierLweBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let accumulator = slice::from_raw_parts(
+            accumulator,
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+        );
+
+        let stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+        let (local_accumulator_data, stack) =
+            stack.collect_aligned(CACHELINE_ALIGN, accumulator.iter().copied());
+        let mut local_accumulator = GlweCiphertext::from_container(
+            &mut *local_accumulator_data,
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        blind_rotate_assign_mem_optimized(
+            &lwe_in,
+            &mut local_accumulator,
+            &fourier,
+            (*fft).as_view(),
+            stack,
+        );
+
+        let outputs = slice::from_raw_parts_mut(ct_out, lut_count * output_lwe_size);
+        for (i, output) in outputs.chunks_exact_mut(output_lwe_size).enumerate() {
+            let mut lwe_out =
+                LweCiphertext::from_container(output, CiphertextModulus::new_native());
+            extract_lwe_sample_from_glwe_ciphertext(
+                &local_accumulator,
+                &mut lwe_out,
+                MonomialDegree(i * lut_stride),
+            );
+        }
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_bootstrap_key_size_u64(
     decomposition_level_count: usize,
@@ -457,3 +550,741 @@ pub unsafe extern "C" fn concrete_cpu_seeded_bootstrap_key_size_u64(
             DecompositionLevelCount(decomposition_level_count),
         )
 }
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(
+    // bootstrap key
+    lwe_bsk: *mut u64,
+    // secret keys
+    input_lwe_sk: *const u64,
+    output_glwe_sk: *const u64,
+    // secret key dimensions
+    input_lwe_dimension: usize,
+    output_polynomial_size: usize,
+    output_glwe_dimension: usize,
+    // bootstrap key parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    grouping_factor: usize,
+    // noise parameters
+    variance: f64,
+    // parallelism
+    parallelism: Parallelism,
+    // csprng
+    csprng: *mut EncCsprng,
+) {
+    nounwind(|| {
+        let mut bsk = LweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts_mut(
+                lwe_bsk,
+                concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            GlweDimension(output_glwe_dimension).to_glwe_size(),
+            PolynomialSize(output_polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+            CiphertextModulus::new_native(),
+        );
+
+        let lwe_sk = LweSecretKey::from_container(slice::from_raw_parts(
+            input_lwe_sk,
+            concrete_cpu_lwe_secret_key_size_u64(input_lwe_dimension),
+        ));
+        let glwe_sk = GlweSecretKey::from_container(
+            slice::from_raw_parts(
+                output_glwe_sk,
+                concrete_cpu_glwe_secret_key_size_u64(
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                ),
+            ),
+            PolynomialSize(output_polynomial_size),
+        );
+
+        match parallelism {
+            Parallelism::No => generate_lwe_multi_bit_bootstrap_key(
+                &lwe_sk,
+                &glwe_sk,
+                &mut bsk,
+                Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
+                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            ),
+            Parallelism::Rayon => par_generate_lwe_multi_bit_bootstrap_key(
+                &lwe_sk,
+                &glwe_sk,
+                &mut bsk,
+                Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
+                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            ),
+        }
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+    // bootstrap key
+    standard_bsk: *const u64,
+    fourier_bsk: *mut c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        let standard = LweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts(
+                standard_bsk,
+                concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+            CiphertextModulus::new_native(),
+        );
+
+        let mut fourier = FourierLweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts_mut(
+                fourier_bsk,
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+        );
+
+        match parallelism {
+            Parallelism::No => {
+                convert_standard_lwe_multi_bit_bootstrap_key_to_fourier(&standard, &mut fourier)
+            }
+            Parallelism::Rayon => {
+                par_convert_standard_lwe_multi_bit_bootstrap_key_to_fourier(&standard, &mut fourier)
+            }
+        }
+    })
+}
+
+/// Bootstraps `ct_in` with a multi-bit bootstrap key, whose `grouping_factor` secret key bits are
+/// blind rotated at once.
+///
+/// The key bundles of a group are computed ahead of the external product that consumes them on
+/// up to `thread_count` threads, so a single bootstrap can use several cores. No scratch memory
+/// is needed as the ffts are planned internally.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+    // parallelism
+    thread_count: usize,
+) {
+    nounwind(|| {
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+
+        let fourier = FourierLweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let mut lwe_out = LweCiphertext::from_container(
+            slice::from_raw_parts_mut(ct_out, output_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let accumulator = GlweCiphertext::from_container(
+            slice::from_raw_parts(
+                accumulator,
+                concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+            ),
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        multi_bit_programmable_bootstrap_lwe_ciphertext(
+            &lwe_in,
+            &mut lwe_out,
+            &accumulator,
+            &fourier,
+            ThreadCount(thread_count.max(1)),
+            true,
+        );
+    })
+}
+
+#[no_mangle]
+#[must_use]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64_scratch(
+    stack_size: *mut usize,
+    stack_align: *mut usize,
+    // bootstrap parameters
+    glwe_dimension: usize,
+    polynomial_size: usize,
+) -> ScratchStatus {
+    nounwind(|| {
+        if let Ok(scratch) = StackReq::try_new_aligned::<u64>(
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+            CACHELINE_ALIGN,
+        ) {
+            *stack_size = scratch.size_bytes();
+            *stack_align = scratch.align_bytes();
+            ScratchStatus::Valid
+        } else {
+            ScratchStatus::SizeOverflow
+        }
+    })
+}
+
+/// Multi-bit counterpart of `concrete_cpu_bootstrap_many_lut_lwe_ciphertext_u64`, see
+/// `concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64` for the multi-bit parameters. The stack
+/// only holds the rotated accumulator, its requirements are given by
+/// `concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64_scratch`.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+    // packing parameters
+    lut_count: usize,
+    lut_stride: usize,
+    // parallelism
+    thread_count: usize,
+    // side resources
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        let output_lwe_size = glwe_dimension * polynomial_size + 1;
+
+        assert!(lut_count * lut_stride <= polynomial_size);
+
+        let fourier = FourierLweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let accumulator = slice::from_raw_parts(
+            accumulator,
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+        );
+
+        let stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+        let (local_accumulator_data, _) =
+            stack.collect_aligned(CACHELINE_ALIGN, accumulator.iter().copied());
+        let mut local_accumulator = GlweCiphertext::from_container(
+            &mut *local_accumulator_data,
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        multi_bit_blind_rotate_assign(
+            &lwe_in,
+            &mut local_accumulator,
+            &fourier,
+            ThreadCount(thread_count.max(1)),
+            true,
+        );
+
+        let outputs = slice::from_raw_parts_mut(ct_out, lut_count * output_lwe_size);
+        for (i, output) in outputs.chunks_exact_mut(output_lwe_size).enumerate() {
+            let mut lwe_out =
+                LweCiphertext::from_container(output, CiphertextModulus::new_native());
+            extract_lwe_sample_from_glwe_ciphertext(
+                &local_accumulator,
+                &mut lwe_out,
+                MonomialDegree(i * lut_stride),
+            );
+        }
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_key_size_u64(
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+) -> usize {
+    input_lwe_dimension / grouping_factor
+        * LweBskGroupingFactor(grouping_factor)
+            .ggsw_per_multi_bit_element()
+            .0
+        * ggsw_ciphertext_size(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionLevelCount(decomposition_level_count),
+        )
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+) -> usize {
+    input_lwe_dimension / grouping_factor
+        * LweBskGroupingFactor(grouping_factor)
+            .ggsw_per_multi_bit_element()
+            .0
+        * fourier_ggsw_ciphertext_size(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size).to_fourier_polynomial_size(),
+            DecompositionLevelCount(decomposition_level_count),
+        )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::c_api::secret_key::{
+        concrete_cpu_decrypt_lwe_ciphertext_u64, concrete_cpu_encrypt_lwe_ciphertext_u64,
+        concrete_cpu_init_secret_key_u64,
+    };
+    use crate::c_api::types::SecCsprng;
+    use dyn_stack::GlobalPodBuffer;
+
+    const INPUT_LWE_DIMENSION: usize = 16;
+    const GLWE_DIMENSION: usize = 1;
+    const POLYNOMIAL_SIZE: usize = 1024;
+    const LEVEL_COUNT: usize = 2;
+    const BASE_LOG: usize = 15;
+    const PRECISION: usize = 2;
+
+    fn variance() -> f64 {
+        2.0_f64.powi(-80)
+    }
+
+    struct Context {
+        input_sk: Vec<u64>,
+        output_sk: Vec<u64>,
+        csprng: EncryptionRandomGenerator<SoftwareRandomGenerator>,
+    }
+
+    impl Context {
+        fn new() -> Self {
+            let mut secret_csprng = SecretRandomGenerator::<SoftwareRandomGenerator>::new(Seed(0));
+            let mut boxed_seeder = new_dyn_seeder();
+            let csprng = EncryptionRandomGenerator::new(Seed(1), boxed_seeder.as_mut());
+
+            let mut input_sk = vec![0; INPUT_LWE_DIMENSION];
+            let mut output_sk = vec![0; GLWE_DIMENSION * POLYNOMIAL_SIZE];
+            for sk in [&mut input_sk, &mut output_sk] {
+                unsafe {
+                    concrete_cpu_init_secret_key_u64(
+                        sk.as_mut_ptr(),
+                        sk.len(),
+                        &mut secret_csprng as *mut _ as *mut SecCsprng,
+                    )
+                };
+            }
+            Context {
+                input_sk,
+                output_sk,
+                csprng,
+            }
+        }
+
+        fn csprng(&mut self) -> *mut EncCsprng {
+            &mut self.csprng as *mut _ as *mut EncCsprng
+        }
+
+        fn encrypt(&mut self, message: u64) -> Vec<u64> {
+            let mut ct = vec![0; INPUT_LWE_DIMENSION + 1];
+            let csprng = self.csprng();
+            unsafe {
+                concrete_cpu_encrypt_lwe_ciphertext_u64(
+                    self.input_sk.as_ptr(),
+                    ct.as_mut_ptr(),
+                    message << (63 - PRECISION),
+                    INPUT_LWE_DIMENSION,
+                    variance(),
+                    csprng,
+                )
+            };
+            ct
+        }
+
+        fn decrypt(&self, ct: &[u64]) -> u64 {
+            let mut plaintext = 0;
+            unsafe {
+                concrete_cpu_decrypt_lwe_ciphertext_u64(
+                    self.output_sk.as_ptr(),
+                    ct.as_ptr(),
+                    self.output_sk.len(),
+                    &mut plaintext,
+                )
+            };
+            let delta = 1_u64 << (63 - PRECISION);
+            (plaintext.wrapping_add(delta / 2) / delta) % (2 << PRECISION)
+        }
+
+        fn fourier_bootstrap_key(&mut self, fft: &Fft) -> Vec<c64> {
+            let mut bsk = vec![
+                0;
+                concrete_cpu_bootstrap_key_size_u64(
+                    LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                )
+            ];
+            let mut fourier_bsk = vec![
+                c64::default();
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                )
+            ];
+            let csprng = self.csprng();
+            unsafe {
+                concrete_cpu_init_lwe_bootstrap_key_u64(
+                    bsk.as_mut_ptr(),
+                    self.input_sk.as_ptr(),
+                    self.output_sk.as_ptr(),
+                    INPUT_LWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    GLWE_DIMENSION,
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    variance(),
+                    Parallelism::Rayon,
+                    csprng,
+                );
+
+                let mut stack = scratch(|size, align| {
+                    concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(size, align, fft)
+                });
+                concrete_cpu_bootstrap_key_convert_u64_to_fourier(
+                    bsk.as_ptr(),
+                    fourier_bsk.as_mut_ptr(),
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    fft,
+                    stack.as_mut_ptr(),
+                    stack.len(),
+                );
+            }
+            fourier_bsk
+        }
+
+        fn fourier_multi_bit_bootstrap_key(&mut self, grouping_factor: usize) -> Vec<c64> {
+            let mut bsk = vec![
+                0;
+                concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                    LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                )
+            ];
+            let mut fourier_bsk = vec![
+                c64::default();
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                )
+            ];
+            let csprng = self.csprng();
+            unsafe {
+                concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(
+                    bsk.as_mut_ptr(),
+                    self.input_sk.as_ptr(),
+                    self.output_sk.as_ptr(),
+                    INPUT_LWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    GLWE_DIMENSION,
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    grouping_factor,
+                    variance(),
+                    Parallelism::Rayon,
+                    csprng,
+                );
+                concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+                    bsk.as_ptr(),
+                    fourier_bsk.as_mut_ptr(),
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                    Parallelism::Rayon,
+                );
+            }
+            fourier_bsk
+        }
+    }
+
+    fn scratch(
+        requirement: impl FnOnce(*mut usize, *mut usize) -> ScratchStatus,
+    ) -> GlobalPodBuffer {
+        let mut size = 0;
+        let mut align = 0;
+        assert!(matches!(
+            requirement(&mut size, &mut align),
+            ScratchStatus::Valid
+        ));
+        GlobalPodBuffer::new(StackReq::new_aligned::<u8>(size, align))
+    }
+
+    /// Trivial glwe encryption of `table`, each entry filling a box of coefficients. The boxes are
+    /// shifted by half their size so that the noise of the input is rounded off.
+    fn accumulator(table: &[u64]) -> Vec<u64> {
+        let box_size = POLYNOMIAL_SIZE / table.len();
+        let mut glwe = vec![0; (GLWE_DIMENSION + 1) * POLYNOMIAL_SIZE];
+        let body = &mut glwe[GLWE_DIMENSION * POLYNOMIAL_SIZE..];
+        for (i, coefficient) in body.iter_mut().enumerate() {
+            let j = i + box_size / 2;
+            *coefficient = if j < POLYNOMIAL_SIZE {
+                table[j / box_size] << (63 - PRECISION)
+            } else {
+                (table[(j - POLYNOMIAL_SIZE) / box_size] << (63 - PRECISION)).wrapping_neg()
+            };
+        }
+        glwe
+    }
+
+    /// The lookup tables evaluated at once by the many lut tests and their packed accumulator,
+    /// `lut_count` being a power of two.
+    fn many_luts(lut_count: usize) -> (Vec<Vec<u64>>, Vec<u64>) {
+        let message_count = 1 << PRECISION;
+        let luts: Vec<Vec<u64>> = (0..lut_count as u64)
+            .map(|j| {
+                (0..message_count)
+                    .map(|x| (x * (j + 1) + j) % message_count)
+                    .collect()
+            })
+            .collect();
+        let packed: Vec<u64> = (0..message_count as usize * lut_count)
+            .map(|i| luts[i % lut_count][i / lut_count])
+            .collect();
+        (luts, accumulator(&packed))
+    }
+
+    #[test]
+    fn test_bootstrap_many_lut() {
+        let mut context = Context::new();
+        let fft = Fft::new(PolynomialSize(POLYNOMIAL_SIZE));
+        let fourier_bsk = context.fourier_bootstrap_key(&fft);
+
+        let lut_count = 2;
+        let lut_stride = POLYNOMIAL_SIZE / ((1 << PRECISION) * lut_count);
+        let (luts, accumulator) = many_luts(lut_count);
+        let output_lwe_size = GLWE_DIMENSION * POLYNOMIAL_SIZE + 1;
+
+        for x in 0..1 << PRECISION {
+            let ct_in = context.encrypt(x);
+            let mut ct_out = vec![0; lut_count * output_lwe_size];
+            unsafe {
+                let mut stack = scratch(|size, align| {
+                    concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+                        size,
+                        align,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                        &fft,
+                    )
+                });
+                concrete_cpu_bootstrap_many_lut_lwe_ciphertext_u64(
+                    ct_out.as_mut_ptr(),
+                    ct_in.as_ptr(),
+                    accumulator.as_ptr(),
+                    fourier_bsk.as_ptr(),
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    lut_count,
+                    lut_stride,
+                    &fft,
+                    stack.as_mut_ptr(),
+                    stack.len(),
+                );
+            }
+            for (j, output) in ct_out.chunks_exact(output_lwe_size).enumerate() {
+                assert_eq!(context.decrypt(output), luts[j][x as usize]);
+            }
+        }
+    }
+
+    #[test]
+    fn test_multi_bit_bootstrap() {
+        let mut context = Context::new();
+        let grouping_factor = 2;
+        let fourier_bsk = context.fourier_multi_bit_bootstrap_key(grouping_factor);
+
+        let lut: Vec<u64> = (0..1 << PRECISION)
+            .map(|x| (3 * x + 1) % (1 << PRECISION))
+            .collect();
+        let accumulator = accumulator(&lut);
+        let mut ct_out = vec![0; GLWE_DIMENSION * POLYNOMIAL_SIZE + 1];
+
+        for x in 0..1 << PRECISION {
+            let ct_in = context.encrypt(x);
+            unsafe {
+                concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+                    ct_out.as_mut_ptr(),
+                    ct_in.as_ptr(),
+                    accumulator.as_ptr(),
+                    fourier_bsk.as_ptr(),
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                    2,
+                );
+            }
+            assert_eq!(context.decrypt(&ct_out), lut[x as usize]);
+        }
+    }
+
+    #[test]
+    fn test_multi_bit_bootstrap_many_lut() {
+        let mut context = Context::new();
+        let grouping_factor = 2;
+        let fourier_bsk = context.fourier_multi_bit_bootstrap_key(grouping_factor);
+
+        let lut_count = 2;
+        let lut_stride = POLYNOMIAL_SIZE / ((1 << PRECISION) * lut_count);
+        let (luts, accumulator) = many_luts(lut_count);
+        let output_lwe_size = GLWE_DIMENSION * POLYNOMIAL_SIZE + 1;
+
+        for x in 0..1 << PRECISION {
+            let ct_in = context.encrypt(x);
+            let mut ct_out = vec![0; lut_count * output_lwe_size];
+            unsafe {
+                let mut stack = scratch(|size, align| {
+                    concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64_scratch(
+                        size,
+                        align,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                    )
+                });
+                concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64(
+                    ct_out.as_mut_ptr(),
+                    ct_in.as_ptr(),
+                    accumulator.as_ptr(),
+                    fourier_bsk.as_ptr(),
+                    LEVEL_COUNT,
+                    BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                    lut_count,
+                    lut_stride,
+                    2,
+                    stack.as_mut_ptr(),
+                    stack.len(),
+                );
+            }
+            for (j, output) in ct_out.chunks_exact(output_lwe_size).enumerate() {
+                assert_eq!(context.decrypt(output), luts[j][x as usize]);
+            }
+        }
+    }
+}
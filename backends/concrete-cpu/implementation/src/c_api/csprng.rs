@@ -1,11 +1,12 @@
 use std::io::Read;
 
 use super::types::{Csprng, EncCsprng, SecCsprng, Uint128};
+use super::utils::nounwind;
 use concrete_csprng::generators::SoftwareRandomGenerator;
 use concrete_csprng::seeders::Seed;
 use libc::c_int;
 use tfhe::core_crypto::commons::math::random::RandomGenerator;
-use tfhe::core_crypto::prelude::{EncryptionRandomGenerator, SecretRandomGenerator};
+use tfhe::core_crypto::prelude::*;
 use tfhe::core_crypto::seeders::Seeder;
 
 pub struct DynamicSeeder;
@@ -93,6 +94,38 @@ pub unsafe extern "C" fn concrete_cpu_destroy_encryption_csprng(mem: *mut EncCsp
     core::ptr::drop_in_place(mem as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>);
 }
 
+/// Constructs in `child` an encryption generator whose mask stream is seeded by the next 128 bits
+/// of the mask stream of `parent`, so that generators forked in the same order from a same seed
+/// produce the same masks. The noise stream of the child is seeded independently, as the one of
+/// any encryption generator.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_fork_encryption_csprng(
+    parent: *mut EncCsprng,
+    child: *mut EncCsprng,
+) {
+    nounwind(|| {
+        let parent = &mut *(parent as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>);
+        // tfhe only draws from the mask stream when encrypting, so the next bytes of the stream are
+        // read as the mask of an encryption under an all-zero key, whose body is left unused.
+        let key = LweSecretKey::new_empty_key(0u64, LweDimension(2));
+        let mut ct = LweCiphertext::new(0u64, LweSize(3), CiphertextModulus::new_native());
+        encrypt_lwe_ciphertext(
+            &key,
+            &mut ct,
+            Plaintext(0),
+            Gaussian::from_dispersion_parameter(Variance::from_variance(0.0), 0.0),
+            parent,
+        );
+        let mask = ct.get_mask();
+        let mut seed = Uint128 {
+            little_endian_bytes: [0; 16],
+        };
+        seed.little_endian_bytes[0..8].copy_from_slice(&mask.as_ref()[0].to_le_bytes());
+        seed.little_endian_bytes[8..16].copy_from_slice(&mask.as_ref()[1].to_le_bytes());
+        concrete_cpu_construct_encryption_csprng(child, seed);
+    });
+}
+
 // Randomly fill a uint128.
 // Returns 1 if the random is crypto secure, -1 if it not secure, 0 if fail.
 #[no_mangle]
@@ -0,0 +1,17 @@
+# Writes to OUTPUT a header defining CONCRETELANG_BUILD_ID as a hash of the
+# files listed, one per line, in SOURCES_FILE. The hash covers the paths of the
+# files relative to ROOT and their contents, so it is the same for every build
+# of the same sources, wherever they are checked out.
+file(STRINGS ${SOURCES_FILE} sources)
+list(SORT sources)
+set(digests "")
+foreach(source ${sources})
+  file(SHA256 ${source} digest)
+  file(RELATIVE_PATH path ${ROOT} ${source})
+  string(APPEND digests "${path} ${digest}\n")
+endforeach()
+string(SHA256 id "${digests}")
+
+file(WRITE ${OUTPUT}
+  "// Generated by GenerateBuildId.cmake, do not edit.\n"
+  "#define CONCRETELANG_BUILD_ID \"${id}\"\n")
@@ -57,11 +57,12 @@ public:
 
   Result<TransportValue> prepareInput(Value arg, size_t pos);
 
-  Result<Value> processOutput(TransportValue result, size_t pos);
+  Result<Value> processOutput(const TransportValue &result, size_t pos);
 
   Result<TransportValue> simulatePrepareInput(Value arg, size_t pos);
 
-  Result<Value> simulateProcessOutput(TransportValue result, size_t pos);
+  Result<Value> simulateProcessOutput(const TransportValue &result,
+                                      size_t pos);
 
   std::string getName();
 
@@ -9,6 +9,7 @@
 #include "concrete-cpu.h"
 #include <cassert>
 #include <memory>
+#include <mutex>
 
 namespace concretelang {
 namespace csprng {
@@ -55,6 +56,24 @@ public:
   EncryptionCSPRNG(EncryptionCSPRNG &) = delete;
   EncryptionCSPRNG(EncryptionCSPRNG &&other);
   ~EncryptionCSPRNG();
+
+  /// Returns a new generator whose mask stream is seeded from the mask stream
+  /// of this one. Generators forked in the same order from the same seed
+  /// produce the same masks, whatever the thread they are used on.
+  EncryptionCSPRNG fork();
+
+  /// Locks the generator. A generator shared between threads must only be
+  /// used, or forked, while holding the lock, as concurrent uses could hand
+  /// out the same masks twice.
+  std::unique_lock<std::mutex> lock() {
+    return std::unique_lock<std::mutex>(guard);
+  }
+
+private:
+  struct ForkTag {};
+  EncryptionCSPRNG(EncryptionCSPRNG &parent, ForkTag);
+
+  std::mutex guard;
 };
 
 void writeSeed(struct Uint128 seed, uint64_t *buffer);
@@ -9,11 +9,14 @@
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Protocol.h"
+#include <complex>
 #include <memory>
 #include <mutex>
 #include <stdlib.h>
 #include <vector>
 
+struct Fft;
+
 using concretelang::csprng::CSPRNG;
 using concretelang::protocol::Message;
 
@@ -84,6 +87,7 @@ public:
   /// @param inputKey The input secret key of the bootstraping key.
   /// @param outputKey The output secret key of the bootstraping key.
   /// @param csprng An encryption csprng that used to encrypt the secret keys.
+  /// @throws std::invalid_argument if a seeded multi-bit key is requested.
   LweBootstrapKey(Message<concreteprotocol::LweBootstrapKeyInfo> info,
                   const LweSecretKey &inputKey, const LweSecretKey &outputKey,
                   concretelang::csprng::EncryptionCSPRNG &csprng);
@@ -101,15 +105,35 @@ public:
   static LweBootstrapKey
   fromProto(concreteprotocol::LweBootstrapKey::Reader reader);
 
+  /// @brief Initialize the key from a reader without copying the payload when
+  /// the key is not compressed and stored in a single blob.
+  /// @param owner Keeps the memory the reader points to alive.
+  static LweBootstrapKey
+  fromProto(concreteprotocol::LweBootstrapKey::Reader reader,
+            std::shared_ptr<const void> owner);
+
   /// @brief Returns the serialized form of the key.
   Message<concreteprotocol::LweBootstrapKey> toProto() const;
 
   const Message<concreteprotocol::LweBootstrapKeyInfo> &getInfo() const;
 
+  /// @brief Returns the decompressed key. A key pointing into external memory
+  /// gets copied, use `getRawPtr` and `getSize` to avoid it.
   const std::vector<uint64_t> &getBuffer();
 
+  /// @brief Returns the key as transported. A key pointing into external
+  /// memory gets copied, use `getTransportRawPtr` and `getTransportSize` to
+  /// avoid it.
   const std::vector<uint64_t> &getTransportBuffer() const;
 
+  const uint64_t *getRawPtr();
+
+  size_t getSize();
+
+  const uint64_t *getTransportRawPtr() const;
+
+  size_t getTransportSize() const;
+
   void decompress();
 
 private:
@@ -134,6 +158,79 @@ private:
 
   /// @brief A boolean that indicates if the decompression is done or not
   std::shared_ptr<bool> decompressed;
+
+  /// @brief The uncompressed key when it points into memory owned by another
+  /// object, e.g. a mapped key file, in which case `buffer` is only filled on
+  /// demand.
+  std::shared_ptr<const uint64_t> externalBuffer;
+
+  /// @brief The number of elements of the external buffer.
+  size_t externalSize = 0;
+
+  /// @brief Copies the external buffer in `buffer` if needed.
+  void materialize() const;
+};
+
+/// A bootstrap key converted to the fourier domain of the cpu backend.
+///
+/// The fourier buffer is shared between the copies of the key, and may point
+/// into memory owned by another object, e.g. a mapped key file.
+class FourierLweBootstrapKey {
+public:
+  /// @brief The version of the fourier layout produced by the cpu backend. It
+  /// must be bumped whenever concrete-cpu changes this layout, so that stored
+  /// keys get converted again.
+  static constexpr uint32_t LAYOUT_VERSION = 1;
+
+  /// @brief Converts a standard bootstrap key to the fourier domain.
+  /// @param standardKey The bootstrap key to convert.
+  /// @param fft The fft plan to use, built for the polynomial size of the
+  /// key. A temporary plan is built if null.
+  FourierLweBootstrapKey(LweBootstrapKey &standardKey, const struct Fft *fft);
+  FourierLweBootstrapKey(std::shared_ptr<const std::complex<double>> buffer,
+                         size_t size,
+                         Message<concreteprotocol::LweBootstrapKeyInfo> info,
+                         uint32_t fftPolynomialSize, uint32_t fftLayoutVersion)
+      : buffer(buffer), size(size), info(info),
+        fftPolynomialSize(fftPolynomialSize),
+        fftLayoutVersion(fftLayoutVersion){};
+
+  /// @brief Initialize the key from the protocol message.
+  static FourierLweBootstrapKey
+  fromProto(const Message<concreteprotocol::FourierLweBootstrapKey> &proto);
+
+  /// @brief Initialize the key from a reader.
+  static FourierLweBootstrapKey
+  fromProto(concreteprotocol::FourierLweBootstrapKey::Reader reader);
+
+  /// @brief Initialize the key from a reader without copying the payload when
+  /// it is stored in a single blob.
+  /// @param owner Keeps the memory the reader points to alive.
+  static FourierLweBootstrapKey
+  fromProto(concreteprotocol::FourierLweBootstrapKey::Reader reader,
+            std::shared_ptr<const void> owner);
+
+  /// @brief Returns the serialized form of the key.
+  Message<concreteprotocol::FourierLweBootstrapKey> toProto() const;
+
+  /// @brief Returns the info of the standard key it was converted from.
+  const Message<concreteprotocol::LweBootstrapKeyInfo> &getInfo() const;
+
+  /// @brief Returns true if the key is the conversion of a standard key with
+  /// `info`, using the fft parameters and layout of the cpu backend.
+  bool isUsableFor(
+      const Message<concreteprotocol::LweBootstrapKeyInfo> &info) const;
+
+  const std::complex<double> *getRawPtr() const;
+
+  size_t getSize() const;
+
+private:
+  std::shared_ptr<const std::complex<double>> buffer;
+  size_t size;
+  Message<concreteprotocol::LweBootstrapKeyInfo> info;
+  uint32_t fftPolynomialSize;
+  uint32_t fftLayoutVersion;
 };
 
 class LweKeyswitchKey {
@@ -157,15 +254,35 @@ public:
   static LweKeyswitchKey
   fromProto(concreteprotocol::LweKeyswitchKey::Reader reader);
 
+  /// @brief Initialize the key from a reader without copying the payload when
+  /// the key is not compressed and stored in a single blob.
+  /// @param owner Keeps the memory the reader points to alive.
+  static LweKeyswitchKey
+  fromProto(concreteprotocol::LweKeyswitchKey::Reader reader,
+            std::shared_ptr<const void> owner);
+
   /// @brief Returns the serialized form of the key.
   Message<concreteprotocol::LweKeyswitchKey> toProto() const;
 
   const Message<concreteprotocol::LweKeyswitchKeyInfo> &getInfo() const;
 
+  /// @brief Returns the decompressed key. A key pointing into external memory
+  /// gets copied, use `getRawPtr` and `getSize` to avoid it.
   const std::vector<uint64_t> &getBuffer();
 
+  /// @brief Returns the key as transported. A key pointing into external
+  /// memory gets copied, use `getTransportRawPtr` and `getTransportSize` to
+  /// avoid it.
   const std::vector<uint64_t> &getTransportBuffer() const;
 
+  const uint64_t *getRawPtr();
+
+  size_t getSize();
+
+  const uint64_t *getTransportRawPtr() const;
+
+  size_t getTransportSize() const;
+
   void decompress();
 
 private:
@@ -189,6 +306,17 @@ private:
 
   /// @brief A boolean that indicates if the decompression is done or not
   std::shared_ptr<bool> decompressed;
+
+  /// @brief The uncompressed key when it points into memory owned by another
+  /// object, e.g. a mapped key file, in which case `buffer` is only filled on
+  /// demand.
+  std::shared_ptr<const uint64_t> externalBuffer;
+
+  /// @brief The number of elements of the external buffer.
+  size_t externalSize = 0;
+
+  /// @brief Copies the external buffer in `buffer` if needed.
+  void materialize() const;
 };
 
 class PackingKeyswitchKey {
@@ -226,6 +354,10 @@ public:
     return getBuffer();
   };
 
+  const uint64_t *getTransportRawPtr() const { return getRawPtr(); };
+
+  size_t getTransportSize() const { return getSize(); };
+
 private:
   std::shared_ptr<std::vector<uint64_t>> buffer;
   Message<concreteprotocol::PackingKeyswitchKeyInfo> info;
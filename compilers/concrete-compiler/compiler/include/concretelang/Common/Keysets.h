@@ -19,6 +19,7 @@
 
 using concretelang::error::Result;
 using concretelang::error::StringError;
+using concretelang::keys::FourierLweBootstrapKey;
 using concretelang::keys::LweBootstrapKey;
 using concretelang::keys::LweKeyswitchKey;
 using concretelang::keys::LweSecretKey;
@@ -42,12 +43,24 @@ struct ServerKeyset {
   std::vector<LweBootstrapKey> lweBootstrapKeys;
   std::vector<LweKeyswitchKey> lweKeyswitchKeys;
   std::vector<PackingKeyswitchKey> packingKeyswitchKeys;
+  /// Optional fourier forms of the bootstrap keys. The runtime uses them
+  /// instead of converting the matching standard keys.
+  std::vector<FourierLweBootstrapKey> fourierLweBootstrapKeys;
 
   static ServerKeyset
   fromProto(const Message<concreteprotocol::ServerKeyset> &proto);
   static ServerKeyset fromProto(concreteprotocol::ServerKeyset::Reader reader);
 
   Message<concreteprotocol::ServerKeyset> toProto() const;
+
+  /// @brief Returns the usable fourier form of the bootstrap key `index`, if
+  /// any.
+  const FourierLweBootstrapKey *getFourierBootstrapKey(size_t index) const;
+
+  /// @brief Converts to the fourier domain the bootstrap keys which do not
+  /// have a usable fourier form yet, so that they get serialized with the
+  /// keyset.
+  void precomputeFourierBootstrapKeys();
 };
 
 struct Keyset {
@@ -0,0 +1,35 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_COMMON_LUT_H_
+#define CONCRETELANG_COMMON_LUT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace concretelang {
+namespace lut {
+
+/// Encode and expand a lookup table so that it can be used as the body of the
+/// accumulator of a bootstrap.
+///
+/// Each value of `input` is encoded on the `outputBits` bits of message
+/// following the padding bit, and duplicated to fill a mega case of
+/// `outputSize / inputSize` values. The first mega case is centered over zero,
+/// half of it being negated at the end of `output`. When the bootstrap is
+/// executed on signed integers, `input` is half rotated.
+///
+/// \param input The lookup table of the function, of `inputSize` values
+/// \param output The expanded lookup table, of `outputSize` values
+/// \param outputBits The number of bits of message of the result
+/// \param isSigned Whether the input of the bootstrap is signed
+void encodeExpandForBootstrap(const uint64_t *input, size_t inputSize,
+                              uint64_t *output, size_t outputSize,
+                              uint32_t outputBits, bool isSigned);
+
+} // namespace lut
+} // namespace concretelang
+
+#endif
@@ -0,0 +1,37 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_COMMON_PARALLEL_H_
+#define CONCRETELANG_COMMON_PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace concretelang {
+namespace parallel {
+
+/// Returns the number of threads to use for a parallel section.
+///
+/// \param envVar The environment variable that overrides the default.
+/// \returns The value of `envVar` if set to a positive integer, the hardware
+/// concurrency otherwise.
+size_t getNumThreads(const char *envVar);
+
+/// Calls `body(i)` for every `i` in `[0, size)` on up to `numThreads`
+/// threads, the calling one included. The indices are picked in increasing
+/// order, so long tasks should come first. If `body` throws, the remaining
+/// indices are skipped and the first exception is rethrown on the calling
+/// thread once all the threads are done.
+///
+/// \param size The number of iterations.
+/// \param numThreads The maximum number of threads to use.
+/// \param body The body of the loop, which must be safe to call concurrently.
+void parallelFor(size_t size, size_t numThreads,
+                 const std::function<void(size_t)> &body);
+
+} // namespace parallel
+} // namespace concretelang
+
+#endif
@@ -21,6 +21,7 @@
 #include "kj/string.h"
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <optional>
@@ -270,19 +271,19 @@ template struct Message<concreteprotocol::ProgramEncodingInfo>;
 template struct Message<concreteprotocol::Value>;
 template struct Message<concreteprotocol::GateInfo>;
 
-/// Helper function turning a vector of integers to a payload.
+/// Helper function writing an array of integers in a payload builder, e.g. the
+/// payload of a message under construction, without intermediate copy.
 template <typename T>
-Message<concreteprotocol::Payload>
-vectorToProtoPayload(const std::vector<T> &input) {
-  auto output = Message<concreteprotocol::Payload>();
+void writeArrayToProtoPayload(const T *input, size_t size,
+                              concreteprotocol::Payload::Builder builder) {
   auto elmsPerBlob = capnp::MAX_TEXT_SIZE / sizeof(T);
-  auto remainingElms = input.size() % elmsPerBlob;
-  auto nbCompleteBlobs = (input.size() / elmsPerBlob);
-  auto nbBlobs = (input.size() / elmsPerBlob) + (remainingElms > 0);
-  auto dataBuilder = output.asBuilder().initData(nbBlobs);
+  auto remainingElms = size % elmsPerBlob;
+  auto nbCompleteBlobs = (size / elmsPerBlob);
+  auto nbBlobs = (size / elmsPerBlob) + (remainingElms > 0);
+  auto dataBuilder = builder.initData(nbBlobs);
   // Process all but the last blob, which store as much as `Data` allow.
   for (size_t blobIndex = 0; blobIndex < nbCompleteBlobs; blobIndex++) {
-    auto blobPtr = input.data() + blobIndex * elmsPerBlob;
+    auto blobPtr = input + blobIndex * elmsPerBlob;
     auto blobLen = elmsPerBlob * sizeof(T);
     dataBuilder.set(
         blobIndex,
@@ -293,17 +294,31 @@ vectorToProtoPayload(const std::vector<T> &input) {
   if (remainingElms > 0) {
     assert(nbCompleteBlobs == nbBlobs - 1);
     auto lastBlobIndex = nbBlobs - 1;
-    auto lastBlobPtr = input.data() + lastBlobIndex * elmsPerBlob;
+    auto lastBlobPtr = input + lastBlobIndex * elmsPerBlob;
     auto lastBlobLen = remainingElms * sizeof(T);
     dataBuilder.set(
         lastBlobIndex,
         capnp::Data::Reader(
             reinterpret_cast<const unsigned char *>(lastBlobPtr), lastBlobLen));
   }
+}
 
+/// Helper function turning an array of integers to a payload.
+template <typename T>
+Message<concreteprotocol::Payload> arrayToProtoPayload(const T *input,
+                                                       size_t size) {
+  auto output = Message<concreteprotocol::Payload>();
+  writeArrayToProtoPayload(input, size, output.asBuilder());
   return output;
 }
 
+/// Helper function turning a vector of integers to a payload.
+template <typename T>
+Message<concreteprotocol::Payload>
+vectorToProtoPayload(const std::vector<T> &input) {
+  return arrayToProtoPayload(input.data(), input.size());
+}
+
 /// Helper function turning a payload to a vector of integers.
 template <typename T>
 std::vector<T>
@@ -331,6 +346,37 @@ std::vector<T> protoPayloadToVector(concreteprotocol::Payload::Reader reader) {
   return output;
 }
 
+/// Helper function viewing a payload as an array of integers, without copy.
+///
+/// Payloads are split in blobs of at most `capnp::MAX_TEXT_SIZE` bytes, which
+/// can be viewed as a single array when each blob starts where the previous
+/// one ends. This is the case for messages built by `arrayToProtoPayload` and
+/// stored in a single segment, i.e. of up to `MAX_SEGMENT_SIZE` words. Returns
+/// null if the blobs are not contiguous or not aligned for `T`, in which case
+/// the payload must be copied with `protoPayloadToVector`. The array lives as
+/// long as the message the payload belongs to.
+template <typename T>
+const T *protoPayloadView(concreteprotocol::Payload::Reader reader,
+                          size_t &size) {
+  auto payloadData = reader.getData();
+  if (payloadData.size() == 0)
+    return nullptr;
+  auto begin = payloadData[0].begin();
+  auto end = payloadData[0].end();
+  for (size_t blobIndex = 1; blobIndex < payloadData.size(); blobIndex++) {
+    auto blobData = payloadData[blobIndex];
+    if (blobData.begin() != end)
+      return nullptr;
+    end = blobData.end();
+  }
+  // Cap'n Proto aligns blobs on words, which is enough for the element types.
+  size_t bytes = end - begin;
+  if ((uintptr_t)begin % alignof(T) != 0 || bytes % sizeof(T) != 0)
+    return nullptr;
+  size = bytes / sizeof(T);
+  return reinterpret_cast<const T *>(begin);
+}
+
 /// Helper function turning a payload to a shared vector of integers on the
 /// heap.
 template <typename T>
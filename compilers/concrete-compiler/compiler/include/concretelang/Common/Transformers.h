@@ -29,12 +29,12 @@ typedef std::function<Result<TransportValue>(Value)> InputTransformer;
 /// A type for output transformers, that is, functions running on the client
 /// side, that process a TransportValue fetched from the server to be used as a
 /// Value.
-typedef std::function<Result<Value>(TransportValue)> OutputTransformer;
+typedef std::function<Result<Value>(const TransportValue &)> OutputTransformer;
 
 /// A type for arguments transformers, that is, functions running on the server
 /// side, that transform a TransportValue fetched from the client, to be used as
 /// argument in a circuit call.
-typedef std::function<Result<Value>(TransportValue)> ArgTransformer;
+typedef std::function<Result<Value>(const TransportValue &)> ArgTransformer;
 
 /// A type for return transformers, that is, functions running on the server
 /// side, that transform a value returned from circuit call into a
@@ -69,13 +69,14 @@ public:
   getPlaintextReturnTransformer(Message<concreteprotocol::GateInfo> gateInfo);
 
   static Result<InputTransformer> getLweCiphertextInputTransformer(
-      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+      const ClientKeyset &keyset,
+      Message<concreteprotocol::GateInfo> gateInfo,
       std::shared_ptr<concretelang::csprng::EncryptionCSPRNG> csprng,
       bool useSimulation);
 
   static Result<OutputTransformer> getLweCiphertextOutputTransformer(
-      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
-      bool useSimulation);
+      const ClientKeyset &keyset,
+      Message<concreteprotocol::GateInfo> gateInfo, bool useSimulation);
 
   static Result<ArgTransformer>
   getLweCiphertextArgTransformer(Message<concreteprotocol::GateInfo> gateInfo,
@@ -14,6 +14,7 @@
 #include <initializer_list>
 #include <optional>
 #include <stdlib.h>
+#include <type_traits>
 #include <variant>
 
 using concretelang::error::Result;
@@ -21,6 +22,7 @@ using concretelang::error::StringError;
 using concretelang::protocol::dimensionsToProtoShape;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToVector;
+using concretelang::protocol::protoPayloadView;
 using concretelang::protocol::protoShapeToDimensions;
 using concretelang::protocol::vectorToProtoPayload;
 
@@ -139,6 +141,14 @@ template <typename T> struct Tensor {
   bool isScalar() const { return dimensions.empty(); }
 };
 
+/// A read-only view of tensor data owned by another object, e.g. the payload
+/// of a transport value.
+template <typename T> struct TensorView {
+  const T *values;
+  size_t length;
+  std::vector<size_t> dimensions;
+};
+
 /// A type for tensor data of varying precisions. Mainly use to manipulate
 struct Value {
   friend class ClientCircuit;
@@ -159,7 +169,35 @@ struct Value {
 
   /// Turns a server value to a client value, without interpreting the kind of
   /// value.
-  static Value fromRawTransportValue(TransportValue transportVal);
+  static Value fromRawTransportValue(const TransportValue &transportVal);
+
+  /// Views the data of a server value of element type `T` without copying it.
+  /// Returns nothing if the element type differs or if the payload can not be
+  /// viewed in place. The view is valid as long as `transportVal` is.
+  template <typename T>
+  static std::optional<TensorView<T>>
+  viewRawTransportValue(const TransportValue &transportVal) {
+    auto rawInfo = transportVal.asReader().getRawInfo();
+    if (rawInfo.getIntegerPrecision() != sizeof(T) * 8 ||
+        rawInfo.getIsSigned() != std::is_signed<T>()) {
+      return std::nullopt;
+    }
+    size_t length;
+    auto values =
+        protoPayloadView<T>(transportVal.asReader().getPayload(), length);
+    if (values == nullptr) {
+      return std::nullopt;
+    }
+    auto dimensions = protoShapeToDimensions(rawInfo.getShape());
+    size_t expectedLength = 1;
+    for (auto d : dimensions) {
+      expectedLength *= d;
+    }
+    if (length != expectedLength) {
+      return std::nullopt;
+    }
+    return TensorView<T>{values, length, dimensions};
+  }
 
   /// Turns a client value to a raw (without kind info attached) server value.
   TransportValue intoRawTransportValue() const;
@@ -172,6 +210,10 @@ struct Value {
 
   Message<concreteprotocol::Payload> intoProtoPayload() const;
 
+  /// Writes the data of the value in a payload builder, e.g. the one of a
+  /// transport value under construction.
+  void writeProtoPayload(concreteprotocol::Payload::Builder builder) const;
+
   Message<concreteprotocol::Shape> intoProtoShape() const;
 
   std::vector<size_t> getDimensions() const;
@@ -10,9 +10,10 @@
 
 namespace mlir {
 namespace concretelang {
-/// Create a pass to convert `Concrete` dialect to CAPI calls.
+/// Create a pass to convert `Concrete` dialect to CAPI calls. If `async` is
+/// set, CPU keyswitches and bootstraps are lowered to their asynchronous CAPI.
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertConcreteToCAPIPass(bool gpu);
+createConvertConcreteToCAPIPass(bool gpu, bool async);
 } // namespace concretelang
 } // namespace mlir
 
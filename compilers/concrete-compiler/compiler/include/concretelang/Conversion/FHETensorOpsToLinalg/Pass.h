@@ -12,9 +12,10 @@
 namespace mlir {
 namespace concretelang {
 /// Create a pass to convert `FHE` tensor operators to linal.generic
-/// operators.
+/// operators. If `gemm` is set, the encrypted by clear matrix products are
+/// kept and the convolutions are rewritten to such matrix products.
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg();
+createConvertFHETensorOpsToLinalg(bool gemm = false);
 } // namespace concretelang
 } // namespace mlir
 
@@ -18,7 +18,9 @@ class RewritePatternSet;
 
 namespace concretelang {
 std::unique_ptr<mlir::Pass>
-createBuildDataflowTaskGraphPass(bool debug = false);
+createBuildDataflowTaskGraphPass(uint64_t targetTaskDuration = 0);
+std::unique_ptr<mlir::Pass>
+createMarkDataflowTaskSplitsPass(uint64_t targetTaskDuration = 0);
 std::unique_ptr<mlir::Pass> createLowerDataflowTasksPass(bool debug = false);
 std::unique_ptr<mlir::Pass>
 createBufferizeDataflowTaskOpsPass(bool debug = false);
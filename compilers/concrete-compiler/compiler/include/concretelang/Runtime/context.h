@@ -11,7 +11,9 @@
 #include "concretelang/Common/Keysets.h"
 #include <assert.h>
 #include <complex>
+#include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <pthread.h>
 #include <vector>
@@ -39,6 +41,61 @@ typedef struct FFT {
   size_t polynomial_size;
 } FFT;
 
+/// A scratch memory arena, used by a single thread.
+///
+/// The arena hands out buffers from a fixed set of slots. The buffer of a slot
+/// grows to the largest size requested for it and is then reused, so that the
+/// runtime wrappers do not allocate memory in their hot loops. A buffer stays
+/// valid until the next request for the same slot.
+class ScratchArena {
+public:
+  enum Slot {
+    GLWE_ACCUMULATOR,
+    FFT_SCRATCH,
+    INPUT_CIPHERTEXTS,
+    OUTPUT_CIPHERTEXTS,
+    BIT_COUNTS,
+    NUM_SLOTS
+  };
+
+  ScratchArena() = default;
+  ScratchArena(const ScratchArena &other) = delete;
+  ~ScratchArena();
+
+  /// Returns the buffer of `slot`, of at least `size` bytes and aligned on
+  /// `align` bytes.
+  uint8_t *get(Slot slot, size_t size, size_t align);
+
+  /// Returns the buffer of `slot`, holding at least `count` elements of `T`.
+  template <typename T> T *get(Slot slot, size_t count) {
+    return reinterpret_cast<T *>(get(slot, count * sizeof(T), alignof(T)));
+  }
+
+  /// Returns the trivial glwe encryption of `lut`, used as the accumulator of a
+  /// bootstrap, in the buffer of the `GLWE_ACCUMULATOR` slot.
+  ///
+  /// The mask of the accumulator is only zeroed when its buffer or its
+  /// dimensions change, so that rebuilding the accumulator of a bootstrap
+  /// only copies `lut` into its body. The `GLWE_ACCUMULATOR` slot must only
+  /// be used through this method.
+  const uint64_t *glwe_accumulator(const uint64_t *lut, size_t glwe_dimension,
+                                   size_t polynomial_size);
+
+  /// Returns the number of bytes held by the arena.
+  size_t memoryFootprint() const;
+
+private:
+  struct Buffer {
+    uint8_t *ptr = nullptr;
+    size_t size = 0;
+    size_t align = 0;
+  };
+  Buffer buffers[NUM_SLOTS];
+  /// Buffer and size of the zeroed mask of the last glwe accumulator.
+  const uint64_t *accumulator_ptr = nullptr;
+  size_t accumulator_mask_size = 0;
+};
+
 typedef struct RuntimeContext {
 
   RuntimeContext() = delete;
@@ -57,12 +114,12 @@ typedef struct RuntimeContext {
   };
 
   virtual const uint64_t *keyswitch_key_buffer(size_t keyId) {
-    return serverKeyset.lweKeyswitchKeys[keyId].getBuffer().data();
+    return serverKeyset.lweKeyswitchKeys[keyId].getRawPtr();
   }
 
   virtual const std::complex<double> *
   fourier_bootstrap_key_buffer(size_t keyId) {
-    return fourier_bootstrap_keys[keyId]->data();
+    return fourier_bootstrap_keys[keyId].getRawPtr();
   }
 
   virtual const uint64_t *fp_keyswitch_key_buffer(size_t keyId) {
@@ -71,14 +128,31 @@ typedef struct RuntimeContext {
 
   virtual const struct Fft *fft(size_t keyId) { return ffts[keyId].fft; }
 
+  /// Returns the grouping factor of a multi-bit bootstrap key, or 0 for a
+  /// classic bootstrap key.
+  virtual uint32_t bootstrap_grouping_factor(size_t keyId) {
+    return fourier_bootstrap_keys[keyId]
+        .getInfo()
+        .asReader()
+        .getParams()
+        .getGroupingFactor();
+  }
+
   const ServerKeyset getKeys() const { return serverKeyset; }
 
+  /// Returns the scratch arena of the calling thread, shared by all the
+  /// contexts.
+  ScratchArena &scratch_arena();
+
+  /// Returns the number of bytes held by the fourier bootstrap keys of this
+  /// context.
+  size_t memoryFootprint() const;
+
 protected:
   ServerKeyset serverKeyset;
-  std::vector<std::shared_ptr<std::vector<std::complex<double>>>>
-      fourier_bootstrap_keys;
+  std::vector<FourierLweBootstrapKey> fourier_bootstrap_keys;
   std::vector<FFT> ffts;
-  std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>
+  std::pair<FFT, FourierLweBootstrapKey>
   convert_to_fourier_domain(LweBootstrapKey &bsk);
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
@@ -98,14 +172,14 @@ public:
 
     auto bsk = serverKeyset.lweBootstrapKeys[bsk_idx];
 
-    size_t bsk_buffer_len = bsk.getBuffer().size();
+    size_t bsk_buffer_len = bsk.getSize();
     size_t bsk_gpu_buffer_size = bsk_buffer_len * sizeof(double);
 
     void *bsk_gpu_tmp =
         cuda_malloc_async(bsk_gpu_buffer_size, (cudaStream_t)stream, gpu_idx);
     cuda_convert_lwe_programmable_bootstrap_key_64(
         (cudaStream_t)stream, gpu_idx, bsk_gpu_tmp,
-        const_cast<uint64_t *>(bsk.getBuffer().data()), input_lwe_dim, glwe_dim,
+        const_cast<uint64_t *>(bsk.getRawPtr()), input_lwe_dim, glwe_dim,
         level, poly_size);
     // Synchronization here is not optional as it works with mutex to
     // prevent other GPU streams from reading partially copied keys.
@@ -129,13 +203,13 @@ public:
 
     auto ksk = serverKeyset.lweKeyswitchKeys[ksk_idx];
 
-    size_t ksk_buffer_size = sizeof(uint64_t) * ksk.getBuffer().size();
+    size_t ksk_buffer_size = sizeof(uint64_t) * ksk.getSize();
 
     void *ksk_gpu_tmp =
         cuda_malloc_async(ksk_buffer_size, (cudaStream_t)stream, gpu_idx);
 
     cuda_memcpy_async_to_gpu(ksk_gpu_tmp,
-                             const_cast<uint64_t *>(ksk.getBuffer().data()),
+                             const_cast<uint64_t *>(ksk.getRawPtr()),
                              ksk_buffer_size, (cudaStream_t)stream, gpu_idx);
     // Synchronization here is not optional as it works with mutex to
     // prevent other GPU streams from reading partially copied keys.
@@ -161,16 +235,69 @@ struct DistributedRuntimeContext : public RuntimeContext {
   fourier_bootstrap_key_buffer(size_t keyId) override;
   const uint64_t *fp_keyswitch_key_buffer(size_t keyId) override;
   const struct Fft *fft(size_t keyId) override;
+  uint32_t bootstrap_grouping_factor(size_t keyId) override;
 
 private:
   void getBSKonNode(size_t keyId);
   std::mutex cm_guard;
   std::map<size_t, LweKeyswitchKey> ksks;
-  std::map<size_t, std::shared_ptr<std::vector<std::complex<double>>>> fbks;
+  std::map<size_t, FourierLweBootstrapKey> fbks;
   std::map<size_t, FFT> dffts;
   std::map<size_t, PackingKeyswitchKey> pksks;
 };
 
+/// A cache of prepared runtime contexts, keyed by the identity of the server
+/// keyset they were built from.
+///
+/// Building a `RuntimeContext` converts every bootstrap key to the fourier
+/// domain, which is far more expensive than most circuit calls. The cache
+/// builds the context once per keyset and then hands out shared references to
+/// it, which can be used concurrently from several threads. Two keysets have
+/// the same identity if they share the same key buffers, which is the case for
+/// copies of a same keyset. Entries keep their keyset alive, and are only
+/// released on explicit eviction or destruction of the cache.
+class RuntimeContextCache {
+public:
+  struct Metrics {
+    /// Number of lookups served by an already prepared context.
+    uint64_t hits;
+    /// Number of lookups that had to build a new context.
+    uint64_t misses;
+    /// Number of contexts currently held by the cache.
+    size_t entries;
+    /// Number of bytes held by the contexts currently in the cache.
+    size_t memoryFootprint;
+  };
+
+  RuntimeContextCache() : hits(0), misses(0) {}
+  RuntimeContextCache(const RuntimeContextCache &other) = delete;
+
+  /// Returns the context prepared for `serverKeyset`, building it on first
+  /// use. If building the context throws, the exception is rethrown to every
+  /// pending lookup and the next lookup tries again.
+  std::shared_ptr<RuntimeContext> get(const ServerKeyset &serverKeyset);
+
+  /// Drops the context prepared for `serverKeyset`. Returns whether a context
+  /// was found. Contexts still referenced by running calls stay alive until
+  /// those calls return.
+  bool evict(const ServerKeyset &serverKeyset);
+
+  /// Drops every context held by the cache.
+  void evictAll();
+
+  Metrics getMetrics();
+
+private:
+  typedef std::vector<const void *> KeysetIdentity;
+  static KeysetIdentity getKeysetIdentity(const ServerKeyset &serverKeyset);
+
+  std::mutex guard;
+  std::map<KeysetIdentity, std::shared_future<std::shared_ptr<RuntimeContext>>>
+      contexts;
+  uint64_t hits;
+  uint64_t misses;
+};
+
 } // namespace concretelang
 } // namespace mlir
 
@@ -20,8 +20,9 @@ typedef struct dfr_refcounted_future {
       : future(f), count(c), cloned_memref_p(clone_p) {}
 } dfr_refcounted_future_t, *dfr_refcounted_future_p;
 
-// Determine where new task should run.  For now just round-robin
-// distribution - TODO: optimise.
+// Determine where new task should run by default: round-robin
+// distribution.  With the locality-aware policy, this is overridden
+// once the task inputs are available (see dfr_execute_task).
 static inline size_t dfr_get_next_execution_locality() {
   static std::atomic<std::size_t> next_locality{1};
 
@@ -30,6 +31,71 @@ static inline size_t dfr_get_next_execution_locality() {
   return next_loc % num_nodes;
 }
 
+// Size in bytes of the task inputs, including the data of memrefs.
+// This is used both as the volume to transfer to a remote node and as
+// an estimate of the task cost, as the work of FHE operations (and
+// in particular PBS) grows with the number of ciphertexts processed.
+static inline size_t dfr_get_input_bytes(const OpaqueInputData &oid) {
+  size_t bytes = 0;
+  for (size_t p = 0; p < oid.param_sizes.size(); ++p) {
+    bytes += oid.param_sizes[p];
+    if (_dfr_get_arg_type(oid.param_types[p]) != _DFR_TASK_ARG_MEMREF)
+      continue;
+    size_t rank = _dfr_get_memref_rank(oid.param_sizes[p]);
+    UnrankedMemRefType<char> umref = {(int64_t)rank, oid.params[p]};
+    DynamicMemRefType<char> mref(umref);
+    size_t size = _dfr_get_memref_element_size(oid.param_types[p]);
+    for (size_t r = 0; r < rank; ++r)
+      size *= mref.sizes[r];
+    bytes += size;
+  }
+  return bytes;
+}
+
+// Relative cost of transferring a byte of input to a remote node
+// (and the corresponding results back) with respect to processing
+// it, expressed as a divisor of the task cost.
+static const size_t dfr_transfer_cost_divisor = 4;
+
+// Select the node on which to run a task whose inputs are ready.  All
+// task results are gathered on the node creating the tasks, so
+// running a task elsewhere requires shipping its inputs: each node is
+// scored with its current load (the cost of the tasks it is running
+// or has queued) plus the task cost and, for remote nodes, the
+// transfer cost.  Slow nodes keep a high load and thus receive fewer
+// tasks.
+static inline size_t dfr_get_locality_aware_execution_locality(size_t cost) {
+  size_t here = hpx::get_locality_id();
+  size_t best = here;
+  uint64_t best_score = std::numeric_limits<uint64_t>::max();
+  for (size_t node = 0; node < num_nodes; ++node) {
+    uint64_t score = node_load[node].load() + cost;
+    if (node != here)
+      score += cost / dfr_transfer_cost_divisor;
+    if (score < best_score) {
+      best = node;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+static inline hpx::future<OpaqueOutputData>
+dfr_execute_task(const OpaqueInputData &oid, size_t default_locality) {
+  if (placement_policy != dfr_placement_policy::locality_aware ||
+      num_nodes == 1)
+    return gcc[default_locality].execute_task(oid);
+
+  size_t cost = dfr_get_input_bytes(oid);
+  size_t locality = dfr_get_locality_aware_execution_locality(cost);
+  node_load[locality].fetch_add(cost);
+  return gcc[locality].execute_task(oid).then(
+      [locality, cost](hpx::future<OpaqueOutputData> ood) {
+        node_load[locality].fetch_sub(cost);
+        return ood.get();
+      });
+}
+
 void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
                                 std::vector<void *> &refcounted_futures,
                                 std::vector<size_t> &param_sizes,
@@ -55,7 +121,7 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
   // satisfied, which generates a future on a tuple of outputs, which
   // is then further split into a tuple of futures and provide
   // individual synchronization for each return independently.
-  GenericComputeClient *gcc_target = &gcc[dfr_get_next_execution_locality()];
+  size_t locality = dfr_get_next_execution_locality();
   switch (refcounted_futures.size()) {
 
 #include "concretelang/Runtime/generated/dfr_dataflow_inputs_cases.h"
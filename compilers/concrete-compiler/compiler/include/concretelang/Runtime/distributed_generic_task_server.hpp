@@ -34,6 +34,7 @@
 #include "concretelang/Runtime/dfr_debug_interface.h"
 #include "concretelang/Runtime/key_manager.hpp"
 #include "concretelang/Runtime/runtime_api.h"
+#include "concretelang/Runtime/work_stealing_pool.hpp"
 #include "concretelang/Runtime/workfunction_registry.hpp"
 
 using namespace hpx::components;
@@ -253,6 +254,7 @@ struct GenericComputeServer : component_base<GenericComputeServer> {
 
   // Component actions exposed
   OpaqueOutputData execute_task(const OpaqueInputData &inputs) {
+    ConcurrentScope scope;
     auto wfn = _dfr_node_level_work_function_registry->getWorkFunctionPointer(
         inputs.wfn_name);
     std::vector<void *> outputs;
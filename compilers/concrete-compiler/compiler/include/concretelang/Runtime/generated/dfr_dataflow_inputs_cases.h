@@ -1,39 +1,39 @@
 case 0:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx]() -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {};
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     }));
 break;
 
 case 1:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get()};
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future));
 break;
 
 case 2:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get()};
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future));
@@ -41,7 +41,7 @@ break;
 
 case 3:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
@@ -49,7 +49,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -58,7 +58,7 @@ break;
 
 case 4:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
@@ -67,7 +67,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -77,7 +77,7 @@ break;
 
 case 5:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4)
@@ -87,7 +87,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -98,7 +98,7 @@ break;
 
 case 6:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5)
@@ -108,7 +108,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -120,7 +120,7 @@ break;
 
 case 7:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -132,7 +132,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -145,7 +145,7 @@ break;
 
 case 8:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -157,7 +157,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -171,7 +171,7 @@ break;
 
 case 9:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -184,7 +184,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -199,7 +199,7 @@ break;
 
 case 10:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -212,7 +212,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -228,7 +228,7 @@ break;
 
 case 11:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -243,7 +243,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -260,7 +260,7 @@ break;
 
 case 12:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -276,7 +276,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -294,7 +294,7 @@ break;
 
 case 13:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
           hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
           hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
@@ -312,7 +312,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -331,7 +331,7 @@ break;
 
 case 14:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -349,7 +349,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -369,7 +369,7 @@ break;
 
 case 15:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -388,7 +388,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -409,7 +409,7 @@ break;
 
 case 16:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -428,7 +428,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -450,7 +450,7 @@ break;
 
 case 17:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -471,7 +471,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -494,7 +494,7 @@ break;
 
 case 18:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -515,7 +515,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -539,7 +539,7 @@ break;
 
 case 19:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -561,7 +561,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -586,7 +586,7 @@ break;
 
 case 20:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -608,7 +608,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -634,7 +634,7 @@ break;
 
 case 21:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -658,7 +658,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -685,7 +685,7 @@ break;
 
 case 22:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -709,7 +709,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -737,7 +737,7 @@ break;
 
 case 23:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -762,7 +762,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -791,7 +791,7 @@ break;
 
 case 24:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -816,7 +816,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -846,7 +846,7 @@ break;
 
 case 25:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -873,7 +873,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -904,7 +904,7 @@ break;
 
 case 26:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -931,7 +931,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -963,7 +963,7 @@ break;
 
 case 27:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -991,7 +991,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1024,7 +1024,7 @@ break;
 
 case 28:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1052,7 +1052,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1086,7 +1086,7 @@ break;
 
 case 29:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1116,7 +1116,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1151,7 +1151,7 @@ break;
 
 case 30:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1181,7 +1181,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1217,7 +1217,7 @@ break;
 
 case 31:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1248,7 +1248,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1285,7 +1285,7 @@ break;
 
 case 32:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1316,7 +1316,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1354,7 +1354,7 @@ break;
 
 case 33:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1387,7 +1387,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1426,7 +1426,7 @@ break;
 
 case 34:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1459,7 +1459,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1499,7 +1499,7 @@ break;
 
 case 35:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1533,7 +1533,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1574,7 +1574,7 @@ break;
 
 case 36:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1608,7 +1608,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1650,7 +1650,7 @@ break;
 
 case 37:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1686,7 +1686,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1729,7 +1729,7 @@ break;
 
 case 38:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1765,7 +1765,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1809,7 +1809,7 @@ break;
 
 case 39:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1846,7 +1846,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1891,7 +1891,7 @@ break;
 
 case 40:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -1928,7 +1928,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1974,7 +1974,7 @@ break;
 
 case 41:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2013,7 +2013,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2060,7 +2060,7 @@ break;
 
 case 42:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2099,7 +2099,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2147,7 +2147,7 @@ break;
 
 case 43:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2187,7 +2187,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2236,7 +2236,7 @@ break;
 
 case 44:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2276,7 +2276,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2326,7 +2326,7 @@ break;
 
 case 45:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2368,7 +2368,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2419,7 +2419,7 @@ break;
 
 case 46:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2461,7 +2461,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2513,7 +2513,7 @@ break;
 
 case 47:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2556,7 +2556,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2609,7 +2609,7 @@ break;
 
 case 48:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2652,7 +2652,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2706,7 +2706,7 @@ break;
 
 case 49:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2751,7 +2751,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2806,7 +2806,7 @@ break;
 
 case 50:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
+    [wfnname, param_sizes, param_types, output_sizes, output_types, locality,
      ctx](
         hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
         hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
@@ -2851,7 +2851,7 @@ oodf = std::move(hpx::dataflow(
       mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
                                                    param_types, output_sizes,
                                                    output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(oid, locality);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
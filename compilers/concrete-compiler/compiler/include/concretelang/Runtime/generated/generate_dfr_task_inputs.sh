@@ -19,13 +19,13 @@ for i in $(eval echo {$1..$2}); do
     echo "case $i:
     	 oodf = std::move(hpx::dataflow(
         [wfnname, param_sizes, param_types, output_sizes, output_types,
-         gcc_target, ctx]($p1)"
+         locality, ctx]($p1)"
     echo "-> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
           std::vector<void *> params = {$p2};"
     echo "          mlir::concretelang::dfr::OpaqueInputData oid(
               wfnname, params, param_sizes, param_types, output_sizes,
               output_types, ctx);
-          return gcc_target->execute_task(oid);
+          return dfr_execute_task(oid, locality);
         } $p3));
     	 break;
 	 "
@@ -6,6 +6,7 @@
 #ifndef CONCRETELANG_DFR_KEY_MANAGER_HPP
 #define CONCRETELANG_DFR_KEY_MANAGER_HPP
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <stdlib.h>
@@ -58,9 +59,9 @@ template <typename LweKeyType> struct KeyWrapper {
       ar << (size_t)info_string.size();
       ar << hpx::serialization::make_array(info_string.c_str(),
                                            info_string.size());
-      ar << (size_t)k.getTransportBuffer().size();
-      ar << hpx::serialization::make_array(k.getTransportBuffer().data(),
-                                           k.getTransportBuffer().size());
+      ar << (size_t)k.getTransportSize();
+      ar << hpx::serialization::make_array(k.getTransportRawPtr(),
+                                           k.getTransportSize());
     }
   }
   template <class Archive> void load(Archive &ar, const unsigned int version) {
@@ -93,7 +94,11 @@ bool operator==(const KeyWrapper<LweKeyType> &lhs,
   if (lhs.keys.size() != rhs.keys.size())
     return false;
   for (size_t i = 0; i < lhs.keys.size(); ++i)
-    if (lhs.keys[i].getTransportBuffer() != rhs.keys[i].getTransportBuffer())
+    if (lhs.keys[i].getTransportSize() != rhs.keys[i].getTransportSize() ||
+        !std::equal(lhs.keys[i].getTransportRawPtr(),
+                    lhs.keys[i].getTransportRawPtr() +
+                        lhs.keys[i].getTransportSize(),
+                    rhs.keys[i].getTransportRawPtr()))
       return false;
   return true;
 }
@@ -0,0 +1,121 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_WORK_STEALING_POOL_HPP
+#define CONCRETELANG_RUNTIME_WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+/// Marks the calling thread, while in scope, as running one of several
+/// concurrent tasks or calls. Code running in such a scope must not spread its
+/// own work over the batch threads, which would oversubscribe the cores.
+class ConcurrentScope {
+public:
+  ConcurrentScope();
+  ~ConcurrentScope();
+
+  ConcurrentScope(const ConcurrentScope &) = delete;
+  ConcurrentScope &operator=(const ConcurrentScope &) = delete;
+
+  /// Returns true when the calling thread is within a `ConcurrentScope`.
+  static bool active();
+};
+
+/// A fixed-size pool of worker threads with one task deque per worker.
+///
+/// Tasks submitted from a worker are pushed on that worker's own deque and
+/// popped back in LIFO order, tasks submitted from outside the pool are
+/// distributed round-robin. Idle workers steal the oldest task of the other
+/// deques. A thread waiting on a task runs pending tasks in the meantime, so
+/// waiting from within a task never starves the pool. Tasks run within a
+/// `ConcurrentScope`.
+class WorkStealingPool {
+public:
+  /// Completion state of a submitted task.
+  class Task {
+  public:
+    bool isDone() const { return done.load(std::memory_order_acquire); }
+
+  private:
+    friend class WorkStealingPool;
+
+    std::function<void()> work;
+    // Exception thrown by `work`, rethrown by `wait`.
+    std::exception_ptr error;
+    std::atomic<bool> done{false};
+    std::mutex guard;
+    std::condition_variable completed;
+  };
+
+  using Future = std::shared_ptr<Task>;
+
+  explicit WorkStealingPool(size_t numWorkers);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  /// Schedules `work` on the pool and returns a handle to wait on it.
+  Future submit(std::function<void()> work);
+
+  /// Blocks until `future` has completed, running pending tasks while the
+  /// task is still queued. Rethrows the exception thrown by the task, if any.
+  void wait(const Future &future);
+
+  /// Blocks until `isDone` returns true, running pending tasks in the
+  /// meantime. Whatever makes `isDone` true must then call `notifyWaiters`.
+  void waitUntil(const std::function<bool()> &isDone);
+
+  /// Wakes up the threads blocked in `waitUntil` so that they check their
+  /// condition again.
+  void notifyWaiters();
+
+  size_t numWorkers() const { return workers.size(); }
+
+  /// Returns the process-wide pool. Its size is taken from the
+  /// `CONCRETE_ASYNC_NUM_THREADS` environment variable and defaults to the
+  /// hardware concurrency.
+  static WorkStealingPool &global();
+
+private:
+  struct Queue {
+    std::mutex guard;
+    std::deque<Future> tasks;
+  };
+
+  void workerLoop(size_t index);
+  /// Pops a task from the queue of worker `index` (LIFO) or steals one from
+  /// another queue (FIFO). `index` may be out of range for external threads.
+  Future take(size_t index);
+  void run(const Future &task);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> nextQueue{0};
+
+  std::mutex sleepGuard;
+  std::condition_variable wakeUp;
+  std::condition_variable waiting;
+  size_t pending = 0;
+  size_t numWaiting = 0;
+  bool stopping = false;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
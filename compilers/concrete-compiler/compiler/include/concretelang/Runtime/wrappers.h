@@ -133,6 +133,41 @@ void memref_batched_negate_lwe_ciphertext_u64(
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1);
 
+/// \brief Computes `out[i] = ct0[i] * ct1[i] + ct2[i]` for each lwe ciphertext
+/// of the batch.
+///
+/// `ct0` and `ct2` are batches of lwe ciphertexts and `ct1` the cleartexts
+/// multiplying `ct0`. Like the other batched leveled wrappers, `out` may be the
+/// same buffer as `ct0` or `ct2`.
+void memref_batched_mul_cleartext_add_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride, uint64_t *ct2_allocated, uint64_t *ct2_aligned,
+    uint64_t ct2_offset, uint64_t ct2_size0, uint64_t ct2_size1,
+    uint64_t ct2_stride0, uint64_t ct2_stride1);
+
+/// \brief Computes the matrix product of a matrix of lwe ciphertexts and a
+/// matrix of cleartexts.
+///
+/// `ct0` is a MxK matrix of lwe ciphertexts of size n+1, `ct1` a KxN matrix
+/// of cleartexts and `out` the resulting MxN matrix of lwe ciphertexts. The
+/// product is a wrapping u64 GEMM of shape [M.(n+1), K]x[K, N], computed by
+/// blocks of output ciphertexts spread over the batch threads.
+void memref_matmul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_stride0, uint64_t out_stride1, uint64_t out_stride2,
+    uint64_t *ct0_allocated, uint64_t *ct0_aligned, uint64_t ct0_offset,
+    uint64_t ct0_size0, uint64_t ct0_size1, uint64_t ct0_size2,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1);
+
 void memref_batched_keyswitch_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -142,11 +177,17 @@ void memref_batched_keyswitch_lwe_u64(
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context);
 
+/// \brief Schedules `memref_keyswitch_lwe_u64` on the async worker pool.
+///
+/// Returns a future to pass to `memref_await_future`. The buffers and the
+/// context must stay alive and `out` must not be accessed until then.
 void *memref_keyswitch_async_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
     uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, mlir::concretelang::RuntimeContext *context);
+    uint64_t ct0_stride, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context);
 
 void memref_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -158,6 +199,22 @@ void memref_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+/// \brief Bootstraps `ct0` once and extracts `out_size0` ciphertexts from the
+/// rotated accumulator, the `i`-th one at degree `i * lut_stride`.
+///
+/// `tlu` holds the lookup tables interleaved by the compiler so that the
+/// `i`-th output evaluates the `i`-th table.
+void memref_many_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t input_lwe_dim,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t lut_stride, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_batched_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -181,6 +238,9 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+/// \brief Schedules `memref_bootstrap_lwe_u64` on the async worker pool.
+///
+/// Same contract as `memref_keyswitch_async_lwe_u64`.
 void *memref_bootstrap_async_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -191,6 +251,9 @@ void *memref_bootstrap_async_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+/// Waits for a future returned by one of the `*_async_*` wrappers, then copies
+/// its result from `in` to `out` unless both designate the same buffer. The
+/// future is released and must not be awaited again.
 void memref_await_future(uint64_t *out_allocated, uint64_t *out_aligned,
                          uint64_t out_offset, uint64_t out_size,
                          uint64_t out_stride, void *future,
@@ -306,6 +369,14 @@ void memref_trace_plaintext(uint64_t input, uint64_t input_width,
 
 void memref_trace_message(char *message_ptr, uint32_t message_len);
 
+/// @brief Set the number of threads used to process batched bootstraps,
+/// matrix products and large batched leveled operations
+///
+/// Defaults to the value of the `CONCRETE_BATCH_NUM_THREADS` environment
+/// variable if set, and to the maximum number of OpenMP threads otherwise.
+/// @param num_threads number of threads, 0 to restore the default
+void concrete_set_batch_num_threads(size_t num_threads);
+
 /// @brief Allocate memory using malloc and check for nullptr
 /// @param size number of bytes to allocate
 /// @return pointer to the allocated memory or nullptr
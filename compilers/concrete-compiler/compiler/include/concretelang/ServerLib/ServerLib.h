@@ -13,6 +13,7 @@
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
+#include "concretelang/Runtime/context.h"
 #include "llvm/ADT/ArrayRef.h"
 #include <cassert>
 #include <dlfcn.h>
@@ -25,6 +26,7 @@ using concretelang::transformers::ArgTransformer;
 using concretelang::transformers::ReturnTransformer;
 using concretelang::transformers::TransformerFactory;
 using concretelang::values::Value;
+using mlir::concretelang::RuntimeContextCache;
 
 namespace concretelang {
 namespace serverlib {
@@ -42,17 +44,59 @@ private:
   void *libraryHandle;
 };
 
+/// A circuit loaded from a dynamic module.
+///
+/// A server circuit holds no per-call state, hence a single instance (and the
+/// runtime contexts it shares with its program) can be called concurrently
+/// from multiple threads.
 class ServerCircuit {
   friend class ServerProgram;
 
 public:
   /// Call the circuit with public arguments.
-  Result<std::vector<TransportValue>> call(const ServerKeyset &serverKeyset,
-                                           std::vector<TransportValue> &args);
+  Result<std::vector<TransportValue>>
+  call(const ServerKeyset &serverKeyset,
+       std::vector<TransportValue> &args) const;
+
+  /// Call the circuit with public arguments owned by the caller, e.g. by
+  /// python objects, which are not copied.
+  Result<std::vector<TransportValue>>
+  call(const ServerKeyset &serverKeyset,
+       const std::vector<const TransportValue *> &args) const;
+
+  /// Options of a batched call.
+  struct BatchOptions {
+    /// Whether the calls of the batch run concurrently. They run one after the
+    /// other otherwise.
+    bool concurrent = true;
+    /// The maximum number of threads running the calls when `concurrent` is
+    /// set. Zero defaults to the `CONCRETE_SERVER_NUM_THREADS` environment
+    /// variable, or to the hardware concurrency.
+    size_t numThreads = 0;
+  };
+
+  /// Call the circuit once for each set of public arguments of `batch`, and
+  /// returns the results in the same order. The runtime context and the dfr
+  /// setup are shared by the whole batch. Fails with the error of the first
+  /// failing call, if any.
+  Result<std::vector<std::vector<TransportValue>>>
+  callBatch(const ServerKeyset &serverKeyset,
+            std::vector<std::vector<TransportValue>> &batch,
+            BatchOptions options = BatchOptions()) const;
+
+  /// Same as above, with public arguments owned by the caller.
+  Result<std::vector<std::vector<TransportValue>>>
+  callBatch(const ServerKeyset &serverKeyset,
+            const std::vector<std::vector<const TransportValue *>> &batch,
+            BatchOptions options = BatchOptions()) const;
 
   /// Simulate the circuit with public arguments.
   Result<std::vector<TransportValue>>
-  simulate(std::vector<TransportValue> &args);
+  simulate(std::vector<TransportValue> &args) const;
+
+  /// Simulate the circuit with public arguments owned by the caller.
+  Result<std::vector<TransportValue>>
+  simulate(const std::vector<const TransportValue *> &args) const;
 
   /// Returns the name of this circuit.
   std::string getName();
@@ -63,18 +107,28 @@ private:
   static Result<ServerCircuit>
   fromDynamicModule(const Message<concreteprotocol::CircuitInfo> &circuitInfo,
                     std::shared_ptr<DynamicModule> dynamicModule,
+                    std::shared_ptr<RuntimeContextCache> runtimeContextCache,
                     bool useSimulation);
 
-  void invoke(const ServerKeyset &serverKeyset);
+  /// Transforms `args`, invokes the circuit function on them with
+  /// `runtimeContext`, and transforms the results.
+  Result<std::vector<TransportValue>>
+  callWithContext(mlir::concretelang::RuntimeContext *runtimeContext,
+                  const std::vector<const TransportValue *> &args) const;
+
+  /// Invokes the circuit function on the values of `argsBuffer`, and stores
+  /// the results in `returnsBuffer`. Both buffers belong to the caller frame.
+  void invoke(mlir::concretelang::RuntimeContext *runtimeContext,
+              std::vector<Value> &argsBuffer,
+              std::vector<Value> &returnsBuffer) const;
 
   Message<concreteprotocol::CircuitInfo> circuitInfo;
   bool useSimulation;
   void (*func)(void *...);
   std::shared_ptr<DynamicModule> dynamicModule;
+  std::shared_ptr<RuntimeContextCache> runtimeContextCache;
   std::vector<ArgTransformer> argTransformers;
   std::vector<ReturnTransformer> returnTransformers;
-  std::vector<Value> argsBuffer;
-  std::vector<Value> returnsBuffer;
   std::vector<size_t> argDescriptorSizes;
   std::vector<size_t> returnDescriptorSizes;
   size_t argRawSize;
@@ -91,10 +145,22 @@ public:
 
   Result<ServerCircuit> getServerCircuit(const std::string &circuitName);
 
+  /// Releases the runtime context prepared for `serverKeyset`, if any. Returns
+  /// whether a context was released.
+  bool evictRuntimeContext(const ServerKeyset &serverKeyset);
+
+  /// Releases every runtime context prepared by the circuits of this program.
+  void evictAllRuntimeContexts();
+
+  /// Returns the hit rate and memory footprint of the runtime context cache
+  /// shared by the circuits of this program.
+  RuntimeContextCache::Metrics getRuntimeContextCacheMetrics();
+
 private:
   ServerProgram() = default;
 
   std::vector<ServerCircuit> serverCircuits;
+  std::shared_ptr<RuntimeContextCache> runtimeContextCache;
 };
 
 } // namespace serverlib
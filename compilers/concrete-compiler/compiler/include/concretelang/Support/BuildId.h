@@ -0,0 +1,20 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_BUILD_ID_H_
+#define CONCRETELANG_SUPPORT_BUILD_ID_H_
+
+namespace mlir {
+namespace concretelang {
+
+/// Returns the identifier of the compiler build, a hash of the compiler and
+/// optimizer sources it was built from. Two compilers share their id if and
+/// only if they were built from the same sources.
+const char *getCompilerBuildId();
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -49,6 +49,13 @@ enum Backend {
   GPU,
 };
 
+/// Default target duration of dataflow tasks, in microseconds: about two
+/// bootstraps, well above the scheduling overhead of a task.
+constexpr uint64_t DEFAULT_DATAFLOW_TASK_DURATION = 10000;
+
+/// Default maximum width in bits of a table packing several lookup tables
+constexpr unsigned int DEFAULT_MANY_LOOKUP_TABLES_MAX_WIDTH = 8;
+
 /// Compilation options allows to configure the compilation pipeline.
 struct CompilationOptions {
   std::optional<mlir::concretelang::V0FHEConstraint> v0FHEConstraints;
@@ -72,6 +79,10 @@ struct CompilationOptions {
   bool autoParallelize;
   bool loopParallelize;
   bool dataflowParallelize;
+  /// Target estimated duration of dataflow tasks, in microseconds. Cheaper
+  /// operations are merged into a single task and longer ones are split into
+  /// chunks. Zero creates one task per candidate operation.
+  uint64_t dataflowTaskDuration;
 
   /// Compression options
   bool compressEvaluationKeys;
@@ -86,6 +97,11 @@ struct CompilationOptions {
   /// Other options
   bool batchTFHEOps;
   int64_t maxBatchSize;
+  bool asyncTFHEOps;
+  /// Lower encrypted by clear matrix products, dot products and convolutions
+  /// to a dense matrix product kernel instead of scalar loops. Only applies to
+  /// the scalar lowering without simulation.
+  bool gemmTFHEOps;
   bool emitSDFGOps;
   bool unrollLoopsWithSDFGConvertibleOps;
   bool optimizeTFHE;
@@ -99,6 +115,18 @@ struct CompilationOptions {
   unsigned int chunkSize;
   unsigned int chunkWidth;
 
+  /// Pack constant lookup tables applied to the same encrypted integer into a
+  /// single many-lut bootstrap, as long as the packed table has at most
+  /// manyLookupTablesMaxWidth bits. Only applies to the CPU backend.
+  bool manyLookupTables;
+  unsigned int manyLookupTablesMaxWidth;
+
+  /// Replace the bootstrap keys by multi-bit bootstrap keys grouping up to
+  /// maxMultiBitGroupingFactor secret key bits, when the multi-bit bootstrap
+  /// is cheaper without being noisier. 0 disables multi-bit bootstrapping.
+  /// Only applies to the CPU backend with uncompressed evaluation keys.
+  unsigned int maxMultiBitGroupingFactor;
+
   /// When compiling from a dialect lower than FHE, one needs to provide
   /// encodings info manually to allow the client lib to be generated.
   std::optional<Message<concreteprotocol::ProgramEncodingInfo>> encodings;
@@ -108,6 +136,12 @@ struct CompilationOptions {
   bool enableTluFusing;
   bool printTluFusing;
 
+  /// Directory of the on-disk compilation cache. When set, compiling to a
+  /// library reuses the artifacts of a previous compilation of the same
+  /// sources with the same options, instead of running the pipeline again.
+  /// Falls back to the `CONCRETE_COMPILATION_CACHE_DIR` environment variable.
+  std::optional<std::string> compilationCacheDir;
+
   CompilationOptions()
       : v0FHEConstraints(std::nullopt), verifyDiagnostics(false),
         /// Simulate options
@@ -115,6 +149,7 @@ struct CompilationOptions {
         // Parallelization options
         autoParallelize(false), loopParallelize(true),
         dataflowParallelize(false),
+        dataflowTaskDuration(DEFAULT_DATAFLOW_TASK_DURATION),
         /// Compression options
         compressEvaluationKeys(false), compressInputCiphertexts(false),
         /// Optimizer options
@@ -123,9 +158,14 @@ struct CompilationOptions {
         emitGPUOps(false),
         /// Other options
         batchTFHEOps(false), maxBatchSize(std::numeric_limits<int64_t>::max()),
-        emitSDFGOps(false), unrollLoopsWithSDFGConvertibleOps(false),
-        optimizeTFHE(true), chunkIntegers(false), chunkSize(4), chunkWidth(2),
-        encodings(std::nullopt), enableTluFusing(true), printTluFusing(false){};
+        asyncTFHEOps(false), gemmTFHEOps(false), emitSDFGOps(false),
+        unrollLoopsWithSDFGConvertibleOps(false), optimizeTFHE(true),
+        chunkIntegers(false), chunkSize(4), chunkWidth(2),
+        manyLookupTables(false),
+        manyLookupTablesMaxWidth(DEFAULT_MANY_LOOKUP_TABLES_MAX_WIDTH),
+        maxMultiBitGroupingFactor(0), encodings(std::nullopt),
+        enableTluFusing(true), printTluFusing(false),
+        compilationCacheDir(std::nullopt){};
 
   /// @brief Constructor for CompilationOptions with default parameters for a
   /// specific backend.
@@ -319,7 +359,7 @@ public:
       : overrideMaxEintPrecision(), overrideMaxMANP(), compilerOptions(),
         generateProgramInfo(true),
         enablePass([](mlir::Pass *pass) { return true; }),
-        compilationContext(compilationContext) {}
+        customEnablePass(false), compilationContext(compilationContext) {}
 
   llvm::Expected<CompilationResult>
   compile(llvm::StringRef s, Target target,
@@ -379,10 +419,23 @@ protected:
   CompilationOptions compilerOptions;
   bool generateProgramInfo;
   std::function<bool(mlir::Pass *)> enablePass;
+  /// Whether `enablePass` has been overridden, in which case compilation
+  /// results are not cached as the filter cannot be part of the cache key.
+  bool customEnablePass;
 
   std::shared_ptr<CompilationContext> compilationContext;
 
 private:
+  /// Returns the library compiled by `compileLibrary`, going through the
+  /// compilation cache when one is configured. `sources` returns the textual
+  /// input of the compilation, which takes part in the cache key.
+  llvm::Expected<Library> compileLibraryWithCache(
+      std::function<std::string()> sources, std::string outputDirPath,
+      std::string runtimeLibraryPath, bool generateSharedLib,
+      bool generateStaticLib, bool generateClientParameters,
+      bool generateCompilationFeedback,
+      std::function<llvm::Expected<Library>()> compileLibrary);
+
   llvm::Expected<std::optional<optimizer::Description>>
   getConcreteOptimizerDescription(CompilationResult &res);
   llvm::Error determineFHEParameters(CompilationResult &res);
@@ -13,6 +13,12 @@ namespace concretelang {
 
 llvm::Error emitObject(llvm::Module &module, std::string objectPath);
 
+/// Emits `module` as `objectPaths.size()` object files which, linked together,
+/// are equivalent to the single object emitted by `emitObject`. The partitions
+/// are code generated in parallel.
+llvm::Error emitObjects(llvm::Module &module,
+                        std::vector<std::string> objectPaths);
+
 llvm::Error callCmd(std::string cmd);
 
 llvm::Error emitLibrary(std::vector<std::string> objectsPath,
@@ -0,0 +1,85 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_OPTIMIZER_CACHE_H_
+#define CONCRETELANG_SUPPORT_OPTIMIZER_CACHE_H_
+
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+
+#include "concrete-optimizer.hpp"
+#include "concretelang/Support/V0Parameters.h"
+
+namespace mlir {
+namespace concretelang {
+namespace optimizer {
+
+/// On-disk cache of the solutions of the concrete-optimizer.
+///
+/// An entry is keyed by the kind of optimization, the fingerprint of the
+/// optimized dag and every option the optimization depends on. The
+/// fingerprint leaves out names, locations and lookup table contents, so
+/// isomorphic dags share their entries.
+///
+/// Each entry is a JSON file named after the hash of its key:
+///
+///   {"version": <VERSION>, "key": <key>, "solution": <solution>}
+///
+/// Entries of another version, or whose key differs because of a hash
+/// collision, are ignored. Entries are written to a temporary file which is
+/// then renamed, so concurrent compilations sharing a cache never read a
+/// partial entry.
+class SolutionCache {
+public:
+  /// Version of the entries format, to bump on any change of the format or of
+  /// the key.
+  static constexpr int64_t VERSION = 1;
+
+  explicit SolutionCache(std::string directory) : directory(directory) {}
+
+  /// Returns the cache located in the `CONCRETE_OPTIMIZER_CACHE_DIR`
+  /// environment variable, if set.
+  static std::optional<SolutionCache> fromEnvironment();
+
+  /// Returns the key of the optimization of `dag` with `options`, `kind`
+  /// telling the optimization strategy apart. Returns nothing when the
+  /// options cannot be part of a key.
+  static std::optional<std::string>
+  getKey(llvm::StringRef kind, const concrete_optimizer::Dag &dag,
+         const concrete_optimizer::Options &options);
+
+  std::optional<DagSolution> lookupDagSolution(llvm::StringRef key);
+  std::optional<CircuitSolution> lookupCircuitSolution(llvm::StringRef key);
+
+  void store(llvm::StringRef key, const DagSolution &solution);
+  void store(llvm::StringRef key, const CircuitSolution &solution);
+
+  /// Returns the cached mono parameter solution of `dag` with `options`, or
+  /// computes it with `optimize` and caches it.
+  DagSolution getOrOptimizeMono(const concrete_optimizer::Dag &dag,
+                                const concrete_optimizer::Options &options,
+                                std::function<DagSolution()> optimize);
+
+  /// Returns the cached multi parameters solution of `dag` with `options`, or
+  /// computes it with `optimize` and caches it.
+  CircuitSolution
+  getOrOptimizeMulti(const concrete_optimizer::Dag &dag,
+                     const concrete_optimizer::Options &options,
+                     std::function<CircuitSolution()> optimize);
+
+private:
+  std::string getEntryPath(llvm::StringRef key);
+
+  std::string directory;
+};
+
+} // namespace optimizer
+} // namespace concretelang
+} // namespace mlir
+
+#endif
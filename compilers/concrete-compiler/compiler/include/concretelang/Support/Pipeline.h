@@ -17,7 +17,8 @@ namespace concretelang {
 namespace pipeline {
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass);
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t dataflowTaskDuration = 0);
 
 mlir::LogicalResult materializeOptimizerPartitionFrontiers(
     mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -42,7 +43,8 @@ transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerFHELinalgToLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                       std::function<bool(mlir::Pass *)> enablePass);
+                       std::function<bool(mlir::Pass *)> enablePass,
+                       bool gemm = false);
 
 mlir::LogicalResult
 tileMarkedLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -62,6 +64,12 @@ transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
                    unsigned int chunkSize, unsigned int chunkWidth);
 
+mlir::LogicalResult
+transformFHEManyLookupTables(mlir::MLIRContext &context,
+                             mlir::ModuleOp &module,
+                             std::function<bool(mlir::Pass *)> enablePass,
+                             unsigned int maxLutWidth);
+
 mlir::LogicalResult
 lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                std::optional<V0FHEContext> &fheContext,
@@ -139,7 +147,7 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
                                 std::function<bool(mlir::Pass *)> enablePass,
-                                bool gpu);
+                                bool gpu, bool async);
 
 mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
                                        llvm::Module &module);
@@ -23,7 +23,9 @@ llvm::Expected<Message<concreteprotocol::ProgramInfo>>
 createProgramInfoFromTfheDialect(
     mlir::ModuleOp module, int bitsOfSecurity,
     const Message<concreteprotocol::ProgramEncodingInfo> &encodings,
-    bool compressEvaluationKeys, bool compressInputCiphertexts);
+    bool compressEvaluationKeys, bool compressInputCiphertexts,
+    const optimizer::Config &optimizerConfig,
+    unsigned int maxMultiBitGroupingFactor);
 
 } // namespace concretelang
 } // namespace mlir
@@ -201,6 +201,11 @@ public:
     return serverCircuit;
   }
 
+  Result<concretelang::keysets::ServerKeyset> getServerKeyset() {
+    OUTCOME_TRY(auto ks, getKeyset());
+    return ks.server;
+  }
+
   bool isSimulation() { return compiler.getCompilationOptions().simulate; }
 
 private:
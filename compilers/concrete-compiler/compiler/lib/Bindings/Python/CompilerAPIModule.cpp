@@ -136,6 +136,16 @@ std::string roundTrip(const char *module) {
   return os.str();
 }
 
+// Returns the tensor of a value built from a python integer or int64 array,
+// without copying it.
+Tensor<int64_t> &getPythonInt64Tensor(Value &input) {
+  auto tensor = input.getTensorPtr<int64_t>();
+  if (tensor == nullptr) {
+    throw std::runtime_error("Expected a value of 64 bits signed integers.");
+  }
+  return *tensor;
+}
+
 // Every number sent by python through the API has a type `int64` that must be
 // turned into the proper type expected by the ArgTransformers. This allows to
 // get an extra transformer executed right before the ArgTransformer gets
@@ -144,36 +154,31 @@ std::function<Value(Value)>
 getPythonTypeTransformer(const Message<concreteprotocol::GateInfo> &info) {
   if (info.asReader().getTypeInfo().hasIndex()) {
     return [=](Value input) {
-      Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-      return Value{(Tensor<uint64_t>)tensorInput};
+      return Value{(Tensor<uint64_t>)getPythonInt64Tensor(input)};
     };
   } else if (info.asReader().getTypeInfo().hasPlaintext()) {
     if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
         8) {
       return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint8_t>)tensorInput};
+        return Value{(Tensor<uint8_t>)getPythonInt64Tensor(input)};
       };
     }
     if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
         16) {
       return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint16_t>)tensorInput};
+        return Value{(Tensor<uint16_t>)getPythonInt64Tensor(input)};
       };
     }
     if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
         32) {
       return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint32_t>)tensorInput};
+        return Value{(Tensor<uint32_t>)getPythonInt64Tensor(input)};
       };
     }
     if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
         64) {
       return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint64_t>)tensorInput};
+        return Value{(Tensor<uint64_t>)getPythonInt64Tensor(input)};
       };
     }
     assert(false);
@@ -192,8 +197,7 @@ getPythonTypeTransformer(const Message<concreteprotocol::GateInfo> &info) {
       return [=](Value input) { return input; };
     } else {
       return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint64_t>)tensorInput};
+        return Value{(Tensor<uint64_t>)getPythonInt64Tensor(input)};
       };
     }
   } else {
@@ -202,18 +206,31 @@ getPythonTypeTransformer(const Message<concreteprotocol::GateInfo> &info) {
 };
 
 template <typename T> Tensor<T> arrayToTensor(pybind11::array &input) {
-  auto data_ptr = (const T *)input.data();
-  std::vector<T> data = std::vector(data_ptr, data_ptr + input.size());
-  auto dims = std::vector<size_t>(input.ndim(), 0);
-  for (ssize_t i = 0; i < input.ndim(); i++) {
-    dims[i] = input.shape(i);
+  if (!pybind11::bool_(input.dtype().attr("isnative"))) {
+    throw std::runtime_error("Values can only be constructed from arrays in "
+                             "native byte order.");
+  }
+  // Strided arrays are made contiguous first, contiguous ones are read as is
+  // and copied in a single pass.
+  auto contiguous = pybind11::array::ensure(input, pybind11::array::c_style);
+  auto data_ptr = (const T *)contiguous.data();
+  std::vector<T> data = std::vector(data_ptr, data_ptr + contiguous.size());
+  auto dims = std::vector<size_t>(contiguous.ndim(), 0);
+  for (ssize_t i = 0; i < contiguous.ndim(); i++) {
+    dims[i] = contiguous.shape(i);
   }
   return std::move(Tensor<T>(std::move(data), std::move(dims)));
 }
 
-template <typename T> pybind11::array tensorToArray(Tensor<T> input) {
-  return pybind11::array(pybind11::array::ShapeContainer(input.dimensions),
-                         input.values.data());
+/// Returns a read-only array viewing the data of `input`, which keeps `owner`,
+/// the python object holding the tensor, alive.
+template <typename T>
+pybind11::array tensorToArray(Tensor<T> &input, pybind11::handle owner) {
+  auto output =
+      pybind11::array(pybind11::array::ShapeContainer(input.dimensions),
+                      input.values.data(), owner);
+  output.attr("setflags")(pybind11::arg("write") = false);
+  return output;
 }
 } // namespace
 
@@ -474,6 +491,14 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Set option for dataflow parallelization.",
           arg("dataflow_parallelize"))
+      .def(
+          "set_dataflow_task_duration",
+          [](CompilationOptions &options, uint64_t duration) {
+            options.dataflowTaskDuration = duration;
+          },
+          "Set the target estimated duration of dataflow tasks, in "
+          "microseconds (0 creates one task per candidate operation).",
+          arg("dataflow_task_duration"))
       .def(
           "set_compress_evaluation_keys",
           [](CompilationOptions &options, bool b) {
@@ -627,6 +652,44 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Set flag that triggers the batching of scalar TFHE operations.",
           arg("batch_tfhe_ops"))
+      .def(
+          "set_async_tfhe_ops",
+          [](CompilationOptions &options, bool async_tfhe_ops) {
+            options.asyncTFHEOps = async_tfhe_ops;
+          },
+          "Set flag that offloads CPU keyswitches and bootstraps to the "
+          "runtime worker pool.",
+          arg("async_tfhe_ops"))
+      .def(
+          "set_gemm_tfhe_ops",
+          [](CompilationOptions &options, bool gemm_tfhe_ops) {
+            options.gemmTFHEOps = gemm_tfhe_ops;
+          },
+          "Set flag that lowers encrypted by clear matrix products, dot "
+          "products and convolutions to a dense matrix product kernel.",
+          arg("gemm_tfhe_ops"))
+      .def(
+          "set_many_lookup_tables",
+          [](CompilationOptions &options, bool many_lookup_tables,
+             unsigned int max_width) {
+            options.manyLookupTables = many_lookup_tables;
+            options.manyLookupTablesMaxWidth = max_width;
+          },
+          "Set flag that evaluates constant lookup tables applied to the same "
+          "encrypted integer with a single many-lut bootstrap, packing tables "
+          "of at most `max_width` bits.",
+          arg("many_lookup_tables"),
+          arg("max_width") =
+              mlir::concretelang::DEFAULT_MANY_LOOKUP_TABLES_MAX_WIDTH)
+      .def(
+          "set_max_multi_bit_grouping_factor",
+          [](CompilationOptions &options, unsigned int grouping_factor) {
+            options.maxMultiBitGroupingFactor = grouping_factor;
+          },
+          "Set the maximum number of secret key bits grouped by the multi-bit "
+          "bootstrap keys used when they are cheaper without being noisier "
+          "than the classic ones, 0 disabling multi-bit bootstrapping.",
+          arg("grouping_factor"))
       .def(
           "set_enable_tlu_fusing",
           [](CompilationOptions &options, bool enableTluFusing) {
@@ -639,6 +702,14 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             options.printTluFusing = printTluFusing;
           },
           "Enable or disable printing tlu fusing.", arg("print_tlu_fusing"))
+      .def(
+          "set_compilation_cache_dir",
+          [](CompilationOptions &options, std::string path) {
+            options.compilationCacheDir = path;
+          },
+          "Set the directory of the on-disk compilation cache, compilations "
+          "of the same program with the same options reuse its artifacts.",
+          arg("path"))
       .def(
           "set_enable_overflow_detection_in_simulation",
           [](CompilationOptions &options, bool enableOverflowDetection) {
@@ -1573,6 +1644,25 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return pybind11::bytes(serverKeysetSerialize(serverKeyset));
           },
           "Serialize a ServerKeyset to bytes.")
+      .def(
+          "precompute_fourier_bootstrap_keys",
+          [](ServerKeyset &serverKeyset) {
+            serverKeyset.precomputeFourierBootstrapKeys();
+          },
+          "Convert the bootstrap keys to the fourier domain, such that the "
+          "conversion is serialized along with the keyset and skipped when "
+          "the keyset is loaded on the server.")
+      .def(
+          "has_fourier_bootstrap_key",
+          [](ServerKeyset &serverKeyset, size_t index) {
+            if (index >= serverKeyset.lweBootstrapKeys.size()) {
+              throw std::out_of_range("Invalid bootstrap key index.");
+            }
+            return serverKeyset.getFourierBootstrapKey(index) != nullptr;
+          },
+          "Return whether the runtime uses a precomputed fourier form of the "
+          "bootstrap key at `index` instead of converting it.",
+          arg("index"))
       .doc() = "Server-side / Evaluation keyset";
 
   // ------------------------------------------------------------------------------//
@@ -1717,11 +1807,17 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           "parameters `glwe_dim` and `poly_size`.",
           arg("key_id"), arg("glwe_dim"), arg("poly_size"))
       .def(
-          "get_server_keys", [](Keyset &keyset) { return keyset.server; },
-          "Return the associated ServerKeyset.")
-      .def(
-          "get_client_keys", [](Keyset &keyset) { return keyset.client; },
-          "Return the associated ClientKeyset.")
+          "get_server_keys",
+          [](Keyset &keyset) -> ServerKeyset & { return keyset.server; },
+          "Return the associated ServerKeyset. It is a view of the keyset, "
+          "the keys are not copied.",
+          pybind11::return_value_policy::reference_internal)
+      .def(
+          "get_client_keys",
+          [](Keyset &keyset) -> ClientKeyset & { return keyset.client; },
+          "Return the associated ClientKeyset. It is a view of the keyset, "
+          "the keys are not copied.",
+          pybind11::return_value_policy::reference_internal)
       .doc() =
       "Complete keyset containing both client-side and server-side keys.";
 
@@ -1951,7 +2047,8 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
            arg("input"))
       .def(
           "to_py_val",
-          [](Value &value) -> PyValType {
+          [](pybind11::object self) -> PyValType {
+            Value &value = self.cast<Value &>();
             if (value.isScalar()) {
               if (value.hasElementType<int8_t>()) {
                 return {value.getTensor<int8_t>()->values[0]};
@@ -1979,33 +2076,34 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
               }
             } else {
               if (value.hasElementType<int8_t>()) {
-                return {tensorToArray(value.getTensor<int8_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<int8_t>(), self)};
               }
               if (value.hasElementType<int16_t>()) {
-                return {tensorToArray(value.getTensor<int16_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<int16_t>(), self)};
               }
               if (value.hasElementType<int32_t>()) {
-                return {tensorToArray(value.getTensor<int32_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<int32_t>(), self)};
               }
               if (value.hasElementType<int64_t>()) {
-                return {tensorToArray(value.getTensor<int64_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<int64_t>(), self)};
               }
               if (value.hasElementType<uint8_t>()) {
-                return {tensorToArray(value.getTensor<uint8_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<uint8_t>(), self)};
               }
               if (value.hasElementType<uint16_t>()) {
-                return {tensorToArray(value.getTensor<uint16_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<uint16_t>(), self)};
               }
               if (value.hasElementType<uint32_t>()) {
-                return {tensorToArray(value.getTensor<uint32_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<uint32_t>(), self)};
               }
               if (value.hasElementType<uint64_t>()) {
-                return {tensorToArray(value.getTensor<uint64_t>().value())};
+                return {tensorToArray(*value.getTensorPtr<uint64_t>(), self)};
               }
             }
             throw std::invalid_argument("Value has insupported scalar type.");
           },
-          "Return the inner value as a python type.")
+          "Return the inner value as a python type. Tensors are returned as "
+          "read-only arrays viewing the value, without copy.")
       .def(
           "is_scalar", [](Value &val) { return val.isScalar(); },
           "Return whether the value is a scalar.")
@@ -2024,8 +2122,9 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   pybind11::class_<ServerCircuit>(m, "ServerCircuit")
       .def(
           "call",
-          [](ServerCircuit &circuit, std::vector<TransportValue> args,
-             ServerKeyset keyset) {
+          [](ServerCircuit &circuit,
+             const std::vector<const TransportValue *> &args,
+             const ServerKeyset &keyset) {
             SignalGuard signalGuard;
             pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto output, circuit.call(keyset, args));
@@ -2034,9 +2133,26 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           "Perform circuit call with `args` arguments using the `keyset` "
           "ServerKeyset.",
           arg("args"), arg("keyset"))
+      .def(
+          "call_batch",
+          [](ServerCircuit &circuit,
+             const std::vector<std::vector<const TransportValue *>> &batch,
+             const ServerKeyset &keyset, bool concurrent) {
+            SignalGuard signalGuard;
+            pybind11::gil_scoped_release release;
+            ServerCircuit::BatchOptions options;
+            options.concurrent = concurrent;
+            GET_OR_THROW_RESULT(auto output,
+                                circuit.callBatch(keyset, batch, options));
+            return output;
+          },
+          "Perform a circuit call for each list of arguments of `batch` using "
+          "the `keyset` ServerKeyset, concurrently if `concurrent` is set.",
+          arg("batch"), arg("keyset"), arg("concurrent") = true)
       .def(
           "simulate",
-          [](ServerCircuit &circuit, std::vector<TransportValue> &args) {
+          [](ServerCircuit &circuit,
+             const std::vector<const TransportValue *> &args) {
             pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto output, circuit.simulate(args));
             return output;
@@ -2069,6 +2185,31 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return result;
           },
           "Return the `circuit` ServerCircuit.", arg("circuit"))
+      .def(
+          "evict_runtime_context",
+          [](ServerProgram &program, ServerKeyset &keyset) {
+            return program.evictRuntimeContext(keyset);
+          },
+          "Release the runtime context prepared for the `keyset` "
+          "ServerKeyset. Return whether a context was released.",
+          arg("keyset"))
+      .def(
+          "evict_all_runtime_contexts",
+          [](ServerProgram &program) { program.evictAllRuntimeContexts(); },
+          "Release every runtime context prepared by the program circuits.")
+      .def(
+          "get_runtime_context_cache_metrics",
+          [](ServerProgram &program) {
+            auto metrics = program.getRuntimeContextCacheMetrics();
+            pybind11::dict output;
+            output["hits"] = metrics.hits;
+            output["misses"] = metrics.misses;
+            output["entries"] = metrics.entries;
+            output["memory_footprint"] = metrics.memoryFootprint;
+            return output;
+          },
+          "Return the hits, misses, entries and memory footprint (in bytes) "
+          "of the runtime context cache.")
       .doc() = "Server-side / Evaluation program.";
 
   // ------------------------------------------------------------------------------//
@@ -2078,12 +2219,13 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   pybind11::class_<ClientCircuit>(m, "ClientCircuit")
       .def(
           "prepare_input",
-          [](ClientCircuit &circuit, Value arg, size_t pos) {
+          [](ClientCircuit &circuit, const Value &arg, size_t pos) {
             if (pos > circuit.getCircuitInfo().asReader().getInputs().size()) {
               throw std::runtime_error("Unknown position.");
             }
             auto info = circuit.getCircuitInfo().asReader().getInputs()[pos];
             auto typeTransformer = getPythonTypeTransformer((GateInfo)info);
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(
                 auto ok, circuit.prepareInput(typeTransformer(arg), pos));
             return ok;
@@ -2092,7 +2234,8 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           arg("arg"), arg("pos"))
       .def(
           "process_output",
-          [](ClientCircuit &circuit, TransportValue result, size_t pos) {
+          [](ClientCircuit &circuit, const TransportValue &result, size_t pos) {
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto ok, circuit.processOutput(result, pos));
             return ok;
           },
@@ -2101,12 +2244,13 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           arg("result"), arg("pos"))
       .def(
           "simulate_prepare_input",
-          [](ClientCircuit &circuit, Value arg, size_t pos) {
+          [](ClientCircuit &circuit, const Value &arg, size_t pos) {
             if (pos > circuit.getCircuitInfo().asReader().getInputs().size()) {
               throw std::runtime_error("Unknown position.");
             }
             auto info = circuit.getCircuitInfo().asReader().getInputs()[pos];
             auto typeTransformer = getPythonTypeTransformer((GateInfo)info);
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto ok, circuit.simulatePrepareInput(
                                              typeTransformer(arg), pos));
             return ok;
@@ -2117,7 +2261,8 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           arg("arg"), arg("pos"))
       .def(
           "simulate_process_output",
-          [](ClientCircuit &circuit, TransportValue result, size_t pos) {
+          [](ClientCircuit &circuit, const TransportValue &result, size_t pos) {
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto ok,
                                 circuit.simulateProcessOutput(result, pos));
             return ok;
@@ -2134,7 +2279,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   pybind11::class_<ClientProgram>(m, "ClientProgram")
       .def_static(
           "create_encrypted",
-          [](ProgramInfo programInfo, Keyset keyset) {
+          [](const ProgramInfo &programInfo, const Keyset &keyset) {
             GET_OR_THROW_RESULT(
                 auto clientProgram,
                 ClientProgram::createEncrypted(
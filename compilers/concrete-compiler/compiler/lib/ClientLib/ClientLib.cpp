@@ -116,7 +116,8 @@ Result<TransportValue> ClientCircuit::prepareInput(Value arg, size_t pos) {
   return inputTransformers[pos](arg);
 }
 
-Result<Value> ClientCircuit::processOutput(TransportValue result, size_t pos) {
+Result<Value> ClientCircuit::processOutput(const TransportValue &result,
+                                           size_t pos) {
   if (simulated) {
     return StringError("Called processOutput on simulated client circuit.");
   }
@@ -139,8 +140,8 @@ Result<TransportValue> ClientCircuit::simulatePrepareInput(Value arg,
   return inputTransformers[pos](arg);
 }
 
-Result<Value> ClientCircuit::simulateProcessOutput(TransportValue result,
-                                                   size_t pos) {
+Result<Value>
+ClientCircuit::simulateProcessOutput(const TransportValue &result, size_t pos) {
   if (!simulated) {
     return StringError(
         "Called simulateProcessOutput on encrypted client circuit.");
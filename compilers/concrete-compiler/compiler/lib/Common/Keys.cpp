@@ -10,29 +10,40 @@
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Protocol.h"
+#include "llvm/Support/ErrorHandling.h"
 #include <climits>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <stdlib.h>
 
 using concretelang::csprng::EncryptionCSPRNG;
 using concretelang::csprng::SecretCSPRNG;
+using concretelang::protocol::arrayToProtoPayload;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToSharedVector;
-using concretelang::protocol::vectorToProtoPayload;
+using concretelang::protocol::protoPayloadView;
 
 namespace concretelang {
 namespace keys {
 
-template <typename ProtoKey, typename ProtoKeyInfo, typename Key>
-Message<ProtoKey> keyToProto(const Key &key) {
+template <typename ProtoKey, typename ProtoKeyInfo>
+Message<ProtoKey> keyToProto(const Message<ProtoKeyInfo> &info,
+                             const uint64_t *payload, size_t size) {
   Message<ProtoKey> output;
   auto proto = output.asBuilder();
-  proto.setInfo(key.getInfo().asReader());
-  proto.setPayload(vectorToProtoPayload(key.getTransportBuffer()).asReader());
+  proto.setInfo(info.asReader());
+  proto.setPayload(arrayToProtoPayload(payload, size).asReader());
   return std::move(output);
 }
 
+template <typename ProtoKey, typename ProtoKeyInfo, typename Key>
+Message<ProtoKey> keyToProto(const Key &key) {
+  auto &buffer = key.getTransportBuffer();
+  return keyToProto<ProtoKey, ProtoKeyInfo>(key.getInfo(), buffer.data(),
+                                            buffer.size());
+}
+
 void writeSeed(struct Uint128 seed, std::vector<uint64_t> &buffer) {
   csprng::writeSeed(seed, buffer.data());
 }
@@ -41,6 +52,20 @@ void readSeed(struct Uint128 &seed, std::vector<uint64_t> &buffer) {
   csprng::readSeed(seed, buffer.data());
 }
 
+/// Returns the size of a bootstrap key in the standard domain, a grouping
+/// factor greater than one denoting a multi-bit bootstrap key.
+size_t
+bootstrapKeySize(concreteprotocol::LweBootstrapKeyParams::Reader params) {
+  if (params.getGroupingFactor() > 1)
+    return concrete_cpu_multi_bit_bootstrap_key_size_u64(
+        params.getLevelCount(), params.getGlweDimension(),
+        params.getPolynomialSize(), params.getInputLweDimension(),
+        params.getGroupingFactor());
+  return concrete_cpu_bootstrap_key_size_u64(
+      params.getLevelCount(), params.getGlweDimension(),
+      params.getPolynomialSize(), params.getInputLweDimension());
+}
+
 LweSecretKey::LweSecretKey(Message<concreteprotocol::LweSecretKeyInfo> info,
                            SecretCSPRNG &csprng) {
   // Allocate the buffer
@@ -109,9 +134,16 @@ LweBootstrapKey::LweBootstrapKey(
 
   switch (compression) {
   case concreteprotocol::Compression::NONE:
-    buffer->resize(concrete_cpu_bootstrap_key_size_u64(
-        params.getLevelCount(), params.getGlweDimension(),
-        params.getPolynomialSize(), params.getInputLweDimension()));
+    buffer->resize(bootstrapKeySize(params));
+    if (params.getGroupingFactor() > 1) {
+      concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(
+          buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
+          params.getInputLweDimension(), params.getPolynomialSize(),
+          params.getGlweDimension(), params.getLevelCount(),
+          params.getBaseLog(), params.getGroupingFactor(), params.getVariance(),
+          Parallelism::Rayon, csprng.ptr);
+      break;
+    }
     concrete_cpu_init_lwe_bootstrap_key_u64(
         buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
         params.getInputLweDimension(), params.getPolynomialSize(),
@@ -119,6 +151,10 @@ LweBootstrapKey::LweBootstrapKey(
         params.getVariance(), Parallelism::Rayon, csprng.ptr);
     break;
   case concreteprotocol::Compression::SEED:
+    if (params.getGroupingFactor() > 1) {
+      throw std::invalid_argument(
+          "Unsupported compression type for multi-bit bootstrap key");
+    }
     seededBuffer->resize(concrete_cpu_seeded_bootstrap_key_size_u64(
                              params.getLevelCount(), params.getGlweDimension(),
                              params.getPolynomialSize(),
@@ -162,20 +198,86 @@ LweBootstrapKey::fromProto(concreteprotocol::LweBootstrapKey::Reader reader) {
   return key;
 }
 
+LweBootstrapKey
+LweBootstrapKey::fromProto(concreteprotocol::LweBootstrapKey::Reader reader,
+                           std::shared_ptr<const void> owner) {
+  if (reader.getInfo().getCompression() !=
+      concreteprotocol::Compression::NONE) {
+    return fromProto(reader);
+  }
+  size_t size;
+  auto data = protoPayloadView<uint64_t>(reader.getPayload(), size);
+  if (data == nullptr) {
+    return fromProto(reader);
+  }
+  LweBootstrapKey key(
+      Message<concreteprotocol::LweBootstrapKeyInfo>(reader.getInfo()));
+  key.externalBuffer = std::shared_ptr<const uint64_t>(owner, data);
+  key.externalSize = size;
+  return key;
+}
+
 Message<concreteprotocol::LweBootstrapKey> LweBootstrapKey::toProto() const {
   return keyToProto<concreteprotocol::LweBootstrapKey,
-                    concreteprotocol::LweBootstrapKeyInfo, LweBootstrapKey>(
-      *this);
+                    concreteprotocol::LweBootstrapKeyInfo>(
+      info, getTransportRawPtr(), getTransportSize());
 }
 
 const std::vector<uint64_t> &LweBootstrapKey::getBuffer() {
+  materialize();
   decompress();
   return *buffer;
 }
 
+const uint64_t *LweBootstrapKey::getRawPtr() {
+  if (externalBuffer)
+    return externalBuffer.get();
+  decompress();
+  return buffer->data();
+}
+
+size_t LweBootstrapKey::getSize() {
+  if (externalBuffer)
+    return externalSize;
+  decompress();
+  return buffer->size();
+}
+
+const uint64_t *LweBootstrapKey::getTransportRawPtr() const {
+  switch (info.asReader().getCompression()) {
+  case concreteprotocol::Compression::NONE:
+    return externalBuffer ? externalBuffer.get() : buffer->data();
+  case concreteprotocol::Compression::SEED:
+    assert(!seededBuffer->empty());
+    return seededBuffer->data();
+  default:
+    llvm_unreachable("Unsupported compression type for bootstrap key");
+  }
+}
+
+size_t LweBootstrapKey::getTransportSize() const {
+  switch (info.asReader().getCompression()) {
+  case concreteprotocol::Compression::NONE:
+    return externalBuffer ? externalSize : buffer->size();
+  case concreteprotocol::Compression::SEED:
+    return seededBuffer->size();
+  default:
+    llvm_unreachable("Unsupported compression type for bootstrap key");
+  }
+}
+
+void LweBootstrapKey::materialize() const {
+  if (!externalBuffer)
+    return;
+  const std::lock_guard<std::mutex> guard(*decompress_mutext);
+  if (buffer->empty())
+    buffer->assign(externalBuffer.get(), externalBuffer.get() + externalSize);
+}
+
 const std::vector<uint64_t> &LweBootstrapKey::getTransportBuffer() const {
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
+    materialize();
     return *buffer;
   case concreteprotocol::Compression::SEED:
     assert(!seededBuffer->empty());
@@ -218,6 +320,161 @@ void LweBootstrapKey::decompress() {
   }
 }
 
+FourierLweBootstrapKey::FourierLweBootstrapKey(LweBootstrapKey &standardKey,
+                                               const struct Fft *fft)
+    : info(standardKey.getInfo()), fftLayoutVersion(LAYOUT_VERSION) {
+  auto params = info.asReader().getParams();
+  fftPolynomialSize = params.getPolynomialSize();
+
+  auto fourierBuffer = std::make_shared<std::vector<std::complex<double>>>(
+      standardKey.getSize() / 2);
+  buffer = std::shared_ptr<const std::complex<double>>(fourierBuffer,
+                                                       fourierBuffer->data());
+  size = fourierBuffer->size();
+
+  // Multi-bit keys are converted with the fft plans of the backend
+  if (params.getGroupingFactor() > 1) {
+    concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+        standardKey.getRawPtr(), fourierBuffer->data(), params.getLevelCount(),
+        params.getBaseLog(), params.getGlweDimension(), fftPolynomialSize,
+        params.getInputLweDimension(), params.getGroupingFactor(),
+        Parallelism::Rayon);
+    return;
+  }
+
+  // Build a temporary fft plan if none is given
+  struct Fft *ownedFft = nullptr;
+  if (fft == nullptr) {
+    ownedFft =
+        (struct Fft *)aligned_alloc(CONCRETE_FFT_ALIGN, CONCRETE_FFT_SIZE);
+    concrete_cpu_construct_concrete_fft(ownedFft, fftPolynomialSize);
+    fft = ownedFft;
+  }
+
+  // Allocate scratch for key conversion
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(
+      &scratch_size, &scratch_align, fft);
+  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+  // Convert the bootstrap key to the fourier domain
+  concrete_cpu_bootstrap_key_convert_u64_to_fourier(
+      standardKey.getRawPtr(), fourierBuffer->data(), params.getLevelCount(),
+      params.getBaseLog(), params.getGlweDimension(), fftPolynomialSize,
+      params.getInputLweDimension(), fft, scratch, scratch_size);
+  free(scratch);
+
+  if (ownedFft != nullptr) {
+    concrete_cpu_destroy_concrete_fft(ownedFft);
+    free(ownedFft);
+  }
+}
+
+FourierLweBootstrapKey FourierLweBootstrapKey::fromProto(
+    const Message<concreteprotocol::FourierLweBootstrapKey> &proto) {
+  return fromProto(proto.asReader());
+}
+
+FourierLweBootstrapKey FourierLweBootstrapKey::fromProto(
+    concreteprotocol::FourierLweBootstrapKey::Reader reader) {
+  auto vector =
+      protoPayloadToSharedVector<std::complex<double>>(reader.getPayload());
+  return FourierLweBootstrapKey(
+      std::shared_ptr<const std::complex<double>>(vector, vector->data()),
+      vector->size(),
+      Message<concreteprotocol::LweBootstrapKeyInfo>(reader.getInfo()),
+      reader.getFftPolynomialSize(), reader.getFftLayoutVersion());
+}
+
+FourierLweBootstrapKey FourierLweBootstrapKey::fromProto(
+    concreteprotocol::FourierLweBootstrapKey::Reader reader,
+    std::shared_ptr<const void> owner) {
+  size_t size;
+  auto data = protoPayloadView<std::complex<double>>(reader.getPayload(), size);
+  if (data == nullptr) {
+    return fromProto(reader);
+  }
+  return FourierLweBootstrapKey(
+      std::shared_ptr<const std::complex<double>>(owner, data), size,
+      Message<concreteprotocol::LweBootstrapKeyInfo>(reader.getInfo()),
+      reader.getFftPolynomialSize(), reader.getFftLayoutVersion());
+}
+
+Message<concreteprotocol::FourierLweBootstrapKey>
+FourierLweBootstrapKey::toProto() const {
+  Message<concreteprotocol::FourierLweBootstrapKey> output;
+  auto proto = output.asBuilder();
+  proto.setInfo(info.asReader());
+  proto.setFftPolynomialSize(fftPolynomialSize);
+  proto.setFftLayoutVersion(fftLayoutVersion);
+  proto.setPayload(arrayToProtoPayload(buffer.get(), size).asReader());
+  return std::move(output);
+}
+
+const Message<concreteprotocol::LweBootstrapKeyInfo> &
+FourierLweBootstrapKey::getInfo() const {
+  return this->info;
+}
+
+/// Returns true if the two moduli are the same.
+bool sameModulus(concreteprotocol::Modulus::Reader lhs,
+                 concreteprotocol::Modulus::Reader rhs) {
+  auto lhsMod = lhs.getMod();
+  auto rhsMod = rhs.getMod();
+  if (lhsMod.which() != rhsMod.which())
+    return false;
+  switch (lhsMod.which()) {
+  case concreteprotocol::Modulus::Mod::POWER_OF_TWO:
+    return lhsMod.getPowerOfTwo().getPower() ==
+           rhsMod.getPowerOfTwo().getPower();
+  case concreteprotocol::Modulus::Mod::INTEGER:
+    return lhsMod.getInteger().getModulus() == rhsMod.getInteger().getModulus();
+  default:
+    return true;
+  }
+}
+
+/// Returns true if two bootstrap keys are built from the same secret keys and
+/// parameters. The compression is not compared, as it does not change the key
+/// once decompressed.
+bool sameBootstrapKey(concreteprotocol::LweBootstrapKeyInfo::Reader lhs,
+                      concreteprotocol::LweBootstrapKeyInfo::Reader rhs) {
+  auto lhsParams = lhs.getParams();
+  auto rhsParams = rhs.getParams();
+  return lhs.getId() == rhs.getId() && lhs.getInputId() == rhs.getInputId() &&
+         lhs.getOutputId() == rhs.getOutputId() &&
+         lhsParams.getLevelCount() == rhsParams.getLevelCount() &&
+         lhsParams.getBaseLog() == rhsParams.getBaseLog() &&
+         lhsParams.getGlweDimension() == rhsParams.getGlweDimension() &&
+         lhsParams.getPolynomialSize() == rhsParams.getPolynomialSize() &&
+         lhsParams.getInputLweDimension() == rhsParams.getInputLweDimension() &&
+         lhsParams.getVariance() == rhsParams.getVariance() &&
+         lhsParams.getIntegerPrecision() == rhsParams.getIntegerPrecision() &&
+         sameModulus(lhsParams.getModulus(), rhsParams.getModulus()) &&
+         lhsParams.getKeyType() == rhsParams.getKeyType() &&
+         lhsParams.getGroupingFactor() == rhsParams.getGroupingFactor();
+}
+
+bool FourierLweBootstrapKey::isUsableFor(
+    const Message<concreteprotocol::LweBootstrapKeyInfo> &standardInfo) const {
+  auto params = standardInfo.asReader().getParams();
+  auto expectedSize = bootstrapKeySize(params) / 2;
+  // Classic and multi-bit keys have different fourier layouts.
+  return fftLayoutVersion == LAYOUT_VERSION &&
+         fftPolynomialSize == params.getPolynomialSize() &&
+         info.asReader().getParams().getGroupingFactor() ==
+             params.getGroupingFactor() &&
+         size == expectedSize &&
+         sameBootstrapKey(info.asReader(), standardInfo.asReader());
+}
+
+const std::complex<double> *FourierLweBootstrapKey::getRawPtr() const {
+  return this->buffer.get();
+}
+
+size_t FourierLweBootstrapKey::getSize() const { return this->size; }
+
 LweKeyswitchKey::LweKeyswitchKey(
     Message<concreteprotocol::LweKeyswitchKeyInfo> info,
     const LweSecretKey &inputKey, const LweSecretKey &outputKey,
@@ -285,10 +542,29 @@ LweKeyswitchKey::fromProto(concreteprotocol::LweKeyswitchKey::Reader reader) {
   return key;
 }
 
+LweKeyswitchKey
+LweKeyswitchKey::fromProto(concreteprotocol::LweKeyswitchKey::Reader reader,
+                           std::shared_ptr<const void> owner) {
+  if (reader.getInfo().getCompression() !=
+      concreteprotocol::Compression::NONE) {
+    return fromProto(reader);
+  }
+  size_t size;
+  auto data = protoPayloadView<uint64_t>(reader.getPayload(), size);
+  if (data == nullptr) {
+    return fromProto(reader);
+  }
+  LweKeyswitchKey key(
+      Message<concreteprotocol::LweKeyswitchKeyInfo>(reader.getInfo()));
+  key.externalBuffer = std::shared_ptr<const uint64_t>(owner, data);
+  key.externalSize = size;
+  return key;
+}
+
 Message<concreteprotocol::LweKeyswitchKey> LweKeyswitchKey::toProto() const {
   return keyToProto<concreteprotocol::LweKeyswitchKey,
-                    concreteprotocol::LweKeyswitchKeyInfo, LweKeyswitchKey>(
-      *this);
+                    concreteprotocol::LweKeyswitchKeyInfo>(
+      info, getTransportRawPtr(), getTransportSize());
 }
 
 const Message<concreteprotocol::LweKeyswitchKeyInfo> &
@@ -297,13 +573,60 @@ LweKeyswitchKey::getInfo() const {
 }
 
 const std::vector<uint64_t> &LweKeyswitchKey::getBuffer() {
+  materialize();
   decompress();
   return *buffer;
 }
 
+const uint64_t *LweKeyswitchKey::getRawPtr() {
+  if (externalBuffer)
+    return externalBuffer.get();
+  decompress();
+  return buffer->data();
+}
+
+size_t LweKeyswitchKey::getSize() {
+  if (externalBuffer)
+    return externalSize;
+  decompress();
+  return buffer->size();
+}
+
+const uint64_t *LweKeyswitchKey::getTransportRawPtr() const {
+  switch (info.asReader().getCompression()) {
+  case concreteprotocol::Compression::NONE:
+    return externalBuffer ? externalBuffer.get() : buffer->data();
+  case concreteprotocol::Compression::SEED:
+    assert(!seededBuffer->empty());
+    return seededBuffer->data();
+  default:
+    llvm_unreachable("Unsupported compression type for keyswitch key");
+  }
+}
+
+size_t LweKeyswitchKey::getTransportSize() const {
+  switch (info.asReader().getCompression()) {
+  case concreteprotocol::Compression::NONE:
+    return externalBuffer ? externalSize : buffer->size();
+  case concreteprotocol::Compression::SEED:
+    return seededBuffer->size();
+  default:
+    llvm_unreachable("Unsupported compression type for keyswitch key");
+  }
+}
+
+void LweKeyswitchKey::materialize() const {
+  if (!externalBuffer)
+    return;
+  const std::lock_guard<std::mutex> guard(*decompress_mutext);
+  if (buffer->empty())
+    buffer->assign(externalBuffer.get(), externalBuffer.get() + externalSize);
+}
+
 const std::vector<uint64_t> &LweKeyswitchKey::getTransportBuffer() const {
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
+    materialize();
     return *buffer;
   case concreteprotocol::Compression::SEED:
     assert(!seededBuffer->empty());
@@ -5,12 +5,14 @@
 
 #include "concretelang/Common/Keysets.h"
 #include "capnp/message.h"
+#include "capnp/serialize.h"
 #include "concrete-cpu.h"
 #include "concrete-optimizer.hpp"
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keys.h"
+#include "concretelang/Common/Parallel.h"
 #include "concretelang/Common/Security.h"
 #include "kj/common.h"
 #include "kj/io.h"
@@ -19,9 +21,13 @@
 #include "llvm/Support/Path.h"
 #include <errno.h>
 #include <fcntl.h>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <stdlib.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -29,6 +35,7 @@ using concretelang::csprng::EncryptionCSPRNG;
 using concretelang::csprng::SecretCSPRNG;
 using concretelang::error::Result;
 using concretelang::error::StringError;
+using concretelang::keys::FourierLweBootstrapKey;
 using concretelang::keys::LweBootstrapKey;
 using concretelang::keys::LweKeyswitchKey;
 using concretelang::keys::LweSecretKey;
@@ -88,6 +95,11 @@ ServerKeyset::fromProto(concreteprotocol::ServerKeyset::Reader reader) {
         PackingKeyswitchKey::fromProto(pkskProto));
   }
 
+  for (auto fbskProto : reader.getFourierLweBootstrapKeys()) {
+    output.fourierLweBootstrapKeys.push_back(
+        FourierLweBootstrapKey::fromProto(fbskProto));
+  }
+
   return output;
 }
 
@@ -111,9 +123,34 @@ Message<concreteprotocol::ServerKeyset> ServerKeyset::toProto() const {
         i, packingKeyswitchKeys[i].toProto().asReader());
   }
 
+  output.asBuilder().initFourierLweBootstrapKeys(
+      fourierLweBootstrapKeys.size());
+  for (size_t i = 0; i < fourierLweBootstrapKeys.size(); i++) {
+    output.asBuilder().getFourierLweBootstrapKeys().setWithCaveats(
+        i, fourierLweBootstrapKeys[i].toProto().asReader());
+  }
+
   return output;
 }
 
+const FourierLweBootstrapKey *
+ServerKeyset::getFourierBootstrapKey(size_t index) const {
+  auto &info = lweBootstrapKeys[index].getInfo();
+  for (auto &fbsk : fourierLweBootstrapKeys) {
+    if (fbsk.isUsableFor(info))
+      return &fbsk;
+  }
+  return nullptr;
+}
+
+void ServerKeyset::precomputeFourierBootstrapKeys() {
+  for (size_t i = 0; i < lweBootstrapKeys.size(); i++) {
+    if (getFourierBootstrapKey(i) == nullptr)
+      fourierLweBootstrapKeys.push_back(
+          FourierLweBootstrapKey(lweBootstrapKeys[i], nullptr));
+  }
+}
+
 Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
                SecretCSPRNG &secretCsprng, EncryptionCSPRNG &encryptionCsprng,
                std::map<uint32_t, LweSecretKey> lweSecretKeys) {
@@ -131,23 +168,66 @@ Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
           (Message<concreteprotocol::LweSecretKeyInfo>)keyInfo, secretCsprng));
     }
   }
-  for (auto keyInfo : info.asReader().getLweBootstrapKeys()) {
-    server.lweBootstrapKeys.push_back(LweBootstrapKey(
-        (Message<concreteprotocol::LweBootstrapKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
-  }
-  for (auto keyInfo : info.asReader().getLweKeyswitchKeys()) {
-    server.lweKeyswitchKeys.push_back(LweKeyswitchKey(
-        (Message<concreteprotocol::LweKeyswitchKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
-  }
-  for (auto keyInfo : info.asReader().getPackingKeyswitchKeys()) {
-    server.packingKeyswitchKeys.push_back(PackingKeyswitchKey(
-        (Message<concreteprotocol::PackingKeyswitchKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
+  // The evaluation keys are independent from each other, so they are
+  // generated concurrently. Each key gets its own generator, forked in the
+  // order of the keys, so that the keys do not depend on the scheduling.
+  auto bskInfos = info.asReader().getLweBootstrapKeys();
+  auto kskInfos = info.asReader().getLweKeyswitchKeys();
+  auto pkskInfos = info.asReader().getPackingKeyswitchKeys();
+  size_t numKeys = bskInfos.size() + kskInfos.size() + pkskInfos.size();
+  std::vector<EncryptionCSPRNG> csprngs;
+  csprngs.reserve(numKeys);
+  for (size_t i = 0; i < numKeys; i++) {
+    csprngs.push_back(encryptionCsprng.fork());
+  }
+  auto bskCsprngs = csprngs.begin();
+  auto kskCsprngs = bskCsprngs + bskInfos.size();
+  auto pkskCsprngs = kskCsprngs + kskInfos.size();
+
+  std::vector<std::optional<LweBootstrapKey>> bsks(bskInfos.size());
+  std::vector<std::optional<LweKeyswitchKey>> ksks(kskInfos.size());
+  std::vector<std::optional<PackingKeyswitchKey>> pksks(pkskInfos.size());
+  std::vector<std::function<void()>> tasks;
+  // Bootstrap keys go first as they are the longest to generate.
+  for (size_t i = 0; i < bskInfos.size(); i++) {
+    tasks.push_back([&, i]() {
+      auto keyInfo = bskInfos[i];
+      bsks[i].emplace((Message<concreteprotocol::LweBootstrapKeyInfo>)keyInfo,
+                      client.lweSecretKeys[keyInfo.getInputId()],
+                      client.lweSecretKeys[keyInfo.getOutputId()],
+                      bskCsprngs[i]);
+    });
+  }
+  for (size_t i = 0; i < kskInfos.size(); i++) {
+    tasks.push_back([&, i]() {
+      auto keyInfo = kskInfos[i];
+      ksks[i].emplace((Message<concreteprotocol::LweKeyswitchKeyInfo>)keyInfo,
+                      client.lweSecretKeys[keyInfo.getInputId()],
+                      client.lweSecretKeys[keyInfo.getOutputId()],
+                      kskCsprngs[i]);
+    });
+  }
+  for (size_t i = 0; i < pkskInfos.size(); i++) {
+    tasks.push_back([&, i]() {
+      auto keyInfo = pkskInfos[i];
+      pksks[i].emplace(
+          (Message<concreteprotocol::PackingKeyswitchKeyInfo>)keyInfo,
+          client.lweSecretKeys[keyInfo.getInputId()],
+          client.lweSecretKeys[keyInfo.getOutputId()], pkskCsprngs[i]);
+    });
+  }
+  parallel::parallelFor(tasks.size(),
+                        parallel::getNumThreads("CONCRETE_KEYGEN_NUM_THREADS"),
+                        [&](size_t i) { tasks[i](); });
+
+  for (auto &bsk : bsks) {
+    server.lweBootstrapKeys.push_back(std::move(*bsk));
+  }
+  for (auto &ksk : ksks) {
+    server.lweKeyswitchKeys.push_back(std::move(*ksk));
+  }
+  for (auto &pksk : pksks) {
+    server.packingKeyswitchKeys.push_back(std::move(*pksk));
   }
 }
 
@@ -184,6 +264,13 @@ Message<concreteprotocol::Keyset> Keyset::toProto() const {
     serverKeyset.getPackingKeyswitchKeys().setWithCaveats(
         i, server.packingKeyswitchKeys[i].toProto().asReader());
   }
+
+  serverKeyset.initFourierLweBootstrapKeys(
+      server.fourierLweBootstrapKeys.size());
+  for (size_t i = 0; i < server.fourierLweBootstrapKeys.size(); i++) {
+    serverKeyset.getFourierLweBootstrapKeys().setWithCaveats(
+        i, server.fourierLweBootstrapKeys[i].toProto().asReader());
+  }
   // client serialization is not inlined as keys aren't that big
   auto clientProto = client.toProto();
   output.asBuilder().setClient(clientProto.asReader());
@@ -202,6 +289,50 @@ Result<Message<ProtoKey>> loadKeyProto(std::string path) {
   return keyBlob;
 }
 
+/// A key file mapped read-only in memory, along with the reader of the message
+/// it holds. Keys built from the reader must keep the mapping alive.
+struct MappedKeyFile {
+  void *addr = MAP_FAILED;
+  size_t size = 0;
+  std::unique_ptr<capnp::FlatArrayMessageReader> reader;
+
+  ~MappedKeyFile() {
+    reader.reset();
+    if (addr != MAP_FAILED)
+      munmap(addr, size);
+  }
+};
+
+Result<std::shared_ptr<MappedKeyFile>> mapKeyFile(std::string path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return StringError("Cannot open key at path " + path +
+                       " Error: " + strerror(errno));
+  }
+  auto mapped = std::make_shared<MappedKeyFile>();
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    mapped->size = st.st_size;
+    mapped->addr =
+        mmap(nullptr, mapped->size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapped->addr == MAP_FAILED) {
+    return StringError("Cannot map key at path " + path +
+                       " Error: " + strerror(errno));
+  }
+  try {
+    mapped->reader = std::make_unique<capnp::FlatArrayMessageReader>(
+        kj::arrayPtr(reinterpret_cast<const capnp::word *>(mapped->addr),
+                     mapped->size / sizeof(capnp::word)),
+        KEY_READER_OPTS);
+  } catch (const kj::Exception &e) {
+    return StringError("Failed to read key at path " + path + ": ")
+           << e.getDescription().cStr();
+  }
+  return mapped;
+}
+
 template <typename ProtoKey, typename Key>
 Result<Key> loadKey(std::string path) {
   Message<ProtoKey> proto;
@@ -209,6 +340,61 @@ Result<Key> loadKey(std::string path) {
   return Key::fromProto(keyProto);
 }
 
+/// Loads the key stored at `path` from a read-only mapping of the file. Keys
+/// that are not compressed point into the mapped pages instead of being
+/// copied, so that processes loading the same keys share their memory.
+template <typename ProtoKey, typename Key>
+Result<Key> loadMappedKey(std::string path) {
+  OUTCOME_TRY(auto mapped, mapKeyFile(path));
+  try {
+    return Key::fromProto(mapped->reader->getRoot<ProtoKey>(), mapped);
+  } catch (const kj::Exception &e) {
+    return StringError("Failed to read key at path " + path + ": ")
+           << e.getDescription().cStr();
+  }
+}
+
+/// Returns true unless mapping the key files of the cache has been disabled by
+/// setting `CONCRETE_KEYSET_CACHE_MMAP` to 0, e.g. for file systems that do not
+/// support it.
+bool useMappedKeyFiles() {
+  char *env = getenv("CONCRETE_KEYSET_CACHE_MMAP");
+  return env == nullptr || strtoul(env, NULL, 10) != 0;
+}
+
+/// Loads an evaluation key of the cache, mapping its file if enabled.
+template <typename ProtoKey, typename Key>
+Result<Key> loadEvaluationKey(std::string path) {
+  if (useMappedKeyFiles())
+    return loadMappedKey<ProtoKey, Key>(path);
+  return loadKey<ProtoKey, Key>(path);
+}
+
+/// Loads the fourier form of a bootstrap key stored at `path`. Returns nothing
+/// if the key is missing or not usable for `info`, in which case the standard
+/// key gets converted by the runtime, and an error if the file is invalid.
+Result<std::optional<FourierLweBootstrapKey>> loadFourierBootstrapKey(
+    std::string path,
+    const Message<concreteprotocol::LweBootstrapKeyInfo> &info) {
+  if (!llvm::sys::fs::exists(path))
+    return std::optional<FourierLweBootstrapKey>();
+  OUTCOME_TRY(auto key,
+              loadEvaluationKey<concreteprotocol::FourierLweBootstrapKey,
+                                FourierLweBootstrapKey>(path));
+  if (!key.isUsableFor(info))
+    return std::optional<FourierLweBootstrapKey>();
+  return std::optional<FourierLweBootstrapKey>(key);
+}
+
+/// Returns true if the keyset cache should store the fourier form of the
+/// bootstrap keys it generates, which is enabled by setting
+/// `CONCRETE_KEYSET_CACHE_FOURIER_KEYS` to 1. It avoids the conversion when
+/// loading the keys, at the price of twice the disk space.
+bool useFourierKeyFiles() {
+  char *env = getenv("CONCRETE_KEYSET_CACHE_FOURIER_KEYS");
+  return env != nullptr && strtoul(env, NULL, 10) != 0;
+}
+
 template <typename ProtoKey>
 Result<void> saveKeyProto(Message<ProtoKey> keyProto, std::string path) {
   std::ofstream out((std::string)path, std::ofstream::binary);
@@ -246,6 +432,7 @@ loadKeysFromFiles(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
   std::vector<LweBootstrapKey> bootstrapKeys;
   std::vector<LweKeyswitchKey> keyswitchKeys;
   std::vector<PackingKeyswitchKey> packingKeyswitchKeys;
+  std::vector<FourierLweBootstrapKey> fourierBootstrapKeys;
 
   // Load secret keys
   for (auto keyInfo : keysetInfo.asReader().getLweSecretKeys()) {
@@ -265,9 +452,17 @@ loadKeysFromFiles(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
     llvm::SmallString<0> path(folderPath);
     llvm::sys::path::append(path, "pbsKey_" + std::to_string(keyInfo.getId()));
     OUTCOME_TRY(auto key,
-                loadKey<concreteprotocol::LweBootstrapKey, LweBootstrapKey>(
-                    (std::string)path));
+                loadEvaluationKey<concreteprotocol::LweBootstrapKey,
+                                  LweBootstrapKey>((std::string)path));
     bootstrapKeys.push_back(key);
+    // Load its fourier form if the cache entry has one
+    llvm::SmallString<0> fourierPath(folderPath);
+    llvm::sys::path::append(fourierPath, "fourierPbsKey_" +
+                                             std::to_string(keyInfo.getId()));
+    OUTCOME_TRY(auto fourierKey, loadFourierBootstrapKey(
+                                     (std::string)fourierPath, key.getInfo()));
+    if (fourierKey.has_value())
+      fourierBootstrapKeys.push_back(*fourierKey);
   }
   // Load keyswitch keys
   for (auto keyInfo : keysetInfo.asReader().getLweKeyswitchKeys()) {
@@ -276,8 +471,8 @@ loadKeysFromFiles(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
     llvm::SmallString<0> path(folderPath);
     llvm::sys::path::append(path, "ksKey_" + std::to_string(keyInfo.getId()));
     OUTCOME_TRY(auto key,
-                loadKey<concreteprotocol::LweKeyswitchKey, LweKeyswitchKey>(
-                    (std::string)path));
+                loadEvaluationKey<concreteprotocol::LweKeyswitchKey,
+                                  LweKeyswitchKey>((std::string)path));
     keyswitchKeys.push_back(key);
   }
   // Load packing keyswitch keys
@@ -294,8 +489,8 @@ loadKeysFromFiles(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
   }
 
   ClientKeyset clientKeyset = ClientKeyset{secretKeys};
-  ServerKeyset serverKeyset =
-      ServerKeyset{bootstrapKeys, keyswitchKeys, packingKeyswitchKeys};
+  ServerKeyset serverKeyset = ServerKeyset{
+      bootstrapKeys, keyswitchKeys, packingKeyswitchKeys, fourierBootstrapKeys};
   Keyset keyset = Keyset{serverKeyset, clientKeyset};
 
   return keyset;
@@ -326,13 +521,23 @@ Result<void> saveKeys(Keyset &keyset, llvm::SmallString<0> &folderPath) {
     OUTCOME_TRYV(saveKey<concreteprotocol::LweSecretKey, LweSecretKey>(
         key, path.c_str()));
   }
-  // Save bootstrap keys
-  for (auto key : serverKeyset.lweBootstrapKeys) {
+  // Save bootstrap keys, along with the fourier form the keyset holds for
+  // them, if any, so that loading them does not require a conversion
+  for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
+    auto key = serverKeyset.lweBootstrapKeys[i];
+    auto id = std::to_string(key.getInfo().asReader().getId());
     llvm::SmallString<0> path = folderIncompletePath;
-    llvm::sys::path::append(
-        path, "pbsKey_" + std::to_string(key.getInfo().asReader().getId()));
+    llvm::sys::path::append(path, "pbsKey_" + id);
     OUTCOME_TRYV(saveKey<concreteprotocol::LweBootstrapKey, LweBootstrapKey>(
         key, path.c_str()));
+    auto fourierKey = serverKeyset.getFourierBootstrapKey(i);
+    if (fourierKey == nullptr)
+      continue;
+    llvm::SmallString<0> fourierPath = folderIncompletePath;
+    llvm::sys::path::append(fourierPath, "fourierPbsKey_" + id);
+    OUTCOME_TRYV(saveKey<concreteprotocol::FourierLweBootstrapKey,
+                         FourierLweBootstrapKey>(*fourierKey,
+                                                 fourierPath.c_str()));
   }
   // Save keyswitch keys
   for (auto key : serverKeyset.lweKeyswitchKeys) {
@@ -450,6 +655,8 @@ KeysetCache::getKeyset(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
   auto encryptionCsprng = csprng::EncryptionCSPRNG(encryption_seed);
   auto secretCsprng = csprng::SecretCSPRNG(secret_seed);
   Keyset keyset(keysetInfo, secretCsprng, encryptionCsprng, lweSecretKeys);
+  if (useFourierKeyFiles())
+    keyset.server.precomputeFourierBootstrapKeys();
 
   OUTCOME_TRYV(saveKeys(keyset, folderPath));
 
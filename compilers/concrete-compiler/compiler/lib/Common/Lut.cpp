@@ -0,0 +1,53 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <assert.h>
+
+#include "concretelang/Common/Lut.h"
+
+namespace concretelang {
+namespace lut {
+
+void encodeExpandForBootstrap(const uint64_t *input, size_t inputSize,
+                              uint64_t *output, size_t outputSize,
+                              uint32_t outputBits, bool isSigned) {
+  size_t megaCaseSize = outputSize / inputSize;
+
+  assert((megaCaseSize % 2) == 0);
+
+  // When the bootstrap is executed on encrypted signed integers, the lut must
+  // be half-rotated. This map takes care about properly indexing into the input
+  // lut depending on what bootstrap gets executed.
+  size_t halfInputSize = inputSize / 2;
+  auto encoded = [&](size_t idx) -> uint64_t {
+    if (isSigned)
+      idx = idx < halfInputSize ? idx + halfInputSize : idx - halfInputSize;
+    return input[idx] << (64 - outputBits - 1);
+  };
+
+  // The first lut value should be centered over zero. This means that half of
+  // it should appear at the beginning of the output lut, and half of it at the
+  // end (but negated).
+  for (size_t idx = 0; idx < megaCaseSize / 2; ++idx) {
+    output[idx] = encoded(0);
+  }
+  for (size_t idx = (inputSize - 1) * megaCaseSize + megaCaseSize / 2;
+       idx < outputSize; ++idx) {
+    output[idx] = -encoded(0);
+  }
+
+  // Treats the other lut values.
+  for (size_t lutIdx = 1; lutIdx < inputSize; ++lutIdx) {
+    uint64_t lutValue = encoded(lutIdx);
+    size_t start = megaCaseSize * (lutIdx - 1) + megaCaseSize / 2;
+    for (size_t outputIdx = start; outputIdx < start + megaCaseSize;
+         ++outputIdx) {
+      output[outputIdx] = lutValue;
+    }
+  }
+}
+
+} // namespace lut
+} // namespace concretelang
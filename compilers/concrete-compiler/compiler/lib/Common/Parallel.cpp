@@ -0,0 +1,59 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "concretelang/Common/Parallel.h"
+
+namespace concretelang {
+namespace parallel {
+
+size_t getNumThreads(const char *envVar) {
+  char *env = getenv(envVar);
+  if (env != nullptr) {
+    size_t numThreads = strtoul(env, NULL, 10);
+    if (numThreads > 0)
+      return numThreads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void parallelFor(size_t size, size_t numThreads,
+                 const std::function<void(size_t)> &body) {
+  std::atomic<size_t> next{0};
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto worker = [&]() {
+    for (size_t i = next++; i < size; i = next++) {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(errorMutex);
+        if (!error)
+          error = std::current_exception();
+        next = size;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(numThreads, size); t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace parallel
+} // namespace concretelang
@@ -11,14 +11,19 @@
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/Parallel.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/simulation.h"
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdlib.h>
 #include <string>
 
 using concretelang::error::Result;
+using concretelang::keys::LweSecretKey;
 using concretelang::keysets::ClientKeyset;
+using concretelang::protocol::writeArrayToProtoPayload;
 using concretelang::values::getCorrespondingPrecision;
 using concretelang::values::Tensor;
 using concretelang::values::TransportValue;
@@ -37,6 +42,18 @@ typedef std::function<Result<void>(const TransportValue &)>
 /// A private type for transformers working purely on values.
 typedef std::function<Value(Value)> Transformer;
 
+/// A private type for the stages of the client input pipeline, working on raw
+/// buffers so that they can be chained without intermediate values. A stage
+/// turns each of the `size` words at `input` into `wordsPerInput` words at
+/// `output`.
+struct InputStage {
+  size_t wordsPerInput;
+  /// Whether the words of an input make a new innermost dimension.
+  bool addsDimension;
+  std::function<void(const uint64_t *input, size_t size, uint64_t *output)>
+      run;
+};
+
 Result<ValueVerifier> getIndexInputValueVerifier(
     const Message<concreteprotocol::GateInfo> &gateInfo) {
   if (!gateInfo.asReader().getTypeInfo().hasIndex()) {
@@ -295,38 +312,26 @@ Result<TransportValueVerifier> getTransportValueVerifier(
   };
 }
 
-Result<Transformer> getBooleanEncodingTransformer() {
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = inputTensor.values[i] << 61;
-    }
-
-    return Value{outputTensor};
-  };
+Result<InputStage> getBooleanEncodingStage() {
+  return InputStage{1, false,
+                    [](const uint64_t *input, size_t size, uint64_t *output) {
+                      for (size_t i = 0; i < size; i++) {
+                        output[i] = input[i] << 61;
+                      }
+                    }};
 }
 
-Result<Transformer> getNativeModeIntegerEncodingTransformer(
+Result<InputStage> getNativeModeIntegerEncodingStage(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto width = info.asReader().getWidth();
-  auto isSigned = info.asReader().getIsSigned();
-
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = inputTensor.values[i] << (64 - (width + 1));
-    }
-    return Value{outputTensor};
-  };
+  return InputStage{
+      1, false, [=](const uint64_t *input, size_t size, uint64_t *output) {
+        auto lock = csprng->lock();
+        for (size_t i = 0; i < size; i++) {
+          output[i] = input[i] << (64 - (width + 1));
+        }
+      }};
 }
 
 Result<Transformer> getNativeModeIntegerDecodingTransformer(
@@ -335,11 +340,11 @@ Result<Transformer> getNativeModeIntegerDecodingTransformer(
   auto isSigned = info.asReader().getIsSigned();
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    // The plaintexts are decoded in place.
+    auto tensor = input.getTensorPtr<uint64_t>();
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto input = inputTensor.values[i];
+    for (size_t i = 0; i < tensor->values.size(); i++) {
+      auto input = tensor->values[i];
 
       // Decode unsigned integer
       uint64_t output = input >> (64 - precision - 2);
@@ -358,51 +363,35 @@ Result<Transformer> getNativeModeIntegerDecodingTransformer(
         };
       }
 
-      outputTensor.values[i] = output;
+      tensor->values[i] = output;
     }
 
-    Value output;
     if (isSigned) {
-      auto signedOutputTensor = (Tensor<int64_t>)outputTensor;
-      output = Value{signedOutputTensor};
-    } else {
-      output = Value{outputTensor};
+      return Value{(Tensor<int64_t>)*tensor};
     }
-
-    return output;
+    return input;
   };
 }
 
-Result<Transformer> getChunkedModeIntegerEncodingTransformer(
+Result<InputStage> getChunkedModeIntegerEncodingStage(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
-  auto size = info.asReader().getMode().getChunked().getSize();
+  auto chunkSize = info.asReader().getMode().getChunked().getSize();
   auto chunkWidth = info.asReader().getMode().getChunked().getWidth();
-  auto isSigned = info.asReader().getIsSigned();
   uint64_t mask = (1 << chunkWidth) - 1;
 
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(size);
-    outputTensor.values.resize(outputTensor.values.size() * size);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto value = inputTensor.values[i];
-      for (size_t j = 0; j < size; j++) {
-        auto chunk = value & mask;
-        outputTensor.values[i * size + j] = ((uint64_t)chunk)
-                                            << (64 - (chunkWidth + 1));
-        value >>= chunkWidth;
-      }
-    }
-
-    return Value{outputTensor};
-  };
+  return InputStage{
+      chunkSize, true,
+      [=](const uint64_t *input, size_t size, uint64_t *output) {
+        for (size_t i = 0; i < size; i++) {
+          auto value = input[i];
+          for (size_t j = 0; j < chunkSize; j++) {
+            auto chunk = value & mask;
+            output[i * chunkSize + j] = ((uint64_t)chunk)
+                                        << (64 - (chunkWidth + 1));
+            value >>= chunkWidth;
+          }
+        }
+      }};
 }
 
 Result<Transformer> getChunkedModeIntegerDecodingTransformer(
@@ -413,15 +402,16 @@ Result<Transformer> getChunkedModeIntegerDecodingTransformer(
   uint64_t mask = (1 << chunkWidth) - 1;
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    auto inputTensor = input.getTensorPtr<uint64_t>();
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = inputTensor->dimensions;
     outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / chunkSize);
+    outputTensor.values.resize(inputTensor->values.size() / chunkSize);
 
     for (size_t i = 0; i < outputTensor.values.size(); i++) {
       uint64_t output = 0;
       for (size_t j = 0; j < chunkSize; j++) {
-        auto input = inputTensor.values[i * chunkSize + j];
+        auto input = inputTensor->values[i * chunkSize + j];
 
         // Decode unsigned integer
         uint64_t chunkOutput = input >> (64 - chunkWidth - 2);
@@ -458,37 +448,25 @@ Result<Transformer> getChunkedModeIntegerDecodingTransformer(
   };
 }
 
-Result<Transformer> getCrtModeIntegerEncodingTransformer(
+Result<InputStage> getCrtModeIntegerEncodingStage(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   std::vector<int64_t> moduli;
   for (auto modulus : info.asReader().getMode().getCrt().getModuli()) {
     moduli.push_back(modulus);
   }
-  auto size = info.asReader().getMode().getCrt().getModuli().size();
+  size_t numModuli = moduli.size();
   auto productOfModuli = concretelang::crt::productOfModuli(moduli);
-  auto isSigned = info.asReader().getIsSigned();
-
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(size);
-    outputTensor.values.resize(outputTensor.values.size() * size);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto value = inputTensor.values[i];
-      for (size_t j = 0; j < (size_t)size; j++) {
-        outputTensor.values[i * size + j] =
-            concretelang::crt::encode(value, moduli[j], productOfModuli);
-      }
-    }
 
-    return Value{outputTensor};
-  };
+  return InputStage{
+      numModuli, true,
+      [=](const uint64_t *input, size_t size, uint64_t *output) {
+        for (size_t i = 0; i < size; i++) {
+          for (size_t j = 0; j < numModuli; j++) {
+            output[i * numModuli + j] =
+                concretelang::crt::encode(input[i], moduli[j], productOfModuli);
+          }
+        }
+      }};
 }
 
 Result<Transformer> getCrtModeIntegerDecodingTransformer(
@@ -503,15 +481,16 @@ Result<Transformer> getCrtModeIntegerDecodingTransformer(
   auto isSigned = info.asReader().getIsSigned();
 
   return [=](Value input) mutable {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    auto inputTensor = input.getTensorPtr<uint64_t>();
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = inputTensor->dimensions;
     outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / size);
+    outputTensor.values.resize(inputTensor->values.size() / size);
 
     for (size_t i = 0; i < outputTensor.values.size(); i++) {
       for (size_t j = 0; j < (size_t)size; j++) {
         remainders[j] =
-            crt::decode(inputTensor.values[i * size + j], moduli[j]);
+            crt::decode(inputTensor->values[i * size + j], moduli[j]);
       }
 
       // Compute the inverse crt
@@ -543,101 +522,149 @@ Result<Transformer> getCrtModeIntegerDecodingTransformer(
   };
 }
 
-Result<Transformer> getEncryptionTransformer(
-    ClientKeyset keyset,
+/// The number of ciphertexts encrypted or decrypted by a task of the parallel
+/// transformers. It does not depend on the number of threads, so that neither
+/// do the generators forked for the tasks.
+const size_t CIPHERTEXTS_PER_TASK = 64;
+
+/// Calls `body(taskId, begin, end)` on the consecutive ranges of
+/// `CIPHERTEXTS_PER_TASK` ciphertexts out of `size`, in parallel if there is
+/// more than one range.
+void forEachCiphertextRange(
+    size_t size, const std::function<void(size_t, size_t, size_t)> &body) {
+  size_t numTasks = (size + CIPHERTEXTS_PER_TASK - 1) / CIPHERTEXTS_PER_TASK;
+  auto task = [&](size_t taskId) {
+    size_t begin = taskId * CIPHERTEXTS_PER_TASK;
+    body(taskId, begin, std::min(begin + CIPHERTEXTS_PER_TASK, size));
+  };
+  if (numTasks <= 1) {
+    task(0);
+    return;
+  }
+  parallel::parallelFor(
+      numTasks, parallel::getNumThreads("CONCRETE_CLIENT_NUM_THREADS"), task);
+}
+
+Result<InputStage> getEncryptionStage(
+    const LweSecretKey &key,
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
 
-  auto key = keyset.lweSecretKeys[info.asReader().getKeyId()];
   auto lweDimension = info.asReader().getLweDimension();
   auto lweSize = lweDimension + 1;
   auto variance = info.asReader().getVariance();
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(lweSize);
-    outputTensor.values.resize(outputTensor.values.size() * lweSize);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      concrete_cpu_encrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &outputTensor.values[i * lweSize],
-          inputTensor.values[i], lweDimension, variance, csprng->ptr);
+  return InputStage{lweSize, true, [=](const uint64_t *input, size_t size,
+                                       uint64_t *output) {
+    auto encrypt = [&](size_t begin, size_t end, EncCsprng *taskCsprng) {
+      for (size_t i = begin; i < end; i++) {
+        concrete_cpu_encrypt_lwe_ciphertext_u64(key.getRawPtr(),
+                                                &output[i * lweSize], input[i],
+                                                lweDimension, variance,
+                                                taskCsprng);
+      }
+    };
+    // The generator is shared by the circuits of a client program, which may
+    // prepare their inputs on several threads.
+    auto lock = csprng->lock();
+    if (size <= CIPHERTEXTS_PER_TASK) {
+      encrypt(0, size, csprng->ptr);
+      return;
     }
 
-    return Value{outputTensor};
-  };
+    // Each task gets its own generator, forked in order so that the
+    // ciphertexts do not depend on the scheduling.
+    std::vector<csprng::EncryptionCSPRNG> csprngs;
+    csprngs.reserve((size + CIPHERTEXTS_PER_TASK - 1) / CIPHERTEXTS_PER_TASK);
+    for (size_t i = 0; i < size; i += CIPHERTEXTS_PER_TASK) {
+      csprngs.push_back(csprng->fork());
+    }
+    lock.unlock();
+    forEachCiphertextRange(size, [&](size_t taskId, size_t begin, size_t end) {
+      encrypt(begin, end, csprngs[taskId].ptr);
+    });
+  }};
 }
 
-Result<Transformer> getSeededEncryptionTransformer(
-    ClientKeyset keyset,
+Result<InputStage> getSeededEncryptionStage(
+    const LweSecretKey &key,
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info) {
 
-  auto key = keyset.lweSecretKeys[info.asReader().getKeyId()];
   auto lweDimension = info.asReader().getLweDimension();
   auto variance = info.asReader().getVariance();
-
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    // 3 = 2 (seed) + 1 (encrypted scalar)
-    auto const ciphertextSize = 3;
-    outputTensor.dimensions.push_back(ciphertextSize);
-    outputTensor.values.resize(outputTensor.values.size() * ciphertextSize);
-    struct Uint128 seed;
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      csprng::getRandomSeed(&seed);
-      // Write seed
-      csprng::writeSeed(seed, &outputTensor.values[i * 3]);
-      // Encrypt
-      concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(
-          key.getRawPtr(), &outputTensor.values[i * 3 + 2],
-          inputTensor.values[i], lweDimension, seed, variance);
-    }
-    return Value{outputTensor};
-  };
+  // 3 = 2 (seed) + 1 (encrypted scalar)
+  const size_t ciphertextSize = 3;
+
+  return InputStage{ciphertextSize, true, [=](const uint64_t *input,
+                                              size_t size, uint64_t *output) {
+    forEachCiphertextRange(size, [&](size_t, size_t begin, size_t end) {
+      struct Uint128 seed;
+      for (size_t i = begin; i < end; i++) {
+        csprng::getRandomSeed(&seed);
+        // Write seed
+        csprng::writeSeed(seed, &output[i * 3]);
+        // Encrypt
+        concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(
+            key.getRawPtr(), &output[i * 3 + 2], input[i], lweDimension, seed,
+            variance);
+      }
+    });
+  }};
 }
 
-Result<Transformer> getEncryptionSimulationTransformer(
+Result<InputStage> getEncryptionSimulationStage(
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
 
   auto lweDimension = info.asReader().getLweDimension();
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+  return InputStage{
+      1, false, [=](const uint64_t *input, size_t size, uint64_t *output) {
+        auto lock = csprng->lock();
+        for (size_t i = 0; i < size; i++) {
+          output[i] = sim_encrypt_lwe_u64(input[i], lweDimension,
+                                          (Csprng *)(*csprng).ptr);
+        }
+      }};
+}
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = sim_encrypt_lwe_u64(
-          inputTensor.values[i], lweDimension, (Csprng *)(*csprng).ptr);
+/// Decrypts the tensor of ciphertexts stored at `ciphertexts`, whose last
+/// dimension is the lwe size.
+Value decryptCiphertexts(const LweSecretKey &key, uint64_t lweDimension,
+                         const uint64_t *ciphertexts,
+                         std::vector<size_t> dimensions) {
+  auto lweSize = lweDimension + 1;
+  Tensor<uint64_t> outputTensor;
+  outputTensor.dimensions = std::move(dimensions);
+  outputTensor.dimensions.pop_back();
+  size_t size = 1;
+  for (auto d : outputTensor.dimensions) {
+    size *= d;
+  }
+  outputTensor.values.resize(size);
+
+  forEachCiphertextRange(size, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      concrete_cpu_decrypt_lwe_ciphertext_u64(key.getRawPtr(),
+                                              &ciphertexts[i * lweSize],
+                                              lweDimension,
+                                              &outputTensor.values[i]);
     }
+  });
 
-    return Value{outputTensor};
-  };
+  return Value{outputTensor};
 }
 
 Result<Transformer> getDecryptionTransformer(
-    ClientKeyset keyset,
+    const LweSecretKey &key,
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info) {
 
-  auto key = keyset.lweSecretKeys[info.asReader().getKeyId()];
   auto lweDimension = info.asReader().getLweDimension();
-  auto lweSize = lweDimension + 1;
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / lweSize);
-
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      concrete_cpu_decrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &inputTensor.values[i * lweSize], lweDimension,
-          &outputTensor.values[i]);
-    }
-
-    return Value{outputTensor};
+    auto inputTensor = input.getTensorPtr<uint64_t>();
+    return decryptCiphertexts(key, lweDimension, inputTensor->values.data(),
+                              inputTensor->dimensions);
   };
 }
 
@@ -655,30 +682,30 @@ Result<Transformer> getNoneDecompressionTransformer() {
 
 Result<Transformer> getBooleanDecodingTransformer() {
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    // The plaintexts are decoded in place.
+    auto tensor = input.getTensorPtr<uint64_t>();
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto input = inputTensor.values[i];
+    for (size_t i = 0; i < tensor->values.size(); i++) {
+      auto input = tensor->values[i];
       uint64_t output = input >> 60;
       uint64_t carry = output % 2;
       uint64_t mod = 1 << 3;
       output = ((output >> 1) + carry) % mod;
-      outputTensor.values[i] = output;
+      tensor->values[i] = output;
     }
 
-    return Value{outputTensor};
+    return input;
   };
 }
 
-Result<Transformer> getIntegerEncodingTransformer(
+Result<InputStage> getIntegerEncodingStage(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   if (info.asReader().getMode().hasNative()) {
-    return getNativeModeIntegerEncodingTransformer(info);
+    return getNativeModeIntegerEncodingStage(info);
   } else if (info.asReader().getMode().hasChunked()) {
-    return getChunkedModeIntegerEncodingTransformer(info);
+    return getChunkedModeIntegerEncodingStage(info);
   } else if (info.asReader().getMode().hasCrt()) {
-    return getCrtModeIntegerEncodingTransformer(info);
+    return getCrtModeIntegerEncodingStage(info);
   } else {
     return StringError(
         "Tried to construct integer encoding transformer without mode.");
@@ -725,7 +752,7 @@ Result<OutputTransformer> TransformerFactory::getIndexOutputTransformer(
         "Tried to get index output transformer from non-index gate info.");
   }
   OUTCOME_TRY(auto verify, getTransportValueVerifier(gateInfo));
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return Value::fromRawTransportValue(transportVal);
   };
@@ -777,7 +804,7 @@ Result<OutputTransformer> TransformerFactory::getPlaintextOutputTransformer(
                        "non-plaintext gate info.");
   }
   OUTCOME_TRY(auto verify, getTransportValueVerifier(gateInfo));
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return Value::fromRawTransportValue(transportVal);
   };
@@ -804,7 +831,7 @@ Result<ReturnTransformer> TransformerFactory::getPlaintextReturnTransformer(
 }
 
 Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
-    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    const ClientKeyset &keyset, Message<concreteprotocol::GateInfo> gateInfo,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation) {
   if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
     return StringError("Tried to get lwe ciphertext input transformer from "
@@ -823,21 +850,21 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
     }
   }
 
-  /// Generating the encoding transformer.
-  Transformer encodingTransformer;
+  /// Generating the encoding stage.
+  InputStage encodingStage;
   if (gateInfo.asReader()
           .getTypeInfo()
           .getLweCiphertext()
           .getEncoding()
           .hasBoolean()) {
-    OUTCOME_TRY(encodingTransformer, getBooleanEncodingTransformer());
+    OUTCOME_TRY(encodingStage, getBooleanEncodingStage());
   } else if (gateInfo.asReader()
                  .getTypeInfo()
                  .getLweCiphertext()
                  .getEncoding()
                  .hasInteger()) {
-    OUTCOME_TRY(encodingTransformer,
-                getIntegerEncodingTransformer(
+    OUTCOME_TRY(encodingStage,
+                getIntegerEncodingStage(
                     (Message<concreteprotocol::IntegerCiphertextEncodingInfo>)
                         gateInfo.asReader()
                             .getTypeInfo()
@@ -848,39 +875,28 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
     return StringError("Malformed gate info");
   }
 
-  /// Generating the encryption transformer.
-  Transformer encryptionTransformer;
+  /// Generating the encryption stage.
+  auto encryptionInfo =
+      (Message<concreteprotocol::LweCiphertextEncryptionInfo>)gateInfo
+          .asReader()
+          .getTypeInfo()
+          .getLweCiphertext()
+          .getEncryption();
+  InputStage encryptionStage;
   if (useSimulation) {
-    OUTCOME_TRY(encryptionTransformer,
-                getEncryptionSimulationTransformer(
-                    (Message<concreteprotocol::LweCiphertextEncryptionInfo>)
-                        gateInfo.asReader()
-                            .getTypeInfo()
-                            .getLweCiphertext()
-                            .getEncryption(),
-                    csprng));
+    OUTCOME_TRY(encryptionStage,
+                getEncryptionSimulationStage(encryptionInfo, csprng));
   } else {
+    const auto &key =
+        keyset.lweSecretKeys[encryptionInfo.asReader().getKeyId()];
     auto compression =
         gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression();
     if (compression == concreteprotocol::Compression::NONE) {
-      OUTCOME_TRY(encryptionTransformer,
-                  getEncryptionTransformer(
-                      keyset,
-                      (Message<concreteprotocol::LweCiphertextEncryptionInfo>)
-                          gateInfo.asReader()
-                              .getTypeInfo()
-                              .getLweCiphertext()
-                              .getEncryption(),
-                      csprng));
+      OUTCOME_TRY(encryptionStage,
+                  getEncryptionStage(key, encryptionInfo, csprng));
     } else if (compression == concreteprotocol::Compression::SEED) {
-      OUTCOME_TRY(
-          encryptionTransformer,
-          getSeededEncryptionTransformer(
-              keyset, (Message<concreteprotocol::LweCiphertextEncryptionInfo>)
-                          gateInfo.asReader()
-                              .getTypeInfo()
-                              .getLweCiphertext()
-                              .getEncryption()));
+      OUTCOME_TRY(encryptionStage,
+                  getSeededEncryptionStage(key, encryptionInfo));
     } else {
       return StringError(
           "Only none compression is currently supported for lwe ciphertext "
@@ -891,8 +907,49 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
   OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
   return [=](Value val) -> Result<TransportValue> {
     OUTCOME_TRYV(verify(val));
-    auto output =
-        encryptionTransformer(encodingTransformer(val)).intoRawTransportValue();
+
+    // Signed integers are encoded from their two's complement representation,
+    // so both kinds of tensors are read in place.
+    const uint64_t *input;
+    size_t size;
+    if (auto tensor = val.getTensorPtr<int64_t>(); tensor) {
+      input = reinterpret_cast<const uint64_t *>(tensor->values.data());
+      size = tensor->values.size();
+    } else {
+      auto unsignedTensor = val.getTensorPtr<uint64_t>();
+      input = unsignedTensor->values.data();
+      size = unsignedTensor->values.size();
+    }
+
+    auto dimensions = val.getDimensions();
+    for (auto stage : {&encodingStage, &encryptionStage}) {
+      if (stage->addsDimension) {
+        dimensions.push_back(stage->wordsPerInput);
+      }
+    }
+
+    std::vector<uint64_t> plaintexts(size * encodingStage.wordsPerInput);
+    encodingStage.run(input, size, plaintexts.data());
+
+    TransportValue output;
+    auto rawInfo = output.asBuilder().initRawInfo();
+    rawInfo.setShape(dimensionsToProtoShape(dimensions).asReader());
+    rawInfo.setIntegerPrecision(64);
+    rawInfo.setIsSigned(false);
+    auto payload = output.asBuilder().initPayload();
+    size_t payloadSize = plaintexts.size() * encryptionStage.wordsPerInput;
+    if (payloadSize * sizeof(uint64_t) <= capnp::MAX_TEXT_SIZE) {
+      // The ciphertexts fit in a single blob, they are encrypted straight into
+      // the message.
+      auto blob = payload.initData(1).init(0, payloadSize * sizeof(uint64_t));
+      encryptionStage.run(plaintexts.data(), plaintexts.size(),
+                          reinterpret_cast<uint64_t *>(blob.begin()));
+    } else {
+      std::vector<uint64_t> ciphertexts(payloadSize);
+      encryptionStage.run(plaintexts.data(), plaintexts.size(),
+                          ciphertexts.data());
+      writeArrayToProtoPayload(ciphertexts.data(), payloadSize, payload);
+    }
     output.asBuilder().initTypeInfo().setLweCiphertext(
         gateInfo.asReader().getTypeInfo().getLweCiphertext());
     return output;
@@ -932,7 +989,7 @@ Result<ArgTransformer> getDecompressionTransformer(
   if (useSimulation)
     return Value::fromRawTransportValue;
 
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     auto value = Value::fromRawTransportValue(transportVal);
     auto compression = transportVal.asReader()
                            .getTypeInfo()
@@ -969,7 +1026,7 @@ Result<ArgTransformer> TransformerFactory::getLweCiphertextArgTransformer(
     OUTCOME_TRY(verify, getTransportValueVerifier(gateInfo));
   }
 
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return decompressionTransformer(transportVal);
   };
@@ -1011,7 +1068,7 @@ Result<ReturnTransformer> TransformerFactory::getLweCiphertextReturnTransformer(
 }
 
 Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
-    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    const ClientKeyset &keyset, Message<concreteprotocol::GateInfo> gateInfo,
     bool useSimulation) {
   if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
     return StringError("Tried to get lwe ciphertext output transformer from "
@@ -1042,12 +1099,15 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
 
   /// Generating the decryption transformer.
   Transformer decryptionTransformer;
+  std::optional<LweSecretKey> key;
   if (useSimulation) {
     OUTCOME_TRY(decryptionTransformer, getDecryptionSimulationTransformer());
   } else {
+    key = keyset.lweSecretKeys[encryptionInfo.asReader().getKeyId()];
     OUTCOME_TRY(decryptionTransformer,
-                getDecryptionTransformer(keyset, encryptionInfo));
+                getDecryptionTransformer(*key, encryptionInfo));
   }
+  auto lweDimension = encryptionInfo.asReader().getLweDimension();
 
   /// Generating the decoding transformer.
   Transformer decodingTransformer;
@@ -1082,8 +1142,19 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
     OUTCOME_TRY(verify, getTransportValueVerifier(gateInfo));
   }
 
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
+    // Uncompressed ciphertexts are decrypted straight from the payload.
+    if (key && transportVal.asReader()
+                           .getTypeInfo()
+                           .getLweCiphertext()
+                           .getCompression() ==
+                       concreteprotocol::Compression::NONE) {
+      if (auto view = Value::viewRawTransportValue<uint64_t>(transportVal)) {
+        return decodingTransformer(decryptCiphertexts(
+            *key, lweDimension, view->values, view->dimensions));
+      }
+    }
     OUTCOME_TRY(auto value, decompressionTransformer(transportVal));
     return decodingTransformer(decryptionTransformer(value));
   };
@@ -20,12 +20,12 @@ using concretelang::protocol::dimensionsToProtoShape;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToVector;
 using concretelang::protocol::protoShapeToDimensions;
-using concretelang::protocol::vectorToProtoPayload;
+using concretelang::protocol::writeArrayToProtoPayload;
 
 namespace concretelang {
 namespace values {
 
-Value Value::fromRawTransportValue(TransportValue transportVal) {
+Value Value::fromRawTransportValue(const TransportValue &transportVal) {
   Value output;
   auto integerPrecision =
       transportVal.asReader().getRawInfo().getIntegerPrecision();
@@ -70,7 +70,8 @@ TransportValue Value::intoRawTransportValue() const {
   rawInfo.setShape(intoProtoShape().asReader());
   rawInfo.setIntegerPrecision(getIntegerPrecision());
   rawInfo.setIsSigned(isSigned());
-  output.asBuilder().setPayload(intoProtoPayload().asReader());
+  // The payload is written in place, to avoid copying it twice.
+  writeProtoPayload(output.asBuilder().initPayload());
   return output;
 }
 
@@ -102,22 +103,37 @@ bool Value::isSigned() const {
 }
 
 Message<concreteprotocol::Payload> Value::intoProtoPayload() const {
+  auto output = Message<concreteprotocol::Payload>();
+  writeProtoPayload(output.asBuilder());
+  return output;
+}
+
+void Value::writeProtoPayload(
+    concreteprotocol::Payload::Builder builder) const {
   if (hasElementType<uint8_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint8_t>>(inner).values);
+    auto &values = std::get<Tensor<uint8_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<uint16_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint16_t>>(inner).values);
+    auto &values = std::get<Tensor<uint16_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<uint32_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint32_t>>(inner).values);
+    auto &values = std::get<Tensor<uint32_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<uint64_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint64_t>>(inner).values);
+    auto &values = std::get<Tensor<uint64_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<int8_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int8_t>>(inner).values);
+    auto &values = std::get<Tensor<int8_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<int16_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int16_t>>(inner).values);
+    auto &values = std::get<Tensor<int16_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<int32_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int32_t>>(inner).values);
+    auto &values = std::get<Tensor<int32_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else if (hasElementType<int64_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int64_t>>(inner).values);
+    auto &values = std::get<Tensor<int64_t>>(inner).values;
+    writeArrayToProtoPayload(values.data(), values.size(), builder);
   } else {
     assert(false);
   }
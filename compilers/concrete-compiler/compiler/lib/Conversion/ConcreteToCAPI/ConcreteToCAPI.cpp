@@ -3,6 +3,9 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include <mlir/IR/PatternMatch.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
+#include <mlir/Interfaces/ViewLikeInterface.h>
 #include <mlir/Pass/Pass.h>
 #include <mlir/Transforms/DialectConversion.h>
 
@@ -28,6 +31,7 @@ char memref_mul_cleartext_lwe_ciphertext_u64[] =
 char memref_negate_lwe_ciphertext_u64[] = "memref_negate_lwe_ciphertext_u64";
 char memref_keyswitch_lwe_u64[] = "memref_keyswitch_lwe_u64";
 char memref_bootstrap_lwe_u64[] = "memref_bootstrap_lwe_u64";
+char memref_many_bootstrap_lwe_u64[] = "memref_many_bootstrap_lwe_u64";
 char memref_batched_add_lwe_ciphertexts_u64[] =
     "memref_batched_add_lwe_ciphertexts_u64";
 char memref_batched_add_plaintext_lwe_ciphertext_u64[] =
@@ -40,6 +44,10 @@ char memref_batched_mul_cleartext_cst_lwe_ciphertext_u64[] =
     "memref_batched_mul_cleartext_cst_lwe_ciphertext_u64";
 char memref_batched_negate_lwe_ciphertext_u64[] =
     "memref_batched_negate_lwe_ciphertext_u64";
+char memref_batched_mul_cleartext_add_lwe_ciphertext_u64[] =
+    "memref_batched_mul_cleartext_add_lwe_ciphertext_u64";
+char memref_matmul_cleartext_lwe_ciphertext_u64[] =
+    "memref_matmul_cleartext_lwe_ciphertext_u64";
 char memref_batched_keyswitch_lwe_u64[] = "memref_batched_keyswitch_lwe_u64";
 char memref_batched_bootstrap_lwe_u64[] = "memref_batched_bootstrap_lwe_u64";
 char memref_batched_mapped_bootstrap_lwe_u64[] =
@@ -74,6 +82,8 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 1);
   auto memref2DType =
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 2);
+  auto memref3DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 3);
   auto futureType =
       mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
   auto contextType =
@@ -110,11 +120,18 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref1DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
-  } else if (funcName == memref_keyswitch_async_lwe_u64) {
-    // Todo Answer this question: Isn't it dead ?
+  } else if (funcName == memref_many_bootstrap_lwe_u64) {
     funcType = mlir::FunctionType::get(
-        rewriter.getContext(), {memref1DType, memref1DType, contextType},
-        {futureType});
+        rewriter.getContext(),
+        {memref2DType, memref1DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, contextType},
+        {});
+  } else if (funcName == memref_keyswitch_async_lwe_u64) {
+    funcType =
+        mlir::FunctionType::get(rewriter.getContext(),
+                                {memref1DType, memref1DType, i32Type, i32Type,
+                                 i32Type, i32Type, i32Type, contextType},
+                                {futureType});
   } else if (funcName == memref_bootstrap_async_lwe_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref1DType, memref1DType,
@@ -141,6 +158,13 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
   } else if (funcName == memref_batched_negate_lwe_ciphertext_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref2DType, memref2DType}, {});
+  } else if (funcName == memref_batched_mul_cleartext_add_lwe_ciphertext_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref2DType, memref1DType, memref2DType}, {});
+  } else if (funcName == memref_matmul_cleartext_lwe_ciphertext_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(), {memref3DType, memref3DType, memref2DType}, {});
   } else if (funcName == memref_batched_keyswitch_lwe_u64 ||
              funcName == memref_batched_keyswitch_lwe_cuda_u64) {
     funcType =
@@ -164,8 +188,7 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                        {});
   } else if (funcName == memref_await_future) {
     funcType = mlir::FunctionType::get(
-        rewriter.getContext(),
-        {memref1DType, futureType, memref1DType, memref1DType}, {});
+        rewriter.getContext(), {memref1DType, futureType, memref1DType}, {});
   } else if (funcName == memref_expand_lut_in_trivial_glwe_ct_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {
@@ -332,6 +355,34 @@ void bootstrapAddOperands(BootstrapOp op,
   operands.push_back(getContextArgument(op));
 }
 
+void manyBootstrapAddOperands(Concrete::ManyBootstrapLweBufferOp op,
+                              mlir::SmallVector<mlir::Value> &operands,
+                              mlir::RewriterBase &rewriter) {
+  // input_lwe_dim
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getInputLweDimAttr()));
+  // poly_size
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getPolySizeAttr()));
+  // level
+  operands.push_back(
+      rewriter.create<mlir::arith::ConstantOp>(op.getLoc(), op.getLevelAttr()));
+  // base_log
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getBaseLogAttr()));
+  // glwe_dim
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getGlweDimensionAttr()));
+  // lut_stride
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getLutStrideAttr()));
+  // bsk_index
+  operands.push_back(
+      rewriter.create<arith::ConstantOp>(op.getLoc(), op.getBskIndexAttr()));
+  // context
+  operands.push_back(getContextArgument(op));
+}
+
 void wopPBSAddOperands(Concrete::WopPBSCRTLweBufferOp op,
                        mlir::SmallVector<mlir::Value> &operands,
                        mlir::RewriterBase &rewriter) {
@@ -492,13 +543,178 @@ void encodeLutForWopPBSAddOperands(Concrete::EncodeLutForCrtWopPBSBufferOp op,
       op.getLoc(), op.getIsSignedAttr()));
 }
 
+/// Returns the buffer `value` is a view of.
+mlir::Value getViewRoot(mlir::Value value) {
+  while (auto view = value.getDefiningOp<mlir::ViewLikeOpInterface>())
+    value = view.getViewSource();
+  return value;
+}
+
+/// Returns true if `root` is a buffer that cannot alias any other identified
+/// buffer: a local allocation, a global or an argument of the enclosing
+/// function.
+bool isIdentifiedBuffer(mlir::Value root) {
+  if (auto arg = root.dyn_cast<mlir::BlockArgument>())
+    return mlir::isa<func::FuncOp>(arg.getOwner()->getParentOp());
+  return mlir::isa<memref::AllocOp, memref::AllocaOp, memref::GetGlobalOp>(
+      root.getDefiningOp());
+}
+
+bool mayAlias(mlir::Value a, mlir::Value b) {
+  a = getViewRoot(a);
+  b = getViewRoot(b);
+  if (a == b)
+    return true;
+  if (!isIdentifiedBuffer(a) || !isIdentifiedBuffer(b))
+    return true;
+  auto globalA = a.getDefiningOp<memref::GetGlobalOp>();
+  auto globalB = b.getDefiningOp<memref::GetGlobalOp>();
+  return globalA && globalB && globalA.getName() == globalB.getName();
+}
+
+/// Returns true if `op` may access the memory of its `index`-th operand,
+/// only counting writes if `onlyWrites` is set.
+bool mayAccessOperand(mlir::Operation *op, unsigned index, bool onlyWrites) {
+  // Buffer operations of the Concrete dialect and the asynchronous calls
+  // write their first operand and only read the others.
+  if (llvm::isa_and_nonnull<Concrete::ConcreteDialect>(op->getDialect()))
+    return !onlyWrites || index == 0;
+  if (auto call = mlir::dyn_cast<func::CallOp>(op)) {
+    auto callee = call.getCallee();
+    if (callee == memref_keyswitch_async_lwe_u64 ||
+        callee == memref_bootstrap_async_lwe_u64 ||
+        callee == memref_await_future)
+      return !onlyWrites || index == 0 ||
+             (callee == memref_await_future && index == 2);
+    return true;
+  }
+  auto effectsOp = mlir::dyn_cast<mlir::MemoryEffectOpInterface>(op);
+  if (!effectsOp)
+    return true;
+  mlir::SmallVector<mlir::MemoryEffects::EffectInstance> effects;
+  effectsOp.getEffects(effects);
+  mlir::Value operand = op->getOperand(index);
+  return llvm::any_of(effects, [&](mlir::MemoryEffects::EffectInstance &it) {
+    if (it.getValue() && it.getValue() != operand)
+      return false;
+    if (mlir::isa<mlir::MemoryEffects::Allocate>(it.getEffect()))
+      return false;
+    return !onlyWrites || !mlir::isa<mlir::MemoryEffects::Read>(it.getEffect());
+  });
+}
+
+/// Returns true if `op`, or any operation nested in it, may read or write
+/// `result`, or may write one of `inputs`.
+bool conflictsWithAsyncOp(mlir::Operation *op, mlir::Value result,
+                          mlir::ValueRange inputs) {
+  auto walkResult = op->walk([&](mlir::Operation *nested) {
+    for (auto &operand : nested->getOpOperands()) {
+      if (!operand.get().getType().isa<mlir::MemRefType>())
+        continue;
+      unsigned index = operand.getOperandNumber();
+      if (mayAlias(operand.get(), result) &&
+          mayAccessOperand(nested, index, false))
+        return mlir::WalkResult::interrupt();
+      for (auto input : inputs) {
+        if (mayAlias(operand.get(), input) &&
+            mayAccessOperand(nested, index, true))
+          return mlir::WalkResult::interrupt();
+      }
+    }
+    return mlir::WalkResult::advance();
+  });
+  return walkResult.wasInterrupted();
+}
+
+/// Replaces the keyswitch and bootstrap operations of `module` by calls to
+/// their asynchronous CAPI, and awaits each returned future right before the
+/// first subsequent operation of the same block that depends on the
+/// operation, at the latest before the block terminator.
+mlir::LogicalResult lowerToAsyncCAPICalls(mlir::ModuleOp module) {
+  mlir::SmallVector<mlir::Operation *> asyncOps;
+  module.walk([&](mlir::Operation *op) {
+    if (mlir::isa<Concrete::KeySwitchLweBufferOp,
+                  Concrete::BootstrapLweBufferOp>(op))
+      asyncOps.push_back(op);
+  });
+
+  mlir::IRRewriter rewriter(module.getContext());
+  auto futureType =
+      mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
+  for (auto op : asyncOps) {
+    mlir::Value result = op->getOperand(0);
+    mlir::ValueRange inputs = op->getOperands().drop_front();
+    // Deallocations of the inputs are postponed after the await instead of
+    // forcing it, as buffer deallocation places them right after their last
+    // use.
+    mlir::SmallVector<memref::DeallocOp> postponedDeallocs;
+    mlir::Operation *awaitPoint = op->getNextNode();
+    while (!awaitPoint->hasTrait<mlir::OpTrait::IsTerminator>()) {
+      auto dealloc = mlir::dyn_cast<memref::DeallocOp>(awaitPoint);
+      if (dealloc && !mayAlias(dealloc.getMemref(), result)) {
+        postponedDeallocs.push_back(dealloc);
+      } else if (conflictsWithAsyncOp(awaitPoint, result, inputs)) {
+        break;
+      }
+      awaitPoint = awaitPoint->getNextNode();
+    }
+
+    rewriter.setInsertionPoint(op);
+    mlir::SmallVector<mlir::Value> operands;
+    for (auto operand : op->getOperands())
+      operands.push_back(mlir::concretelang::getCastedMemRef(rewriter, operand));
+
+    char const *callee;
+    if (auto keyswitch = mlir::dyn_cast<Concrete::KeySwitchLweBufferOp>(op)) {
+      keyswitchAddOperands(keyswitch, operands, rewriter);
+      callee = memref_keyswitch_async_lwe_u64;
+    } else {
+      bootstrapAddOperands(mlir::cast<Concrete::BootstrapLweBufferOp>(op),
+                           operands, rewriter);
+      callee = memref_bootstrap_async_lwe_u64;
+    }
+
+    if (insertForwardDeclarationOfTheCAPI(op, rewriter, callee).failed() ||
+        insertForwardDeclarationOfTheCAPI(op, rewriter, memref_await_future)
+            .failed()) {
+      return mlir::failure();
+    }
+
+    auto future = rewriter
+                      .create<func::CallOp>(op->getLoc(), callee,
+                                            mlir::TypeRange{futureType},
+                                            operands)
+                      .getResult(0);
+
+    // The asynchronous operation writes its result in place, so the await
+    // has nothing to copy.
+    rewriter.setInsertionPoint(awaitPoint);
+    auto awaitOp = rewriter.create<func::CallOp>(
+        op->getLoc(), memref_await_future, mlir::TypeRange{},
+        mlir::ValueRange{operands[0], future, operands[0]});
+    for (auto dealloc : llvm::reverse(postponedDeallocs))
+      dealloc->moveAfter(awaitOp);
+
+    rewriter.eraseOp(op);
+  }
+
+  return mlir::success();
+}
+
 struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
 
-  ConcreteToCAPIPass(bool gpu) : gpu(gpu) {}
+  ConcreteToCAPIPass(bool gpu, bool async) : gpu(gpu), async(async) {}
 
   void runOnOperation() override {
     auto op = this->getOperation();
 
+    // Keyswitches and bootstraps are offloaded to the runtime worker pool
+    // before the remaining operations are lowered to synchronous calls
+    if (async && !gpu && lowerToAsyncCAPICalls(op).failed()) {
+      this->signalPassFailure();
+      return;
+    }
+
     mlir::ConversionTarget target(getContext());
     mlir::RewritePatternSet patterns(&getContext());
 
@@ -558,6 +774,13 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
         ConcreteToCAPICallPattern<Concrete::BatchedNegateLweBufferOp,
                                   memref_batched_negate_lwe_ciphertext_u64>>(
         &getContext());
+    patterns.add<ConcreteToCAPICallPattern<
+        Concrete::BatchedMulCleartextAddLweBufferOp,
+        memref_batched_mul_cleartext_add_lwe_ciphertext_u64>>(&getContext());
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::MatMulCleartextLweBufferOp,
+                                  memref_matmul_cleartext_lwe_ciphertext_u64>>(
+        &getContext());
     if (gpu) {
       patterns.add<ConcreteToCAPICallPattern<Concrete::KeySwitchLweBufferOp,
                                              memref_keyswitch_lwe_cuda_u64>>(
@@ -587,6 +810,10 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
       patterns.add<ConcreteToCAPICallPattern<Concrete::BootstrapLweBufferOp,
                                              memref_bootstrap_lwe_u64>>(
           &getContext(), bootstrapAddOperands<Concrete::BootstrapLweBufferOp>);
+      patterns.add<
+          ConcreteToCAPICallPattern<Concrete::ManyBootstrapLweBufferOp,
+                                    memref_many_bootstrap_lwe_u64>>(
+          &getContext(), manyBootstrapAddOperands);
       patterns
           .add<ConcreteToCAPICallPattern<Concrete::BatchedKeySwitchLweBufferOp,
                                          memref_batched_keyswitch_lwe_u64>>(
@@ -617,6 +844,7 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
 
 private:
   bool gpu;
+  bool async;
 };
 
 } // namespace
@@ -624,8 +852,8 @@ private:
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertConcreteToCAPIPass(bool gpu) {
-  return std::make_unique<ConcreteToCAPIPass>(gpu);
+createConvertConcreteToCAPIPass(bool gpu, bool async) {
+  return std::make_unique<ConcreteToCAPIPass>(gpu, async);
 }
 } // namespace concretelang
 } // namespace mlir
@@ -1598,6 +1598,28 @@ mlir::LogicalResult createGroupedConv2D(
   return mlir::success();
 }
 
+/// Pads the input of `conv2dOp` with encrypted zeros according to
+/// `paddingInts`, leaving the batch and channel dimensions untouched.
+static mlir::Value
+padConv2dInput(mlir::PatternRewriter &rewriter,
+               mlir::concretelang::FHELinalg::Conv2dOp conv2dOp,
+               mlir::SmallVectorImpl<int64_t> &paddingInts) {
+  mlir::Value input = conv2dOp.getInput();
+
+  mlir::SmallVector<int64_t, 4> lowPaddingIncludingNC = {0, 0};
+  lowPaddingIncludingNC.insert(lowPaddingIncludingNC.end(),
+                               paddingInts.begin() + 2, paddingInts.end());
+  mlir::SmallVector<int64_t, 4> highPaddingIncludingNC = {0, 0};
+  highPaddingIncludingNC.insert(highPaddingIncludingNC.end(),
+                                paddingInts.begin(), paddingInts.begin() + 2);
+  mlir::Value paddingValue =
+      rewriter.create<mlir::concretelang::FHE::ZeroEintOp>(
+          conv2dOp.getLoc(),
+          input.getType().cast<mlir::RankedTensorType>().getElementType());
+  return getPaddedTensor(conv2dOp, rewriter, input, lowPaddingIncludingNC,
+                         highPaddingIncludingNC, paddingValue);
+}
+
 bool isZeroConstant(mlir::Value value) {
   auto cst =
       mlir::dyn_cast_or_null<mlir::arith::ConstantOp>(value.getDefiningOp());
@@ -1672,20 +1694,7 @@ struct FHELinalgConv2dToLinalgConv2d
         mlir::concretelang::FHELinalg::getDilationsFromConv2d(conv2dOp);
     int64_t group = mlir::concretelang::FHELinalg::getGroupFromConv2d(conv2dOp);
 
-    // Pad the input tensor according to padding.
-    mlir::SmallVector<int64_t, 4> lowPaddingIncludingNC = {0, 0};
-    lowPaddingIncludingNC.insert(lowPaddingIncludingNC.end(),
-                                 paddingInts.begin() + 2, paddingInts.end());
-    mlir::SmallVector<int64_t, 4> highPaddingIncludingNC = {0, 0};
-    highPaddingIncludingNC.insert(highPaddingIncludingNC.end(),
-                                  paddingInts.begin(), paddingInts.begin() + 2);
-    mlir::Value paddingValue =
-        rewriter.create<mlir::concretelang::FHE::ZeroEintOp>(
-            loc,
-            input.getType().cast<mlir::RankedTensorType>().getElementType());
-    mlir::Value paddedInput =
-        getPaddedTensor(conv2dOp, rewriter, input, lowPaddingIncludingNC,
-                        highPaddingIncludingNC, paddingValue);
+    mlir::Value paddedInput = padConv2dInput(rewriter, conv2dOp, paddingInts);
 
     // TODO(Optimization): output tensor is being constructed in two different
     // ways, depending of whether there is a bias or not:
@@ -1755,6 +1764,160 @@ struct FHELinalgConv2dToLinalgConv2d
   };
 };
 
+/// This rewrite pattern transforms ungrouped instances of `FHELinalg.conv2d`
+/// to a single `FHELinalg.matmul_eint_int` using the im2col method, so that
+/// the convolution benefits from the dense encrypted-by-clear matrix product
+/// kernel. It is only used when the matrix products are kept until the TFHE
+/// lowering.
+///
+/// The padded input `NxCxHxW` is gathered into a matrix of
+/// `(N*OH*OW)x(C*KH*KW)` patches, the weight `FxCxKHxKW` is reshaped to a
+/// `(C*KH*KW)xF` matrix and the `(N*OH*OW)xF` product is finally permuted back
+/// to `NxFxOHxOW`, adding the bias if any.
+struct FHELinalgConv2dToIm2colMatmul
+    : public ::mlir::OpRewritePattern<mlir::concretelang::FHELinalg::Conv2dOp> {
+  FHELinalgConv2dToIm2colMatmul(::mlir::MLIRContext *context)
+      : ::mlir::OpRewritePattern<::mlir::concretelang::FHELinalg::Conv2dOp>(
+            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT + 1) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(::mlir::concretelang::FHELinalg::Conv2dOp conv2dOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    if (mlir::concretelang::FHELinalg::getGroupFromConv2d(conv2dOp) != 1 ||
+        conv2dOp->hasAttr("tile-sizes"))
+      return mlir::failure();
+
+    mlir::Location loc = conv2dOp->getLoc();
+    mlir::MLIRContext *ctx = rewriter.getContext();
+
+    mlir::SmallVector<int64_t, 4> paddingInts =
+        mlir::concretelang::FHELinalg::getPaddingFromConv2d(conv2dOp);
+    mlir::SmallVector<int64_t, 2> stridesInts =
+        mlir::concretelang::FHELinalg::getStridesFromConv2d(conv2dOp);
+    mlir::SmallVector<int64_t, 2> dilationsInts =
+        mlir::concretelang::FHELinalg::getDilationsFromConv2d(conv2dOp);
+
+    mlir::Value paddedInput = padConv2dInput(rewriter, conv2dOp, paddingInts);
+    mlir::Value weight = conv2dOp.getWeight();
+
+    auto inputTy = paddedInput.getType().cast<mlir::RankedTensorType>();
+    auto weightTy = weight.getType().cast<mlir::RankedTensorType>();
+    auto resultTy =
+        conv2dOp.getResult().getType().cast<mlir::RankedTensorType>();
+
+    int64_t n = resultTy.getDimSize(0);
+    int64_t f = resultTy.getDimSize(1);
+    int64_t oh = resultTy.getDimSize(2);
+    int64_t ow = resultTy.getDimSize(3);
+    int64_t c = weightTy.getDimSize(1);
+    int64_t kh = weightTy.getDimSize(2);
+    int64_t kw = weightTy.getDimSize(3);
+
+    // Gather the patches: patches[n][oh][ow][c][kh][kw] =
+    //   input[n][c][oh * sh + kh * dh][ow * sw + kw * dw]
+    auto patchesTy = mlir::RankedTensorType::get({n, oh, ow, c, kh, kw},
+                                                 inputTy.getElementType());
+    mlir::Value patchesInit = rewriter.create<tensor::EmptyOp>(
+        loc, patchesTy.getShape(), patchesTy.getElementType());
+    mlir::AffineExpr d[6];
+    mlir::bindDims(ctx, d[0], d[1], d[2], d[3], d[4], d[5]);
+    mlir::SmallVector<mlir::AffineMap, 2> patchesMaps{
+        mlir::AffineMap::get(6, 0,
+                             {d[0], d[3],
+                              d[1] * stridesInts[0] + d[4] * dilationsInts[0],
+                              d[2] * stridesInts[1] + d[5] * dilationsInts[1]},
+                             ctx),
+        mlir::AffineMap::getMultiDimIdentityMap(6, ctx),
+    };
+    mlir::Value patches =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, patchesTy, paddedInput, patchesInit, patchesMaps,
+                parallelIteratorType(6),
+                [&](mlir::OpBuilder &b, mlir::Location loc,
+                    mlir::ValueRange args) {
+                  b.create<linalg::YieldOp>(loc, args[0]);
+                })
+            .getResult(0);
+    mlir::Value lhs = rewriter.create<tensor::CollapseShapeOp>(
+        loc,
+        mlir::RankedTensorType::get({n * oh * ow, c * kh * kw},
+                                    patchesTy.getElementType()),
+        patches,
+        llvm::SmallVector<mlir::ReassociationIndices>{{0, 1, 2}, {3, 4, 5}});
+
+    // Reshape the weight: rhs[c * KH * KW + kh * KW + kw][f] =
+    //   weight[f][c][kh][kw]
+    auto weightTTy = mlir::RankedTensorType::get({c, kh, kw, f},
+                                                 weightTy.getElementType());
+    mlir::Value weightTInit = rewriter.create<tensor::EmptyOp>(
+        loc, weightTTy.getShape(), weightTTy.getElementType());
+    mlir::SmallVector<mlir::AffineMap, 2> weightMaps{
+        mlir::AffineMap::getPermutationMap(
+            llvm::ArrayRef<unsigned>{3, 0, 1, 2}, ctx),
+        mlir::AffineMap::getMultiDimIdentityMap(4, ctx),
+    };
+    mlir::Value weightT =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, weightTTy, weight, weightTInit, weightMaps,
+                parallelIteratorType(4),
+                [&](mlir::OpBuilder &b, mlir::Location loc,
+                    mlir::ValueRange args) {
+                  b.create<linalg::YieldOp>(loc, args[0]);
+                })
+            .getResult(0);
+    mlir::Value rhs = rewriter.create<tensor::CollapseShapeOp>(
+        loc,
+        mlir::RankedTensorType::get({c * kh * kw, f},
+                                    weightTTy.getElementType()),
+        weightT, llvm::SmallVector<mlir::ReassociationIndices>{{0, 1, 2}, {3}});
+
+    auto productTy = mlir::RankedTensorType::get({n * oh * ow, f},
+                                                 resultTy.getElementType());
+    auto matmul = rewriter.create<FHELinalg::MatMulEintIntOp>(loc, productTy,
+                                                              lhs, rhs);
+    forwardOptimizerID(conv2dOp, matmul);
+    mlir::Value product = rewriter.create<tensor::ExpandShapeOp>(
+        loc,
+        mlir::RankedTensorType::get({n, oh, ow, f}, resultTy.getElementType()),
+        matmul.getResult(),
+        llvm::SmallVector<mlir::ReassociationIndices>{{0, 1, 2}, {3}});
+
+    // Permute the product back to NxFxOHxOW, adding the bias on the way
+    mlir::Value bias = conv2dOp.getBias();
+    bool hasBias = bias && !isZeroConstant(bias);
+
+    mlir::AffineExpr r[4];
+    mlir::bindDims(ctx, r[0], r[1], r[2], r[3]);
+    llvm::SmallVector<mlir::Value, 2> ins{product};
+    llvm::SmallVector<mlir::AffineMap, 3> resultMaps{
+        mlir::AffineMap::get(4, 0, {r[0], r[2], r[3], r[1]}, ctx)};
+    if (hasBias) {
+      ins.push_back(bias);
+      resultMaps.push_back(mlir::AffineMap::get(4, 0, r[1], ctx));
+    }
+    resultMaps.push_back(mlir::AffineMap::getMultiDimIdentityMap(4, ctx));
+
+    mlir::Value resultInit = rewriter.create<tensor::EmptyOp>(
+        loc, resultTy.getShape(), resultTy.getElementType());
+    rewriter.replaceOpWithNewOp<linalg::GenericOp>(
+        conv2dOp, resultTy, ins, resultInit, resultMaps,
+        parallelIteratorType(4),
+        [&](mlir::OpBuilder &b, mlir::Location loc, mlir::ValueRange args) {
+          mlir::Value item = args[0];
+          if (hasBias) {
+            auto biased = b.create<FHE::AddEintIntOp>(loc, item, args[1]);
+            forwardOptimizerID(conv2dOp, biased);
+            item = biased.getResult();
+          }
+          b.create<linalg::YieldOp>(loc, item);
+        });
+
+    return mlir::success();
+  };
+};
+
 /// This rewrite pattern transforms all instances
 /// of `FHELinalg.maxpool2d` to `linalg.pooling_ncw_max`.
 struct FHELinalgMaxpool2dToLinalgMaxpool2d
@@ -2423,8 +2586,12 @@ struct BroadcastToLinalgGeneric
 namespace {
 struct FHETensorOpsToLinalg
     : public FHETensorOpsToLinalgBase<FHETensorOpsToLinalg> {
+  FHETensorOpsToLinalg(bool gemm) : gemm(gemm){};
 
   void runOnOperation() final;
+
+private:
+  bool gemm;
 };
 
 void FHETensorOpsToLinalg::runOnOperation() {
@@ -2440,6 +2607,20 @@ void FHETensorOpsToLinalg::runOnOperation() {
   target.addIllegalOp<mlir::concretelang::FHELinalg::Dot>();
   target.addIllegalDialect<mlir::concretelang::FHELinalg::FHELinalgDialect>();
 
+  // Keep the encrypted by clear matrix products that are not marked for
+  // tiling, they are lowered to a dense matrix product kernel later on
+  if (gemm) {
+    target.addDynamicallyLegalOp<FHELinalg::MatMulEintIntOp>(
+        [&](FHELinalg::MatMulEintIntOp op) {
+          auto lhsTy = op.getLhs().getType().cast<mlir::RankedTensorType>();
+          auto rhsTy = op.getRhs().getType().cast<mlir::RankedTensorType>();
+          return !op->hasAttr("tile-sizes") && lhsTy.getRank() == 2 &&
+                 rhsTy.getRank() == 2;
+        });
+    target.addDynamicallyLegalOp<FHELinalg::Dot>(
+        [&](FHELinalg::Dot op) { return !op->hasAttr("tile-sizes"); });
+  }
+
   target.addLegalOp<mlir::scf::ForallOp>();
   target.addLegalOp<mlir::scf::InParallelOp>();
 
@@ -2612,6 +2793,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
   patterns.insert<SumToLinalgGeneric>(&getContext());
   patterns.insert<ConcatRewritePattern>(&getContext());
   patterns.insert<FHELinalgConv2dToLinalgConv2d>(&getContext());
+  if (gemm)
+    patterns.insert<FHELinalgConv2dToIm2colMatmul>(&getContext());
   patterns.insert<FHELinalgMaxpool2dToLinalgMaxpool2d>(&getContext());
   patterns.insert<TransposeToLinalgGeneric>(&getContext());
   patterns.insert<FromElementToTensorFromElements>(&getContext());
@@ -2634,8 +2817,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg() {
-  return std::make_unique<FHETensorOpsToLinalg>();
+createConvertFHETensorOpsToLinalg(bool gemm) {
+  return std::make_unique<FHETensorOpsToLinalg>(gemm);
 }
 } // namespace concretelang
 } // namespace mlir
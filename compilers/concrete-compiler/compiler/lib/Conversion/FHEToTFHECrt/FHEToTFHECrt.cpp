@@ -600,6 +600,88 @@ struct ApplyLookupTableEintOpPattern
   };
 };
 
+/// Rewriter for the `FHE::apply_many_lookup_tables` operation.
+///
+/// The crt wop-pbs has no many-lut variant, the packed table is hence split
+/// back into its interleaved tables, each one evaluated with its own wop-pbs.
+struct ApplyManyLookupTablesEintOpPattern
+    : public CrtOpPattern<FHE::ApplyManyLookupTablesEintOp> {
+
+  ApplyManyLookupTablesEintOpPattern(
+      mlir::MLIRContext *context,
+      mlir::concretelang::CrtLoweringParameters params,
+      mlir::PatternBenefit benefit = 1)
+      : CrtOpPattern<FHE::ApplyManyLookupTablesEintOp>(context, params,
+                                                       benefit) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(FHE::ApplyManyLookupTablesEintOp op,
+                  FHE::ApplyManyLookupTablesEintOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    mlir::TypeConverter *converter = this->getTypeConverter();
+
+    auto originalInputType =
+        op.getA().getType().cast<FHE::FheIntegerInterface>();
+    int64_t lutSize =
+        op.getLut().getType().cast<mlir::RankedTensorType>().getDimSize(0);
+    int64_t singleLutSize = (int64_t)1 << originalInputType.getWidth();
+    int64_t stride = lutSize / singleLutSize;
+
+    mlir::SmallVector<mlir::Value> results;
+    for (auto [j, result] : llvm::enumerate(op.getResults())) {
+      // The `j`-th table is made of the entries `j + k * 2^q`
+      mlir::Value singleLut = rewriter.create<mlir::tensor::ExtractSliceOp>(
+          op.getLoc(),
+          mlir::RankedTensorType::get(
+              {singleLutSize}, adaptor.getLut()
+                                   .getType()
+                                   .cast<mlir::RankedTensorType>()
+                                   .getElementType()),
+          adaptor.getLut(), mlir::ValueRange{}, mlir::ValueRange{},
+          mlir::ValueRange{}, rewriter.getDenseI64ArrayAttr({(int64_t)j}),
+          rewriter.getDenseI64ArrayAttr({singleLutSize}),
+          rewriter.getDenseI64ArrayAttr({stride}));
+
+      mlir::Value newLut =
+          rewriter
+              .create<TFHE::EncodeLutForCrtWopPBSOp>(
+                  op.getLoc(),
+                  mlir::RankedTensorType::get(
+                      mlir::ArrayRef<int64_t>{
+                          (int64_t)loweringParameters.nMods,
+                          (int64_t)loweringParameters.singleLutSize},
+                      rewriter.getI64Type()),
+                  singleLut,
+                  rewriter.getI64ArrayAttr(
+                      mlir::ArrayRef<int64_t>(loweringParameters.mods)),
+                  rewriter.getI64ArrayAttr(
+                      mlir::ArrayRef<int64_t>(loweringParameters.bits)),
+                  rewriter.getI32IntegerAttr(loweringParameters.modsProd),
+                  rewriter.getBoolAttr(originalInputType.isSigned()))
+              .getResult();
+
+      auto wopPBS = rewriter.create<TFHE::WopPBSGLWEOp>(
+          op.getLoc(), converter->convertType(result.getType()),
+          adaptor.getA(), newLut,
+          TFHE::GLWEKeyswitchKeyAttr::get(op.getContext(),
+                                          TFHE::GLWESecretKey(),
+                                          TFHE::GLWESecretKey(), -1, -1, -1),
+          TFHE::GLWEBootstrapKeyAttr::get(
+              op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(),
+              -1, -1, -1, -1, -1),
+          TFHE::GLWEPackingKeyswitchKeyAttr::get(
+              op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(),
+              -1, -1, -1, -1, -1, -1),
+          rewriter.getI64ArrayAttr({}), rewriter.getI32IntegerAttr(-1),
+          rewriter.getI32IntegerAttr(-1));
+      results.push_back(wopPBS.getResult());
+    }
+
+    rewriter.replaceOp(op, results);
+    return ::mlir::success();
+  };
+};
+
 /// Rewriter for the `Tracing::trace_ciphertext` operation.
 struct TraceCiphertextOpPattern : CrtOpPattern<Tracing::TraceCiphertextOp> {
 
@@ -1041,8 +1123,10 @@ struct FHEToTFHECrtPass : public FHEToTFHECrtBase<FHEToTFHECrtPass> {
                  //    |_ `FHE::to_signed`
                  lowering::ToSignedOpPattern,
                  //    |_ `FHE::apply_lookup_table`
-                 lowering::ApplyLookupTableEintOpPattern>(&getContext(),
-                                                          loweringParameters);
+                 lowering::ApplyLookupTableEintOpPattern,
+                 //    |_ `FHE::apply_many_lookup_tables`
+                 lowering::ApplyManyLookupTablesEintOpPattern>(
+        &getContext(), loweringParameters);
 
     // Patterns for the relics of the `FHELinalg` dialect operations.
     //    |_ `linalg::generic` turned to nested `scf::for`
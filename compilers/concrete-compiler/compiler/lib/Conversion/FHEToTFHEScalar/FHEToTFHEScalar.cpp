@@ -24,6 +24,8 @@
 #include "concretelang/Dialect/FHE/IR/FHEDialect.h"
 #include "concretelang/Dialect/FHE/IR/FHEOps.h"
 #include "concretelang/Dialect/FHE/IR/FHETypes.h"
+#include "concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h"
+#include "concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h"
 #include "concretelang/Dialect/RT/IR/RTDialect.h"
 #include "concretelang/Dialect/RT/IR/RTOps.h"
 #include "concretelang/Dialect/RT/IR/RTTypes.h"
@@ -35,6 +37,7 @@
 #include "concretelang/Support/logging.h"
 
 namespace FHE = mlir::concretelang::FHE;
+namespace FHELinalg = mlir::concretelang::FHELinalg;
 namespace TFHE = mlir::concretelang::TFHE;
 namespace Tracing = mlir::concretelang::Tracing;
 
@@ -351,6 +354,106 @@ struct MulEintIntOpPattern : public ScalarOpPattern<FHE::MulEintIntOp> {
   }
 };
 
+/// Sign-extends a tensor of cleartexts to 64 bits using a `linalg.generic`, so
+/// that it can be consumed by the dense matrix product kernel.
+inline mlir::Value extendCleartextTensor(mlir::Location location,
+                                         mlir::Value cleartexts,
+                                         mlir::OpBuilder &rewriter) {
+  auto type = cleartexts.getType().cast<mlir::RankedTensorType>();
+  auto extendedType =
+      mlir::RankedTensorType::get(type.getShape(), rewriter.getI64Type());
+  mlir::Value init = rewriter.create<mlir::tensor::EmptyOp>(
+      location, extendedType.getShape(), extendedType.getElementType());
+  llvm::SmallVector<mlir::AffineMap, 2> maps(
+      2, rewriter.getMultiDimIdentityMap(type.getRank()));
+  llvm::SmallVector<mlir::utils::IteratorType> iteratorTypes(
+      type.getRank(), mlir::utils::IteratorType::parallel);
+
+  return rewriter
+      .create<mlir::linalg::GenericOp>(
+          location, extendedType, cleartexts, init, maps, iteratorTypes,
+          [&](mlir::OpBuilder &b, mlir::Location loc, mlir::ValueRange args) {
+            mlir::Value extended = b.create<mlir::arith::ExtSIOp>(
+                loc, b.getIntegerType(64), args[0]);
+            b.create<mlir::linalg::YieldOp>(loc, extended);
+          })
+      .getResult(0);
+}
+
+/// Rewriter for the `FHELinalg::matmul_eint_int` operation on matrices, which
+/// is only left until this point when the dense matrix product kernel is
+/// requested.
+struct MatMulEintIntOpPattern
+    : public mlir::OpConversionPattern<FHELinalg::MatMulEintIntOp> {
+  MatMulEintIntOpPattern(mlir::TypeConverter &converter,
+                         mlir::MLIRContext *context,
+                         mlir::PatternBenefit benefit = 1)
+      : mlir::OpConversionPattern<FHELinalg::MatMulEintIntOp>(
+            converter, context, benefit) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(FHELinalg::MatMulEintIntOp op,
+                  FHELinalg::MatMulEintIntOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getType().cast<mlir::RankedTensorType>();
+    if (resultType.getRank() != 2)
+      return mlir::failure();
+
+    mlir::Value cleartexts =
+        extendCleartextTensor(op.getLoc(), adaptor.getRhs(), rewriter);
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::MatMulGLWEIntOp>(
+        op, getTypeConverter()->convertType(resultType), adaptor.getLhs(),
+        cleartexts);
+    forwardOptimizerID(op, newOp);
+    markOpIfSigned(newOp, resultType.getElementType()
+                              .cast<FHE::FheIntegerInterface>());
+
+    return mlir::success();
+  }
+};
+
+/// Rewriter for the `FHELinalg::dot_eint_int` operation, which is only left
+/// until this point when the dense matrix product kernel is requested. The
+/// dot product is computed as the product of a `1xN` and a `Nx1` matrix.
+struct DotEintIntOpPattern : public mlir::OpConversionPattern<FHELinalg::Dot> {
+  DotEintIntOpPattern(mlir::TypeConverter &converter,
+                      mlir::MLIRContext *context,
+                      mlir::PatternBenefit benefit = 1)
+      : mlir::OpConversionPattern<FHELinalg::Dot>(converter, context, benefit) {
+  }
+
+  mlir::LogicalResult
+  matchAndRewrite(FHELinalg::Dot op, FHELinalg::Dot::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    mlir::Location location = op.getLoc();
+    auto lhsType = adaptor.getLhs().getType().cast<mlir::RankedTensorType>();
+    int64_t size = lhsType.getDimSize(0);
+    auto glweType = getTypeConverter()->convertType(op.getType());
+
+    mlir::Value row = rewriter.create<mlir::tensor::ExpandShapeOp>(
+        location, mlir::RankedTensorType::get({1, size}, glweType),
+        adaptor.getLhs(),
+        llvm::SmallVector<mlir::ReassociationIndices>{{0, 1}});
+    mlir::Value cleartexts =
+        extendCleartextTensor(location, adaptor.getRhs(), rewriter);
+    mlir::Value column = rewriter.create<mlir::tensor::ExpandShapeOp>(
+        location, mlir::RankedTensorType::get({size, 1}, rewriter.getI64Type()),
+        cleartexts, llvm::SmallVector<mlir::ReassociationIndices>{{0, 1}});
+
+    auto matmul = rewriter.create<TFHE::MatMulGLWEIntOp>(
+        location, mlir::RankedTensorType::get({1, 1}, glweType), row, column);
+    forwardOptimizerID(op, matmul);
+    markOpIfSigned(matmul, op.getType().cast<FHE::FheIntegerInterface>());
+
+    mlir::Value zero =
+        rewriter.create<mlir::arith::ConstantIndexOp>(location, 0);
+    rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
+        op, matmul.getResult(), mlir::ValueRange{zero, zero});
+
+    return mlir::success();
+  }
+};
+
 /// Rewriter for the `FHE::apply_lookup_table` operation.
 struct ApplyLookupTableEintOpPattern
     : public ScalarOpPattern<FHE::ApplyLookupTableEintOp> {
@@ -447,6 +550,117 @@ private:
   mlir::concretelang::ScalarLoweringParameters loweringParameters;
 };
 
+/// Rewriter for the `FHE::apply_many_lookup_tables` operation.
+///
+/// The packed table of `2^(p+q)` entries is expanded as a single lookup table
+/// of `p+q` bits, so that a single blind rotation places the `j`-th result at
+/// the degree `j * (polySize >> (p+q))` of the accumulator.
+struct ApplyManyLookupTablesEintOpPattern
+    : public ScalarOpPattern<FHE::ApplyManyLookupTablesEintOp> {
+  ApplyManyLookupTablesEintOpPattern(
+      mlir::TypeConverter &converter, mlir::MLIRContext *context,
+      mlir::concretelang::ScalarLoweringParameters loweringParams,
+      mlir::PatternBenefit benefit = 1)
+      : ScalarOpPattern<FHE::ApplyManyLookupTablesEintOp>(converter, context,
+                                                          benefit),
+        loweringParameters(loweringParams) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(FHE::ApplyManyLookupTablesEintOp op,
+                  FHE::ApplyManyLookupTablesEintOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    auto inputType = op.getA().getType().cast<FHE::FheIntegerInterface>();
+    size_t outputBits = op.getResult(0)
+                            .getType()
+                            .cast<FHE::FheIntegerInterface>()
+                            .getWidth();
+    int64_t lutSize =
+        op.getLut().getType().cast<mlir::RankedTensorType>().getDimSize(0);
+    mlir::Value newLut =
+        rewriter
+            .create<TFHE::EncodeExpandLutForBootstrapOp>(
+                op.getLoc(),
+                mlir::RankedTensorType::get(
+                    mlir::ArrayRef<int64_t>(loweringParameters.polynomialSize),
+                    rewriter.getI64Type()),
+                op.getLut(),
+                rewriter.getI32IntegerAttr(loweringParameters.polynomialSize),
+                rewriter.getI32IntegerAttr(outputBits),
+                rewriter.getBoolAttr(inputType.isSigned()))
+            .getResult();
+
+    typing::TypeConverter converter;
+    mlir::Value input = adaptor.getA();
+
+    auto operatorIndexes =
+        op->getAttrOfType<mlir::DenseI32ArrayAttr>("TFHE.OId");
+
+    if (inputType.isSigned()) {
+      // Same offset as for `FHE::apply_lookup_table`: shifting the `p`-bit
+      // input by `2^(p-1)` shifts the packed index by `2^(p+q-1)`, which
+      // matches the signed expansion of the packed table.
+      uint64_t constantRaw = (uint64_t)1 << (inputType.getWidth() - 1);
+      mlir::Value constant = rewriter.create<mlir::arith::ConstantOp>(
+          op.getLoc(),
+          rewriter.getIntegerAttr(
+              rewriter.getIntegerType(inputType.getWidth() + 1), constantRaw));
+      mlir::Value encodedConstant = writePlaintextShiftEncoding(
+          op.getLoc(), constant, inputType.getWidth(), rewriter);
+      auto inputOp = rewriter.create<TFHE::AddGLWEIntOp>(
+          op.getLoc(), converter.convertType(input.getType()), input,
+          encodedConstant);
+      if (operatorIndexes != nullptr) {
+        assert(operatorIndexes.size() == 2);
+        inputOp->setAttr("TFHE.OId",
+                         rewriter.getI32IntegerAttr(operatorIndexes[0]));
+      }
+      input = inputOp;
+    }
+
+    // Insert keyswitch
+    auto ksOp = rewriter.create<TFHE::KeySwitchGLWEOp>(
+        op.getLoc(), getTypeConverter()->convertType(adaptor.getA().getType()),
+        input,
+        TFHE::GLWEKeyswitchKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
+                                        TFHE::GLWESecretKey(), -1, -1, -1));
+    if (operatorIndexes != nullptr) {
+      ksOp->setAttr("TFHE.OId",
+                    rewriter.getI32IntegerAttr(
+                        operatorIndexes[operatorIndexes.size() - 1]));
+    }
+
+    // Insert the many-lut bootstrap
+    auto glweType = getTypeConverter()->convertType(op.getResult(0).getType());
+    int64_t numResults = op.getNumResults();
+    auto bsOp = rewriter.create<TFHE::ManyBootstrapGLWEOp>(
+        op.getLoc(), mlir::RankedTensorType::get({numResults}, glweType), ksOp,
+        newLut,
+        TFHE::GLWEBootstrapKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
+                                        TFHE::GLWESecretKey(), -1, -1, -1, -1,
+                                        -1),
+        rewriter.getI32IntegerAttr(llvm::Log2_64(lutSize)));
+    if (operatorIndexes != nullptr) {
+      bsOp->setAttr("TFHE.OId",
+                    rewriter.getI32IntegerAttr(
+                        operatorIndexes[operatorIndexes.size() - 1]));
+    }
+
+    mlir::SmallVector<mlir::Value> results;
+    for (int64_t i = 0; i < numResults; i++) {
+      mlir::Value idx =
+          rewriter.create<mlir::arith::ConstantIndexOp>(op.getLoc(), i);
+      results.push_back(rewriter.create<mlir::tensor::ExtractOp>(
+          op.getLoc(), bsOp.getResult(), mlir::ValueRange{idx}));
+    }
+    rewriter.replaceOp(op, results);
+    return mlir::success();
+  };
+
+private:
+  mlir::concretelang::ScalarLoweringParameters loweringParameters;
+};
+
 template <typename Op>
 std::vector<mlir::Value> extractBitWithClearedLowerBits(
     Op op, mlir::Type inputType, uint64_t inputBitwidth,
@@ -801,6 +1015,7 @@ struct FHEToTFHEScalarPass : public FHEToTFHEScalarBase<FHEToTFHEScalarPass> {
 
     //------------------------------------------- Marking legal/illegal dialects
     target.addIllegalDialect<FHE::FHEDialect>();
+    target.addIllegalOp<FHELinalg::MatMulEintIntOp, FHELinalg::Dot>();
     target.addLegalDialect<TFHE::TFHEDialect>();
     target.addLegalDialect<mlir::arith::ArithDialect>();
     target.addDynamicallyLegalOp<mlir::linalg::GenericOp,
@@ -866,12 +1081,21 @@ struct FHEToTFHEScalarPass : public FHEToTFHEScalarBase<FHEToTFHEScalarPass> {
                                                                 &getContext());
     //    |_ `FHE::apply_lookup_table`
     patterns.add<lowering::ApplyLookupTableEintOpPattern,
+                 //    |_ `FHE::apply_many_lookup_tables`
+                 lowering::ApplyManyLookupTablesEintOpPattern,
                  //    |_ `FHE::round`
                  lowering::RoundEintOpPattern,
                  //    |_ `FHE::lsb`
                  lowering::LsbEintOpPattern>(converter, &getContext(),
                                              loweringParameters);
 
+    // Patterns for the `FHELinalg` operations kept for the dense matrix
+    // product kernel
+    //    |_ `FHELinalg::matmul_eint_int`
+    patterns.add<lowering::MatMulEintIntOpPattern,
+                 //    |_ `FHELinalg::dot_eint_int`
+                 lowering::DotEintIntOpPattern>(converter, &getContext());
+
     // Patterns for boolean conversion ops
     patterns.add<lowering::FromBoolOpPattern, lowering::ToBoolOpPattern>(
         &getContext());
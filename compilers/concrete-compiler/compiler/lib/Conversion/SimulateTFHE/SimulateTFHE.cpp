@@ -592,6 +592,105 @@ struct BootstrapGLWEOpPattern
   }
 };
 
+/// Simulates the many lookup tables bootstrap as one simulated bootstrap per
+/// result, the `i`-th one on the input whose phase is shifted by `i` entries of
+/// the packed lookup table. This matches the sample extraction at degree `i *
+/// lutStride` of the accumulator rotated by the input.
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp> {
+
+  bool overflowDetection;
+
+  ManyBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                             mlir::TypeConverter &typeConverter,
+                             bool overflowDetection)
+      : mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        overflowDetection(overflowDetection) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp bsOp,
+                  TFHE::ManyBootstrapGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    const std::string funcName = "sim_bootstrap_lwe_u64";
+
+    TFHE::GLWECipherTextType inputType =
+        bsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+    auto resultType = bsOp.getType().cast<mlir::RankedTensorType>();
+
+    auto polySize = adaptor.getKey().getPolySize();
+    auto glweDimension = adaptor.getKey().getGlweDim();
+    auto levels = adaptor.getKey().getLevels();
+    auto baseLog = adaptor.getKey().getBaseLog();
+    auto inputLweDimension =
+        inputType.getKey().getNormalized().value().dimension;
+
+    auto polySizeCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), polySize, 32);
+    auto glweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), glweDimension, 32);
+    auto levelsCst =
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), levels, 32);
+    auto baseLogCst =
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), baseLog, 32);
+    auto inputLweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), inputLweDimension, 32);
+    auto overflowDetectionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), overflowDetection, 1);
+
+    auto dynamicLutType = toDynamicTensorType(bsOp.getLookupTable().getType());
+
+    mlir::Value castedLUT = rewriter.create<mlir::tensor::CastOp>(
+        bsOp.getLoc(), dynamicLutType, adaptor.getLookupTable());
+
+    auto locString = globalStringValueFromLoc(rewriter, bsOp.getLoc());
+
+    if (insertForwardDeclaration(
+            bsOp, rewriter, funcName,
+            rewriter.getFunctionType(
+                {rewriter.getIntegerType(64), dynamicLutType,
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(1),
+                 mlir::LLVM::LLVMPointerType::get(rewriter.getI8Type())},
+                {rewriter.getIntegerType(64)}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    // An entry of the packed lookup table spans `2^(63 - lutWidth)` of the
+    // torus, the padding bit included
+    uint64_t entryPhase = (uint64_t)1 << (63 - bsOp.getLutWidth());
+
+    llvm::SmallVector<mlir::Value> results;
+    for (int64_t i = 0; i < resultType.getShape()[0]; i++) {
+      mlir::Value input = adaptor.getCiphertext();
+      if (i > 0) {
+        mlir::Value shiftCst = rewriter.create<mlir::arith::ConstantIntOp>(
+            bsOp.getLoc(), i * entryPhase, 64);
+        input = rewriter.create<mlir::arith::AddIOp>(bsOp.getLoc(), input,
+                                                     shiftCst);
+      }
+      results.push_back(
+          rewriter
+              .create<mlir::func::CallOp>(
+                  bsOp.getLoc(), funcName, rewriter.getIntegerType(64),
+                  mlir::ValueRange({input, castedLUT, inputLweDimensionCst,
+                                    polySizeCst, levelsCst, baseLogCst,
+                                    glweDimensionCst, overflowDetectionCst,
+                                    locString}))
+              .getResult(0));
+    }
+
+    rewriter.replaceOpWithNewOp<mlir::tensor::FromElementsOp>(
+        bsOp, this->getTypeConverter()->convertType(resultType), results);
+
+    return mlir::success();
+  }
+};
+
 struct KeySwitchGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::KeySwitchGLWEOp> {
 
@@ -806,8 +905,9 @@ void SimulateTFHEPass::runOnOperation() {
         return converter.isLegal(forallOp.getResults().getTypes());
       });
 
-  patterns.insert<EncodeExpandLutForBootstrapOpPattern, BootstrapGLWEOpPattern>(
-      &getContext(), converter, enableOverflowDetection);
+  patterns.insert<EncodeExpandLutForBootstrapOpPattern, BootstrapGLWEOpPattern,
+                  ManyBootstrapGLWEOpPattern>(&getContext(), converter,
+                                              enableOverflowDetection);
 
   patterns.insert<ZeroOpPattern, ZeroTensorOpPattern, KeySwitchGLWEOpPattern,
                   WopPBSGLWEOpPattern, EncodeLutForCrtWopPBSOpPattern,
@@ -171,6 +171,44 @@ private:
   const mlir::concretelang::V0Parameter cryptoParameters;
 };
 
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpRewritePattern<TFHE::ManyBootstrapGLWEOp> {
+  ManyBootstrapGLWEOpPattern(
+      mlir::MLIRContext *context,
+      TFHEGlobalParametrizationTypeConverter &converter,
+      const mlir::concretelang::V0Parameter cryptoParameters,
+      mlir::PatternBenefit benefit =
+          mlir::concretelang::DEFAULT_PATTERN_BENEFIT)
+      : mlir::OpRewritePattern<TFHE::ManyBootstrapGLWEOp>(context, benefit),
+        converter(converter), cryptoParameters(cryptoParameters) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp bsOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto inputTy =
+        bsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+    auto newInputTy = converter.glweIntraPBSType(inputTy);
+    auto newOutputTy = converter.convertType(bsOp.getResult().getType());
+    auto newInputKey = converter.getIntraPBSKey();
+    auto newOutputKey = converter.getInterPBSKey();
+    auto bootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
+        bsOp->getContext(), newInputKey, newOutputKey,
+        cryptoParameters.getPolynomialSize(), cryptoParameters.glweDimension,
+        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1);
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::ManyBootstrapGLWEOp>(
+        bsOp, newOutputTy, bsOp.getCiphertext(), bsOp.getLookupTable(),
+        bootstrapKey, bsOp.getLutWidthAttr());
+    rewriter.startRootUpdate(newOp);
+    newOp.getCiphertext().setType(newInputTy);
+    rewriter.finalizeRootUpdate(newOp);
+    return mlir::success();
+  };
+
+private:
+  TFHEGlobalParametrizationTypeConverter &converter;
+  const mlir::concretelang::V0Parameter cryptoParameters;
+};
+
 struct WopPBSGLWEOpPattern : public mlir::OpRewritePattern<TFHE::WopPBSGLWEOp> {
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       TFHEGlobalParametrizationTypeConverter &converter,
@@ -259,6 +297,9 @@ void populateWithTFHEOpTypeConversionPatterns(
       patterns, target, typeConverter);
   populateWithTFHEOpTypeConversionPattern<
       mlir::concretelang::TFHE::MulGLWEIntOp>(patterns, target, typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::MatMulGLWEIntOp>(patterns, target,
+                                                 typeConverter);
 }
 
 void TFHEGlobalParametrizationPass::runOnOperation() {
@@ -313,6 +354,18 @@ void TFHEGlobalParametrizationPass::runOnOperation() {
                  op.getKeyAttr().getPolySize() != -1;
         });
 
+    patterns.add<ManyBootstrapGLWEOpPattern>(&getContext(), converter,
+                                             cryptoParameters);
+    target.addDynamicallyLegalOp<TFHE::ManyBootstrapGLWEOp>(
+        [&](TFHE::ManyBootstrapGLWEOp op) {
+          return op.getKeyAttr().getInputKey().isParameterized() &&
+                 op.getKeyAttr().getOutputKey().isParameterized() &&
+                 op.getKeyAttr().getLevels() != -1 &&
+                 op.getKeyAttr().getBaseLog() != -1 &&
+                 op.getKeyAttr().getGlweDim() != -1 &&
+                 op.getKeyAttr().getPolySize() != -1;
+        });
+
     // Parametrize wop pbs
     patterns.add<WopPBSGLWEOpPattern>(&getContext(), converter,
                                       cryptoParameters);
@@ -204,6 +204,37 @@ private:
   conversion::TypeConverter &typeConverter;
 };
 
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpRewritePattern<TFHE::ManyBootstrapGLWEOp> {
+  ManyBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                             conversion::TypeConverter &typeConverter,
+                             conversion::KeyConverter &keyConverter,
+                             mlir::PatternBenefit benefit =
+                                 mlir::concretelang::DEFAULT_PATTERN_BENEFIT)
+      : mlir::OpRewritePattern<TFHE::ManyBootstrapGLWEOp>(context, benefit),
+        keyConverter(keyConverter), typeConverter(typeConverter) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp bsOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto newInputTy = typeConverter.convertType(bsOp.getCiphertext().getType())
+                          .cast<GLWECipherTextType>();
+    auto newOutputTy = typeConverter.convertType(bsOp.getResult().getType());
+    auto newBootstrapKey = keyConverter.convertBootstrapKey(bsOp.getKeyAttr());
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::ManyBootstrapGLWEOp>(
+        bsOp, newOutputTy, bsOp.getCiphertext(), bsOp.getLookupTable(),
+        newBootstrapKey, bsOp.getLutWidthAttr());
+    rewriter.startRootUpdate(newOp);
+    newOp.getCiphertext().setType(newInputTy);
+    rewriter.finalizeRootUpdate(newOp);
+    return mlir::success();
+  };
+
+private:
+  conversion::KeyConverter &keyConverter;
+  conversion::TypeConverter &typeConverter;
+};
+
 struct WopPBSGLWEOpPattern : public mlir::OpRewritePattern<TFHE::WopPBSGLWEOp> {
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       conversion::TypeConverter &typeConverter,
@@ -280,6 +311,9 @@ void populateWithTFHEOpTypeConversionPatterns(
       patterns, target, typeConverter);
   populateWithTFHEOpTypeConversionPattern<
       mlir::concretelang::TFHE::MulGLWEIntOp>(patterns, target, typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::MatMulGLWEIntOp>(patterns, target,
+                                                 typeConverter);
 }
 } // namespace
 
@@ -341,6 +375,15 @@ void TFHEKeyNormalizationPass::runOnOperation() {
                  op.getKeyAttr().getIndex() != -1;
         });
 
+    patterns.add<patterns::ManyBootstrapGLWEOpPattern>(
+        &getContext(), typeConverter, keyConverter);
+    target.addDynamicallyLegalOp<TFHE::ManyBootstrapGLWEOp>(
+        [&](TFHE::ManyBootstrapGLWEOp op) {
+          return op.getKeyAttr().getInputKey().isNormalized() &&
+                 op.getKeyAttr().getOutputKey().isNormalized() &&
+                 op.getKeyAttr().getIndex() != -1;
+        });
+
     // Parametrize wop pbs
     patterns.add<patterns::WopPBSGLWEOpPattern>(&getContext(), typeConverter,
                                                 keyConverter);
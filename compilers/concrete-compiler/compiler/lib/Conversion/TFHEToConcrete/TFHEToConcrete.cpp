@@ -6,9 +6,11 @@
 #include <iostream>
 #include <mlir/Dialect/Bufferization/IR/Bufferization.h>
 
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "concretelang/Common/Lut.h"
 #include "concretelang/Conversion/Passes.h"
 #include "concretelang/Conversion/Utils/Dialects/SCF.h"
 #include "concretelang/Conversion/Utils/FuncConstOpConversion.h"
@@ -145,6 +147,41 @@ struct BootstrapGLWEOpPattern
   }
 };
 
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp> {
+
+  ManyBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                             mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp mbsOp,
+                  TFHE::ManyBootstrapGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    TFHE::GLWECipherTextType inputType =
+        mbsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+
+    auto polySize = adaptor.getKey().getPolySize();
+    auto glweDimension = adaptor.getKey().getGlweDim();
+    auto levels = adaptor.getKey().getLevels();
+    auto baseLog = adaptor.getKey().getBaseLog();
+    auto inputLweDimension =
+        inputType.getKey().getNormalized().value().dimension;
+    auto bskIndex = mbsOp.getKeyAttr().getIndex();
+    // Consecutive entries of the packed lookup table are one box apart
+    auto lutStride = polySize >> mbsOp.getLutWidth();
+
+    rewriter.replaceOpWithNewOp<Concrete::ManyBootstrapLweTensorOp>(
+        mbsOp, this->getTypeConverter()->convertType(mbsOp.getType()),
+        adaptor.getCiphertext(), adaptor.getLookupTable(), inputLweDimension,
+        polySize, levels, baseLog, glweDimension, lutStride, bskIndex);
+
+    return mlir::success();
+  }
+};
+
 struct WopPBSGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::WopPBSGLWEOp> {
 
@@ -185,6 +222,44 @@ struct WopPBSGLWEOpPattern
   }
 };
 
+/// Encodes and expands a constant lookup table at compile time, so that the
+/// expanded table becomes a global constant of the program instead of being
+/// computed by the runtime on every execution.
+struct ConstantEncodeExpandLutForBootstrapOpPattern
+    : public mlir::OpConversionPattern<TFHE::EncodeExpandLutForBootstrapOp> {
+
+  ConstantEncodeExpandLutForBootstrapOpPattern(
+      mlir::MLIRContext *context, mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::EncodeExpandLutForBootstrapOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT + 1) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::EncodeExpandLutForBootstrapOp op,
+                  TFHE::EncodeExpandLutForBootstrapOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    mlir::DenseIntElementsAttr inputAttr;
+    if (!mlir::matchPattern(adaptor.getInputLookupTable(),
+                            mlir::m_Constant(&inputAttr)))
+      return mlir::failure();
+
+    llvm::SmallVector<uint64_t> input;
+    for (auto value : inputAttr.getValues<llvm::APInt>())
+      input.push_back(value.getZExtValue());
+    auto resultType = op.getType().cast<mlir::RankedTensorType>();
+    llvm::SmallVector<uint64_t> output(resultType.getNumElements());
+
+    concretelang::lut::encodeExpandForBootstrap(
+        input.data(), input.size(), output.data(), output.size(),
+        op.getOutputBits(), op.getIsSigned());
+
+    rewriter.replaceOpWithNewOp<mlir::arith::ConstantOp>(
+        op, mlir::DenseIntElementsAttr::get(resultType, output));
+
+    return mlir::success();
+  }
+};
+
 struct BatchedBootstrapGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::BatchedBootstrapGLWEOp> {
 
@@ -890,7 +965,13 @@ void TFHEToConcretePass::runOnOperation() {
           mlir::concretelang::Concrete::BatchedMulCleartextCstLweTensorOp>,
       mlir::concretelang::GenericOneToOneOpConversionPattern<
           mlir::concretelang::TFHE::BatchedNegGLWEOp,
-          mlir::concretelang::Concrete::BatchedNegateLweTensorOp>
+          mlir::concretelang::Concrete::BatchedNegateLweTensorOp>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::BatchedMulAddGLWEIntOp,
+          mlir::concretelang::Concrete::BatchedMulCleartextAddLweTensorOp>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::MatMulGLWEIntOp,
+          mlir::concretelang::Concrete::MatMulCleartextLweTensorOp>
 
       >(&getContext(), converter);
   // pattern of remaining TFHE ops
@@ -898,10 +979,11 @@ void TFHEToConcretePass::runOnOperation() {
   patterns.insert<ZeroOpPattern<mlir::concretelang::TFHE::ZeroGLWEOp>,
                   ZeroOpPattern<mlir::concretelang::TFHE::ZeroTensorGLWEOp>,
                   SubIntGLWEOpPattern, BootstrapGLWEOpPattern,
-                  BatchedBootstrapGLWEOpPattern,
+                  ManyBootstrapGLWEOpPattern, BatchedBootstrapGLWEOpPattern,
                   BatchedMappedBootstrapGLWEOpPattern, KeySwitchGLWEOpPattern,
-                  BatchedKeySwitchGLWEOpPattern, WopPBSGLWEOpPattern>(
-      &getContext(), converter);
+                  BatchedKeySwitchGLWEOpPattern, WopPBSGLWEOpPattern,
+                  ConstantEncodeExpandLutForBootstrapOpPattern>(&getContext(),
+                                                                converter);
 
   // Add patterns to rewrite tensor operators that works on tensors of TFHE GLWE
   // types
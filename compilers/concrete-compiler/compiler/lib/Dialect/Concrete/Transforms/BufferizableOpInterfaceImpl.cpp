@@ -93,6 +93,70 @@ struct TensorToMemrefOp : public BufferizableOpInterface::ExternalModel<
   }
 };
 
+/// Bufferizes a batched leveled operation in place of the buffer of its first
+/// operand, the runtime computing each coefficient of the result from the
+/// coefficients of the operands of the same index. The one-shot bufferization
+/// analysis inserts a copy of the operand when its buffer is still needed
+/// afterwards or cannot be written, e.g. a function argument.
+template <typename TensorOp, typename MemrefOp>
+struct TensorToMemrefInPlaceOp
+    : public BufferizableOpInterface::ExternalModel<
+          TensorToMemrefInPlaceOp<TensorOp, MemrefOp>, TensorOp> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return true;
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return opOperand.getOperandNumber() == 0;
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    if (opOperand.getOperandNumber() != 0)
+      return {};
+    return {{op->getOpResult(0), BufferRelation::Equivalent}};
+  }
+
+  BufferRelation bufferRelation(Operation *op, OpResult opResult,
+                                const AnalysisState &state) const {
+    return BufferRelation::Equivalent;
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    auto loc = op->getLoc();
+
+    auto outMemref =
+        bufferization::getBuffer(rewriter, op->getOperand(0), options);
+    if (mlir::failed(outMemref)) {
+      return mlir::failure();
+    }
+
+    // The first operand is the result, and also the first input
+    mlir::SmallVector<mlir::Value, 4> operands{
+        *outMemref,
+    };
+    for (auto &operand : op->getOpOperands()) {
+      if (!operand.get().getType().isa<mlir::RankedTensorType>()) {
+        operands.push_back(operand.get());
+      } else if (operand.getOperandNumber() == 0) {
+        operands.push_back(*outMemref);
+      } else {
+        operands.push_back(
+            *bufferization::getBuffer(rewriter, operand.get(), options));
+      }
+    }
+
+    rewriter.create<MemrefOp>(loc, mlir::TypeRange{}, operands, op->getAttrs());
+
+    replaceOpWithBufferizedValues(rewriter, op, *outMemref);
+
+    return success();
+  }
+};
+
 } // namespace
 
 void mlir::concretelang::Concrete::
@@ -123,33 +187,51 @@ void mlir::concretelang::Concrete::
     // bootstrap_lwe_tensor => bootstrap_lwe_buffer
     Concrete::BootstrapLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::BootstrapLweTensorOp, Concrete::BootstrapLweBufferOp>>(*ctx);
+    // many_bootstrap_lwe_tensor => many_bootstrap_lwe_buffer
+    Concrete::ManyBootstrapLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::ManyBootstrapLweTensorOp,
+                         Concrete::ManyBootstrapLweBufferOp>>(*ctx);
 
     // batched_add_lwe_tensor => batched_add_lwe_buffer
-    Concrete::BatchedAddLweTensorOp::attachInterface<TensorToMemrefOp<
+    Concrete::BatchedAddLweTensorOp::attachInterface<TensorToMemrefInPlaceOp<
         Concrete::BatchedAddLweTensorOp, Concrete::BatchedAddLweBufferOp>>(
         *ctx);
     // batched_add_plaintext_lwe_tensor => batched_add_plaintext_lwe_buffer
     Concrete::BatchedAddPlaintextLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedAddPlaintextLweTensorOp,
-                         Concrete::BatchedAddPlaintextLweBufferOp>>(*ctx);
+        TensorToMemrefInPlaceOp<Concrete::BatchedAddPlaintextLweTensorOp,
+                                Concrete::BatchedAddPlaintextLweBufferOp>>(
+        *ctx);
     // batched_add_plaintext_cst_lwe_tensor =>
     // batched_add_plaintext_cst_lwe_buffer
     Concrete::BatchedAddPlaintextCstLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedAddPlaintextCstLweTensorOp,
-                         Concrete::BatchedAddPlaintextCstLweBufferOp>>(*ctx);
+        TensorToMemrefInPlaceOp<Concrete::BatchedAddPlaintextCstLweTensorOp,
+                                Concrete::BatchedAddPlaintextCstLweBufferOp>>(
+        *ctx);
     // batched_mul_cleartext_lwe_tensor => batched_mul_cleartext_lwe_buffer
     Concrete::BatchedMulCleartextLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedMulCleartextLweTensorOp,
-                         Concrete::BatchedMulCleartextLweBufferOp>>(*ctx);
+        TensorToMemrefInPlaceOp<Concrete::BatchedMulCleartextLweTensorOp,
+                                Concrete::BatchedMulCleartextLweBufferOp>>(
+        *ctx);
     // batched_mul_cleartext_cst_lwe_tensor =>
     // batched_mul_cleartext_cst_lwe_buffer
     Concrete::BatchedMulCleartextCstLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedMulCleartextCstLweTensorOp,
-                         Concrete::BatchedMulCleartextCstLweBufferOp>>(*ctx);
+        TensorToMemrefInPlaceOp<Concrete::BatchedMulCleartextCstLweTensorOp,
+                                Concrete::BatchedMulCleartextCstLweBufferOp>>(
+        *ctx);
+    // batched_mul_cleartext_add_lwe_tensor =>
+    // batched_mul_cleartext_add_lwe_buffer
+    Concrete::BatchedMulCleartextAddLweTensorOp::attachInterface<
+        TensorToMemrefInPlaceOp<Concrete::BatchedMulCleartextAddLweTensorOp,
+                                Concrete::BatchedMulCleartextAddLweBufferOp>>(
+        *ctx);
     // batched_negate_lwe_tensor => batched_negate_lwe_buffer
     Concrete::BatchedNegateLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedNegateLweTensorOp,
-                         Concrete::BatchedNegateLweBufferOp>>(*ctx);
+        TensorToMemrefInPlaceOp<Concrete::BatchedNegateLweTensorOp,
+                                Concrete::BatchedNegateLweBufferOp>>(*ctx);
+    // matmul_cleartext_lwe_tensor => matmul_cleartext_lwe_buffer
+    Concrete::MatMulCleartextLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::MatMulCleartextLweTensorOp,
+                         Concrete::MatMulCleartextLweBufferOp>>(*ctx);
 
     // batched_keyswitch_lwe_tensor => batched_keyswitch_lwe_buffer
     Concrete::BatchedKeySwitchLweTensorOp::attachInterface<
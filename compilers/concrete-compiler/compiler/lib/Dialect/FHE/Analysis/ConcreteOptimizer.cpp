@@ -150,6 +150,12 @@ struct FunctionToDag {
       return;
     }
 
+    if (auto manyLut = asManyLut(op)) {
+      // special case as the op has several results
+      addManyLut(manyLut, encrypted_inputs);
+      return;
+    }
+
     assert(op.getNumResults() == 1);
     auto val = op.getResult(0);
     auto precision = fhe::utils::getEintPrecision(val);
@@ -242,6 +248,38 @@ struct FunctionToDag {
     index[val] = lutIndex;
   }
 
+  void addManyLut(FHE::ApplyManyLookupTablesEintOp &op,
+                  Inputs &encrypted_inputs) {
+    auto loc = loc_to_location(op.getLoc());
+    assert(encrypted_inputs.size() == 1);
+    auto inputType = op.getA().getType().cast<FHE::FheIntegerInterface>();
+    auto encrypted_input = encrypted_inputs[0];
+    std::vector<std::uint64_t> unknowFunction;
+    std::vector<int32_t> operatorIndexes;
+    if (inputType.isSigned()) {
+      auto addIndex =
+          dagBuilder.add_dot(slice(encrypted_inputs),
+                             concrete_optimizer::weights::number(1), *loc);
+      encrypted_input = addIndex;
+      operatorIndexes.push_back(addIndex.index);
+    }
+    // The packed table is looked up at `p+q` bits, which is equivalent to
+    // reinterpreting the input precision before a single lut
+    auto lutWidth = (int)llvm::Log2_64(
+        op.getLut().getType().cast<mlir::RankedTensorType>().getDimSize(0));
+    auto castIndex =
+        dagBuilder.add_unsafe_cast_op(encrypted_input, lutWidth, *loc);
+    auto precision = fhe::utils::getEintPrecision(op.getResult(0));
+    auto lutIndex = dagBuilder.add_lut(castIndex, slice(unknowFunction),
+                                       precision, *loc);
+    operatorIndexes.push_back(lutIndex.index);
+    mlir::Builder builder(op.getContext());
+    if (setOptimizerID)
+      op->setAttr("TFHE.OId", builder.getDenseI32ArrayAttr(operatorIndexes));
+    for (auto result : op.getResults())
+      index[result] = lutIndex;
+  }
+
   concrete_optimizer::dag::OperatorIndex
   addRound(mlir::Value &val, Inputs &encrypted_inputs, int rounded_precision) {
     assert(encrypted_inputs.size() == 1);
@@ -931,6 +969,10 @@ struct FunctionToDag {
     return nullptr;
   }
 
+  FHE::ApplyManyLookupTablesEintOp asManyLut(mlir::Operation &op) {
+    return llvm::dyn_cast<FHE::ApplyManyLookupTablesEintOp>(op);
+  }
+
   bool isChangePartition(mlir::Operation &op) {
     return llvm::isa<mlir::concretelang::FHE::ChangePartitionEintOp>(op);
   }
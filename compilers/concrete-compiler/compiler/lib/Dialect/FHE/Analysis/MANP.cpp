@@ -951,12 +951,13 @@ public:
 
   void visitOperation(Operation *op, ArrayRef<const MANPLattice *> operands,
                       ArrayRef<MANPLattice *> results) override {
-    MANPLattice *latticeRes = results[0];
-
     std::optional<llvm::APInt> norm2SqEquiv = norm2SqEquivFromOp(op, operands);
 
     if (norm2SqEquiv.has_value()) {
-      latticeRes->join(MANPLatticeValue{norm2SqEquiv});
+      // Operations with several results (e.g. `FHE.apply_many_lookup_tables`)
+      // share the same noise on all of them
+      for (MANPLattice *latticeRes : results)
+        latticeRes->join(MANPLatticeValue{norm2SqEquiv});
 
       op->setAttr("SMANP",
                   mlir::IntegerAttr::get(
@@ -979,7 +980,8 @@ public:
             << APIntToStringValUnsigned(norm2SqEquiv.value()) << "\n";
       }
     } else {
-      latticeRes->join(MANPLatticeValue{});
+      for (MANPLattice *latticeRes : results)
+        latticeRes->join(MANPLatticeValue{});
     }
   }
 
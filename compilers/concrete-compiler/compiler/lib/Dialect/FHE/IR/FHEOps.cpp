@@ -247,6 +247,43 @@ mlir::LogicalResult GenGateOp::verify() {
   return mlir::success();
 }
 
+::mlir::LogicalResult ApplyManyLookupTablesEintOp::verify() {
+  auto ct = this->getA().getType().cast<FheIntegerInterface>();
+  auto lut = this->getLut().getType().cast<TensorType>();
+  auto width = ct.getWidth();
+
+  // The packed table must have a static size of `2^(p+q)` entries
+  if (!lut.hasStaticShape() || lut.getRank() != 1 ||
+      !llvm::isPowerOf2_64(lut.getDimSize(0)) ||
+      lut.getDimSize(0) < ((int64_t)1 << width)) {
+    this->emitOpError() << "should have as `lut` a tensor of shape `<2^(p+q)>` "
+                           "with `p` the width of `a` ("
+                        << width << ")";
+    return mlir::failure();
+  }
+  auto elmType = lut.getElementType();
+  if (!elmType.isSignlessInteger() || elmType.getIntOrFloatBitWidth() > 64) {
+    this->emitOpError() << "lut must have signless integer elements, with "
+                           "precision not bigger than 64.";
+    return mlir::failure();
+  }
+
+  auto results = this->getResults();
+  int64_t maxResults = lut.getDimSize(0) >> width;
+  if (results.empty() || (int64_t)results.size() > maxResults) {
+    this->emitOpError() << "should have between 1 and " << maxResults
+                        << " results";
+    return mlir::failure();
+  }
+  for (auto result : results) {
+    if (result.getType() != results[0].getType()) {
+      this->emitOpError() << "should have results of the same type";
+      return mlir::failure();
+    }
+  }
+  return mlir::success();
+}
+
 mlir::LogicalResult RoundEintOp::verify() {
   auto input = this->getInput().getType().cast<FheIntegerInterface>();
   auto output = this->getResult().getType().cast<FheIntegerInterface>();
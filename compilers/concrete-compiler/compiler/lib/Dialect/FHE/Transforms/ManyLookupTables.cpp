@@ -0,0 +1,125 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/Support/MathExtras.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/IR/Matchers.h>
+#include <mlir/IR/PatternMatch.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHE/Transforms/ManyLookupTables/ManyLookupTables.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Lookups sharing their encrypted operand, their result type and the element
+/// type of their table, which can be packed together.
+using LookupGroupKey = std::tuple<mlir::Value, mlir::Type, mlir::Type>;
+
+/// Returns the constant table of a lookup, if any.
+std::optional<mlir::DenseIntElementsAttr>
+getConstantLut(FHE::ApplyLookupTableEintOp op) {
+  mlir::DenseIntElementsAttr lut;
+  if (!mlir::matchPattern(op.getLut(), mlir::m_Constant(&lut)))
+    return std::nullopt;
+  return lut;
+}
+
+/// Replaces the lookups of `group` with a single many-lut lookup inserted
+/// before the first of them. The `j`-th table is stored at the entries
+/// `m * 2^q + j` of the packed table, the unused entries being zeros.
+void packLookups(mlir::IRRewriter &rewriter,
+                 llvm::ArrayRef<FHE::ApplyLookupTableEintOp> group) {
+  FHE::ApplyLookupTableEintOp first = group.front();
+  auto inputWidth =
+      first.getA().getType().cast<FHE::FheIntegerInterface>().getWidth();
+  auto elementType =
+      first.getLut().getType().cast<mlir::RankedTensorType>().getElementType();
+  unsigned int q = llvm::Log2_64_Ceil(group.size());
+  int64_t singleLutSize = (int64_t)1 << inputWidth;
+  int64_t packedLutSize = singleLutSize << q;
+
+  std::vector<llvm::APInt> packed(
+      packedLutSize, llvm::APInt(elementType.getIntOrFloatBitWidth(), 0));
+  for (auto [j, op] : llvm::enumerate(group)) {
+    auto lut = getConstantLut(op).value();
+    for (auto [m, value] : llvm::enumerate(lut.getValues<llvm::APInt>()))
+      packed[(m << q) + j] = value;
+  }
+
+  rewriter.setInsertionPoint(first);
+  auto packedLutType =
+      mlir::RankedTensorType::get({packedLutSize}, elementType);
+  mlir::Value packedLut = rewriter.create<mlir::arith::ConstantOp>(
+      first.getLoc(), mlir::DenseElementsAttr::get(packedLutType, packed));
+  mlir::SmallVector<mlir::Type> resultTypes(group.size(), first.getType());
+  auto manyLut = rewriter.create<FHE::ApplyManyLookupTablesEintOp>(
+      first.getLoc(), resultTypes, first.getA(), packedLut);
+
+  for (auto [j, op] : llvm::enumerate(group))
+    rewriter.replaceOp(op, manyLut.getResult(j));
+}
+
+} // namespace
+
+class FHEManyLookupTables
+    : public FHEManyLookupTablesBase<FHEManyLookupTables> {
+
+public:
+  FHEManyLookupTables(unsigned int maxLutWidth) : maxLutWidth(maxLutWidth) {}
+
+  void runOnOperation() override {
+    mlir::func::FuncOp funcOp = getOperation();
+    mlir::IRRewriter rewriter(funcOp->getContext());
+
+    funcOp.walk([&](mlir::Block *block) {
+      // Lookups are collected in the order of the block, so that the first
+      // lookup of a group dominates the uses of all the others
+      llvm::MapVector<LookupGroupKey,
+                      mlir::SmallVector<FHE::ApplyLookupTableEintOp>>
+          groups;
+      for (auto op : block->getOps<FHE::ApplyLookupTableEintOp>()) {
+        if (!getConstantLut(op).has_value())
+          continue;
+        auto lutType = op.getLut().getType().cast<mlir::RankedTensorType>();
+        groups[LookupGroupKey{op.getA(), op.getType(),
+                              lutType.getElementType()}]
+            .push_back(op);
+      }
+
+      for (auto &[key, ops] : groups) {
+        auto inputWidth = std::get<0>(key)
+                              .getType()
+                              .cast<FHE::FheIntegerInterface>()
+                              .getWidth();
+        if (inputWidth >= maxLutWidth)
+          continue;
+        size_t maxGroupSize = (size_t)1 << (maxLutWidth - inputWidth);
+        for (size_t i = 0; i + 1 < ops.size(); i += maxGroupSize) {
+          llvm::ArrayRef<FHE::ApplyLookupTableEintOp> group(ops);
+          group = group.slice(i, std::min(maxGroupSize, ops.size() - i));
+          if (group.size() > 1)
+            packLookups(rewriter, group);
+        }
+      }
+    });
+  }
+
+private:
+  unsigned int maxLutWidth;
+};
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createFHEManyLookupTablesPass(unsigned int maxLutWidth) {
+  return std::make_unique<FHEManyLookupTables>(maxLutWidth);
+}
+
+} // namespace concretelang
+} // namespace mlir
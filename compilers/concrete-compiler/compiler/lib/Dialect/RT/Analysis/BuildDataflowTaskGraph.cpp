@@ -4,6 +4,7 @@
 // for license information.
 
 #include <iostream>
+#include <limits>
 
 #include "concretelang/Dialect/FHE/Interfaces/FHEInterfaces.h"
 #include <concretelang/Dialect/FHE/IR/FHEDialect.h>
@@ -19,6 +20,7 @@
 
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Linalg/IR/Linalg.h>
 #include <mlir/IR/Attributes.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/BuiltinAttributes.h>
@@ -42,7 +44,75 @@ namespace concretelang {
 
 namespace {
 
-// TODO: adjust these two functions based on cost model
+/// Rough single-core CPU durations, in microseconds, of the primitives FHE
+/// operations lower to. The cost model only compares estimates with each
+/// other and with the target task duration, so only their order of magnitude
+/// matters.
+static const uint64_t PBS_DURATION = 5000;
+static const uint64_t KEYSWITCH_DURATION = 500;
+static const uint64_t LEVELED_DURATION = 1;
+/// Width up to which the PBS duration is `PBS_DURATION`. Beyond, the
+/// polynomial size and thus the duration roughly double with each bit.
+static const unsigned PBS_BASE_WIDTH = 4;
+
+static uint64_t saturatingAdd(uint64_t a, uint64_t b) {
+  return (a > std::numeric_limits<uint64_t>::max() - b)
+             ? std::numeric_limits<uint64_t>::max()
+             : a + b;
+}
+
+static uint64_t saturatingMul(uint64_t a, uint64_t b) {
+  return (b != 0 && a > std::numeric_limits<uint64_t>::max() / b)
+             ? std::numeric_limits<uint64_t>::max()
+             : a * b;
+}
+
+static uint64_t getPbsDuration(Operation *op) {
+  unsigned width = 0;
+  for (auto type : op->getOperandTypes())
+    if (auto fheType = type.dyn_cast<FHE::FheIntegerInterface>())
+      width = std::max<unsigned>(width, fheType.getWidth());
+  if (width <= PBS_BASE_WIDTH)
+    return PBS_DURATION;
+  return saturatingMul(PBS_DURATION,
+                       (uint64_t)1 << std::min(width - PBS_BASE_WIDTH, 32u));
+}
+
+/// Estimates the sequential execution duration of `op` in microseconds, from
+/// the number of bootstraps, keyswitches and leveled operations it performs.
+/// Unknown trip counts saturate the estimate.
+static uint64_t estimateDuration(Operation *op) {
+  if (auto genericOp = mlir::dyn_cast<mlir::linalg::GenericOp>(op)) {
+    uint64_t iterationDuration = 0;
+    for (auto &bodyOp : genericOp.getBody()->without_terminator())
+      iterationDuration =
+          saturatingAdd(iterationDuration, estimateDuration(&bodyOp));
+    uint64_t duration = iterationDuration;
+    for (int64_t range : genericOp.getStaticLoopRanges()) {
+      if (ShapedType::isDynamic(range))
+        return std::numeric_limits<uint64_t>::max();
+      duration = saturatingMul(duration, range);
+    }
+    return duration;
+  }
+  if (isa<FHE::ApplyLookupTableEintOp, FHE::ApplyManyLookupTablesEintOp,
+          FHE::RoundEintOp, FHE::LsbEintOp, FHE::MaxEintOp, FHE::GenGateOp,
+          FHE::BoolAndOp, FHE::BoolOrOp, FHE::BoolNandOp, FHE::BoolXorOp>(op))
+    return getPbsDuration(op);
+  if (isa<FHE::MulEintOp, FHE::MuxOp>(op))
+    return saturatingMul(getPbsDuration(op), 2);
+  if (isa<FHE::ChangePartitionEintOp>(op))
+    return KEYSWITCH_DURATION;
+  if (op->getName().getDialectNamespace() ==
+      FHE::FHEDialect::getDialectNamespace())
+    return LEVELED_DURATION;
+  uint64_t duration = 0;
+  for (auto &region : op->getRegions())
+    for (auto &nestedOp : region.getOps())
+      duration = saturatingAdd(duration, estimateDuration(&nestedOp));
+  return duration;
+}
+
 static bool isCandidateForTask(Operation *op) {
   // if it's a linalg.genric operation with encrypted inputs
   if (auto genericOp = mlir::dyn_cast<mlir::linalg::GenericOp>(op)) {
@@ -56,7 +126,7 @@ static bool isCandidateForTask(Operation *op) {
       }
     }
   }
-  return isa<FHE::ApplyLookupTableEintOp>(op);
+  return isa<FHE::ApplyLookupTableEintOp, FHE::ApplyManyLookupTablesEintOp>(op);
 }
 
 /// Identify operations that are beneficial to aggregate into tasks.  These
@@ -133,6 +203,25 @@ LogicalResult coarsenDFTask(RT::DataflowTaskOp taskOp) {
   return success();
 }
 
+/// Returns whether `op` can join the tasks group `group`, which is then
+/// outlined into a single task placed after its last operation. This requires
+/// that no operation between the group and `op` uses the results of the
+/// group.
+static bool canJoinGroup(Operation *op, ArrayRef<Operation *> group) {
+  Block *block = op->getBlock();
+  if (group.front()->getBlock() != block)
+    return false;
+  for (Operation *member : group) {
+    for (Operation *user : member->getUsers()) {
+      Operation *ancestor = block->findAncestorOpInBlock(*user);
+      if (ancestor && ancestor->isBeforeInBlock(op) &&
+          !llvm::is_contained(group, ancestor))
+        return false;
+    }
+  }
+  return true;
+}
+
 /// For documentation see Autopar.td
 struct BuildDataflowTaskGraphPass
     : public BuildDataflowTaskGraphBase<BuildDataflowTaskGraphPass> {
@@ -141,10 +230,14 @@ struct BuildDataflowTaskGraphPass
     auto module = getOperation();
 
     module.walk([&](mlir::func::FuncOp func) {
-      if (!func->getAttr("_dfr_work_function_attribute"))
-        func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *childOp) {
-          return this->processOperation(childOp);
-        });
+      if (!func->getAttr("_dfr_work_function_attribute")) {
+        for (auto &group : this->groupCandidates(func)) {
+          if (failed(this->createTask(group))) {
+            this->signalPassFailure();
+            return;
+          }
+        }
+      }
 
       // Perform simplifications, in particular DCE here in case some
       // of the operations sunk in tasks are no longer needed in the
@@ -157,52 +250,144 @@ struct BuildDataflowTaskGraphPass
       (void)mlir::simplifyRegions(rewriter, func->getRegions());
     });
   }
-  BuildDataflowTaskGraphPass(bool debug) : debug(debug){};
+  BuildDataflowTaskGraphPass(uint64_t targetTaskDuration)
+      : targetTaskDuration(targetTaskDuration){};
 
 protected:
-  mlir::WalkResult processOperation(mlir::Operation *op) {
-    if (isCandidateForTask(op)) {
-      IRMapping map;
-      Region &opBody = getOperation().getBody();
-      OpBuilder builder(opBody);
-
-      // Create a DFTask for this operation
-      builder.setInsertionPointAfter(op);
-      auto dftop = builder.create<RT::DataflowTaskOp>(
-          op->getLoc(), op->getResultTypes(), op->getOperands());
-
-      // Add the operation to the task
-      OpBuilder tbbuilder(dftop.getBody());
+  /// Gathers the candidates for tasks in groups to be executed as one task.
+  /// Consecutive candidates are merged as long as the estimated duration of
+  /// the group stays below the target task duration, so that cheap operations
+  /// do not drown in scheduling overhead.
+  std::vector<SmallVector<Operation *>> groupCandidates(func::FuncOp func) {
+    std::vector<SmallVector<Operation *>> groups;
+    uint64_t groupDuration = 0;
+    func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *op) {
+      if (!isCandidateForTask(op))
+        return mlir::WalkResult::advance();
+      uint64_t duration = estimateDuration(op);
+      if (!groups.empty() && targetTaskDuration != 0 &&
+          saturatingAdd(groupDuration, duration) <= targetTaskDuration &&
+          canJoinGroup(op, groups.back())) {
+        groups.back().push_back(op);
+        groupDuration += duration;
+      } else {
+        groups.push_back({op});
+        groupDuration = duration;
+      }
+      // The operations nested in a candidate belong to its task
+      return mlir::WalkResult::skip();
+    });
+    return groups;
+  }
+
+  LogicalResult createTask(ArrayRef<Operation *> group) {
+    IRMapping map;
+    Region &opBody = getOperation().getBody();
+    OpBuilder builder(opBody);
+
+    // The values defined by the group are passed from one operation to the
+    // next within the task, only the other ones are task operands.
+    SmallVector<Type> resultTypes;
+    SetVector<Value> operands;
+    SmallVector<Value> results;
+    for (Operation *op : group) {
+      resultTypes.append(op->result_type_begin(), op->result_type_end());
+      for (Value operand : op->getOperands())
+        if (!llvm::is_contained(group, operand.getDefiningOp()))
+          operands.insert(operand);
+      results.append(op->result_begin(), op->result_end());
+    }
+
+    // Create a DFTask for these operations
+    builder.setInsertionPointAfter(group.back());
+    auto dftop = builder.create<RT::DataflowTaskOp>(
+        group.front()->getLoc(), resultTypes, operands.getArrayRef());
+
+    // Add the operations to the task, uses of the results of the previous
+    // operations of the group being mapped to their clones
+    OpBuilder tbbuilder(dftop.getBody());
+    SmallVector<Value> clonedResults;
+    for (Operation *op : group) {
       Operation *clonedOp = tbbuilder.clone(*op, map);
+      clonedResults.append(clonedOp->result_begin(), clonedOp->result_end());
+    }
 
-      // Coarsen granularity by aggregating all dependence related
-      // lower-weight operations.
-      assert(!failed(coarsenDFTask(dftop)) &&
-             "Failing to sink operations into DFT");
-
-      // Add terminator
-      tbbuilder.create<RT::DataflowYieldOp>(dftop.getLoc(), mlir::TypeRange(),
-                                            op->getResults());
-      // Replace the uses of defined values
-      for (auto pair : llvm::zip(op->getResults(), clonedOp->getResults()))
-        replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair),
-                                   dftop.getBody());
-      // Replace uses of the values defined by the task
-      for (auto pair : llvm::zip(op->getResults(), dftop->getResults()))
-        replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair),
-                                   opBody);
-      // Once uses are re-targeted to the task, delete the operation
+    // Coarsen granularity by aggregating all dependence related
+    // lower-weight operations.
+    if (failed(coarsenDFTask(dftop)))
+      return dftop->emitError("failed to sink operations into the task");
+
+    // Add terminator
+    tbbuilder.create<RT::DataflowYieldOp>(dftop.getLoc(), mlir::TypeRange(),
+                                          results);
+    // Replace the uses of defined values
+    for (auto pair : llvm::zip(results, clonedResults))
+      replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair),
+                                 dftop.getBody());
+    // Replace uses of the values defined by the task
+    for (auto pair : llvm::zip(results, dftop->getResults()))
+      replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair), opBody);
+    // Once uses are re-targeted to the task, delete the operations
+    for (Operation *op : llvm::reverse(group))
       op->erase();
-    }
-    return mlir::WalkResult::advance();
+    return success();
+  }
+
+  uint64_t targetTaskDuration;
+};
+
+/// For documentation see Autopar.td
+struct MarkDataflowTaskSplitsPass
+    : public MarkDataflowTaskSplitsBase<MarkDataflowTaskSplitsPass> {
+
+  void runOnOperation() override {
+    if (targetTaskDuration == 0)
+      return;
+
+    getOperation().walk([&](mlir::linalg::GenericOp genericOp) {
+      if (!isCandidateForTask(genericOp) || genericOp->hasAttr("tile-sizes"))
+        return;
+      // Only fully parallel generics can be split into independent chunks
+      if (!llvm::all_of(genericOp.getIteratorTypesArray(),
+                        [](mlir::utils::IteratorType itty) {
+                          return itty == mlir::utils::IteratorType::parallel;
+                        }))
+        return;
+      SmallVector<int64_t> ranges = genericOp.getStaticLoopRanges();
+      if (ranges.empty() || ShapedType::isDynamic(ranges[0]) || ranges[0] <= 1)
+        return;
+      uint64_t duration = estimateDuration(genericOp);
+      if (duration == std::numeric_limits<uint64_t>::max() ||
+          duration <= 2 * targetTaskDuration)
+        return;
+
+      // Split the outermost loop in chunks lasting about the target duration
+      uint64_t rowDuration = std::max<uint64_t>(duration / ranges[0], 1);
+      int64_t chunk = std::max<uint64_t>(targetTaskDuration / rowDuration, 1);
+      if (chunk >= ranges[0])
+        return;
+      SmallVector<int64_t> tileSizes(ranges.size(), 0);
+      tileSizes[0] = chunk;
+      genericOp->setAttr("tile-sizes",
+                         Builder(&getContext()).getI64ArrayAttr(tileSizes));
+    });
   }
+  MarkDataflowTaskSplitsPass(uint64_t targetTaskDuration)
+      : targetTaskDuration(targetTaskDuration){};
 
-  bool debug;
+protected:
+  uint64_t targetTaskDuration;
 };
 } // end anonymous namespace
 
-std::unique_ptr<mlir::Pass> createBuildDataflowTaskGraphPass(bool debug) {
-  return std::make_unique<BuildDataflowTaskGraphPass>(debug);
+std::unique_ptr<mlir::Pass>
+createBuildDataflowTaskGraphPass(uint64_t targetTaskDuration) {
+  return std::make_unique<BuildDataflowTaskGraphPass>(targetTaskDuration);
+}
+
+std::unique_ptr<mlir::Pass>
+createMarkDataflowTaskSplitsPass(uint64_t targetTaskDuration) {
+  return std::make_unique<MarkDataflowTaskSplitsPass>(targetTaskDuration);
 }
 
 } // end namespace concretelang
@@ -88,7 +88,9 @@ struct ExtractTFHEStatisticsPass
     DISPATCH_ENTER(TFHE::AddGLWEIntOp)
     DISPATCH_ENTER(TFHE::BootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::KeySwitchGLWEOp)
+    DISPATCH_ENTER(TFHE::ManyBootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::MulGLWEIntOp)
+    DISPATCH_ENTER(TFHE::MatMulGLWEIntOp)
     DISPATCH_ENTER(TFHE::NegGLWEOp)
     DISPATCH_ENTER(TFHE::SubGLWEIntOp)
     DISPATCH_ENTER(TFHE::WopPBSGLWEOp)
@@ -202,6 +204,34 @@ struct ExtractTFHEStatisticsPass
     return std::nullopt;
   }
 
+  // ########################
+  // TFHE.many_bootstrap_glwe
+  // ########################
+
+  static std::optional<StringError> on_enter(TFHE::ManyBootstrapGLWEOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto bsk = op.getKey();
+
+    auto location = locationString(op.getLoc());
+    // All the lookup tables are evaluated by a single bootstrap
+    auto operation = PrimitiveOperation::PBS;
+    auto keys = std::vector<std::pair<KeyType, int64_t>>();
+    auto count = pass.getTripCount();
+
+    std::pair<KeyType, int64_t> key =
+        std::make_pair(KeyType::BOOTSTRAP, (int64_t)bsk.getIndex());
+    keys.push_back(key);
+
+    pass.circuitFeedback->statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
+
   // ###################
   // TFHE.keyswitch_glwe
   // ###################
@@ -256,6 +286,58 @@ struct ExtractTFHEStatisticsPass
     return std::nullopt;
   }
 
+  // ####################
+  // TFHE.matmul_glwe_int
+  // ####################
+
+  static std::optional<StringError> on_enter(TFHE::MatMulGLWEIntOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto lhsType = op.getCiphertexts().getType().cast<mlir::RankedTensorType>();
+    auto rhsType = op.getCleartexts().getType().cast<mlir::RankedTensorType>();
+    auto resultingKey = lhsType.getElementType()
+                            .cast<TFHE::GLWECipherTextType>()
+                            .getKey()
+                            .getNormalized();
+
+    auto location = locationString(op.getLoc());
+    auto keys = std::vector<std::pair<KeyType, int64_t>>();
+    auto count = pass.getTripCount();
+
+    std::pair<KeyType, int64_t> key =
+        std::make_pair(KeyType::SECRET, (int64_t)resultingKey->index);
+    keys.push_back(key);
+
+    // Account the kernel as the M*K*N multiplications and M*(K-1)*N
+    // additions of the equivalent scalar lowering
+    int64_t m = lhsType.getDimSize(0);
+    int64_t k = lhsType.getDimSize(1);
+    int64_t n = rhsType.getDimSize(1);
+
+    auto scaled = [&](int64_t factor) -> std::optional<int64_t> {
+      if (!count.has_value())
+        return std::nullopt;
+      return count.value() * factor;
+    };
+
+    pass.circuitFeedback->statistics.push_back(concretelang::Statistic{
+        location,
+        PrimitiveOperation::CLEAR_MULTIPLICATION,
+        keys,
+        scaled(m * k * n),
+    });
+
+    if (k > 1) {
+      pass.circuitFeedback->statistics.push_back(concretelang::Statistic{
+          location,
+          PrimitiveOperation::ENCRYPTED_ADDITION,
+          keys,
+          scaled(m * (k - 1) * n),
+      });
+    }
+
+    return std::nullopt;
+  }
+
   // #############
   // TFHE.neg_glwe
   // #############
@@ -3,6 +3,7 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/Region.h"
 
 #include "concretelang/Dialect/TFHE/IR/TFHEAttrs.h"
@@ -117,6 +118,81 @@ mlir::LogicalResult MulGLWEIntOp::verify() {
       *this);
 }
 
+mlir::LogicalResult MatMulGLWEIntOp::verify() {
+  auto lhsTy = this->getCiphertexts().getType().cast<mlir::RankedTensorType>();
+  auto rhsTy = this->getCleartexts().getType().cast<mlir::RankedTensorType>();
+  auto resultTy = this->getResult().getType().cast<mlir::RankedTensorType>();
+
+  auto a = lhsTy.getElementType().cast<GLWECipherTextType>();
+  auto b = rhsTy.getElementType().cast<IntegerType>();
+  auto result = resultTy.getElementType().cast<GLWECipherTextType>();
+  if (_verifyGLWEIntegerOperator(*this, a, b, result).failed())
+    return mlir::failure();
+
+  if (lhsTy.getDimSize(1) != rhsTy.getDimSize(0) ||
+      resultTy.getDimSize(0) != lhsTy.getDimSize(0) ||
+      resultTy.getDimSize(1) != rhsTy.getDimSize(1)) {
+    this->emitOpError() << "should have a result of shape "
+                        << lhsTy.getDimSize(0) << "x" << rhsTy.getDimSize(1)
+                        << " and matching inner dimensions";
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
+mlir::LogicalResult BatchedMulAddGLWEIntOp::verify() {
+  auto ciphertextsTy =
+      this->getCiphertexts().getType().cast<mlir::RankedTensorType>();
+  auto cleartextsTy =
+      this->getCleartexts().getType().cast<mlir::RankedTensorType>();
+  auto addendsTy = this->getAddends().getType().cast<mlir::RankedTensorType>();
+  auto resultTy = this->getResult().getType().cast<mlir::RankedTensorType>();
+
+  if (cleartextsTy.getShape() != ciphertextsTy.getShape() ||
+      addendsTy.getShape() != ciphertextsTy.getShape() ||
+      resultTy.getShape() != ciphertextsTy.getShape()) {
+    this->emitOpError() << "should have batches of "
+                        << ciphertextsTy.getDimSize(0) << " cleartexts, addends and results";
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
+void ABatchedAddGLWEOp::getCanonicalizationPatterns(
+    mlir::RewritePatternSet &patterns, mlir::MLIRContext *context) {
+
+  // Fuses a batched multiplication by cleartexts whose only use is a batched
+  // addition into a single batched multiply-add, so that the runtime reads the
+  // multiplied ciphertexts once and does not allocate the intermediate batch
+  class MulAddPattern : public mlir::OpRewritePattern<ABatchedAddGLWEOp> {
+  public:
+    MulAddPattern(mlir::MLIRContext *context)
+        : mlir::OpRewritePattern<ABatchedAddGLWEOp>(context, 0) {}
+
+    mlir::LogicalResult
+    matchAndRewrite(ABatchedAddGLWEOp op,
+                    mlir::PatternRewriter &rewriter) const override {
+      for (auto [mulOperand, addend] :
+           {std::make_pair(op.getCiphertextsA(), op.getCiphertextsB()),
+            std::make_pair(op.getCiphertextsB(), op.getCiphertextsA())}) {
+        auto mulOp = mulOperand.getDefiningOp<BatchedMulGLWEIntOp>();
+        if (mulOp == nullptr || !mulOp->hasOneUse())
+          continue;
+        rewriter.replaceOpWithNewOp<BatchedMulAddGLWEIntOp>(
+            op, op.getResult().getType(), mulOp.getCiphertexts(),
+            mulOp.getCleartexts(), addend);
+        rewriter.eraseOp(mulOp);
+        return mlir::success();
+      }
+      return mlir::failure();
+    }
+  };
+
+  patterns.add<MulAddPattern>(context);
+}
+
 mlir::LogicalResult EncodeExpandLutForBootstrapOp::verify() {
   mlir::IntegerAttr polySizeAttr = this->getPolySizeAttr();
 
@@ -169,6 +245,26 @@ mlir::LogicalResult BatchedBootstrapGLWEOp::verify() {
   return verifyBootstrapSingleLUTConstraints(*this);
 }
 
+mlir::LogicalResult ManyBootstrapGLWEOp::verify() {
+  if (verifyBootstrapSingleLUTConstraints(*this).failed())
+    return mlir::failure();
+
+  auto resultRtt = this->getResult().getType().cast<mlir::RankedTensorType>();
+  int64_t lutWidth = this->getLutWidth();
+
+  if (lutWidth < 0 || lutWidth >= 32 ||
+      resultRtt.getShape()[0] > ((int64_t)1 << lutWidth)) {
+    this->emitError("Number of results of ")
+        << resultRtt.getShape()[0]
+        << " exceeds the number of entries of the packed lookup table of "
+        << "width " << lutWidth;
+
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
 mlir::LogicalResult BatchedMappedBootstrapGLWEOp::verify() {
   GLWEBootstrapKeyAttr keyAttr = this->getKeyAttr();
 
@@ -440,8 +440,9 @@ public:
 
         .Case<TFHE::ZeroGLWEOp, TFHE::ZeroTensorGLWEOp,
               mlir::bufferization::AllocTensorOp, TFHE::KeySwitchGLWEOp,
-              TFHE::BootstrapGLWEOp, TFHE::BatchedKeySwitchGLWEOp,
-              TFHE::BatchedBootstrapGLWEOp, TFHE::EncodeExpandLutForBootstrapOp,
+              TFHE::BootstrapGLWEOp, TFHE::ManyBootstrapGLWEOp,
+              TFHE::BatchedKeySwitchGLWEOp, TFHE::BatchedBootstrapGLWEOp,
+              TFHE::EncodeExpandLutForBootstrapOp,
               TFHE::EncodeLutForCrtWopPBSOp, TFHE::EncodePlaintextWithCrtOp,
               TFHE::WopPBSGLWEOp, mlir::func::ReturnOp,
               Tracing::TraceCiphertextOp, mlir::tensor::EmptyOp,
@@ -459,6 +460,11 @@ public:
                    SameOperandAndResultTypeConstraint<0, 0>>(op, state,
                                                              inferredTypes);
         })
+        .Case<TFHE::BatchedMulAddGLWEIntOp>([&](auto op) {
+          converge<SameOperandTypeConstraint<0, 2>,
+                   SameOperandAndResultTypeConstraint<0, 0>>(op, state,
+                                                             inferredTypes);
+        })
         .Case<TFHE::BatchedNegGLWEOp, TFHE::NegGLWEOp, TFHE::AddGLWEIntOp,
               TFHE::BatchedMulGLWEIntOp, TFHE::BatchedMulGLWEIntCstOp,
               TFHE::MulGLWEIntOp, TFHE::ABatchedAddGLWEIntOp,
@@ -470,8 +476,8 @@ public:
           converge<SameOperandAndResultTypeConstraint<1, 0>>(op, state,
                                                              inferredTypes);
         })
-        .Case<TFHE::BatchedMulGLWECstIntOp, mlir::tensor::ExpandShapeOp>(
-            [&](auto op) {
+        .Case<TFHE::BatchedMulGLWECstIntOp, TFHE::MatMulGLWEIntOp,
+              mlir::tensor::ExpandShapeOp>([&](auto op) {
               converge<SameOperandAndResultElementTypeConstraint<0, 0>>(
                   op, state, inferredTypes);
             })
@@ -792,11 +798,10 @@ protected:
                 applyKeyswitch(op, resolver, currState, prevState,
                                oid.getInt());
               })
-          .Case<TFHE::BootstrapGLWEOp, TFHE::BatchedBootstrapGLWEOp>(
-              [&](auto op) {
-                applyBootstrap(op, resolver, currState, prevState,
-                               oid.getInt());
-              })
+          .Case<TFHE::BootstrapGLWEOp, TFHE::ManyBootstrapGLWEOp,
+                TFHE::BatchedBootstrapGLWEOp>([&](auto op) {
+            applyBootstrap(op, resolver, currState, prevState, oid.getInt());
+          })
           .Default([&](auto op) {
             applyGeneric(op, resolver, currState, prevState, oid.getInt());
           });
@@ -993,6 +998,13 @@ public:
             llvm::dyn_cast<TFHE::BootstrapGLWEOp>(newOp)) {
       TFHE::BootstrapGLWEOp oldBSOp = llvm::cast<TFHE::BootstrapGLWEOp>(oldOp);
 
+      if (checkFixupBootstrapLUTs(rewriter, oldBSOp, newBSOp).failed())
+        return mlir::failure();
+    } else if (TFHE::ManyBootstrapGLWEOp newBSOp =
+                   llvm::dyn_cast<TFHE::ManyBootstrapGLWEOp>(newOp)) {
+      TFHE::ManyBootstrapGLWEOp oldBSOp =
+          llvm::cast<TFHE::ManyBootstrapGLWEOp>(oldOp);
+
       if (checkFixupBootstrapLUTs(rewriter, oldBSOp, newBSOp).failed())
         return mlir::failure();
     }
@@ -1089,9 +1101,10 @@ protected:
   // Checks if the lookup table for a freshly rewritten bootstrap
   // operation needs to be adjusted and performs the adjustment if
   // this is the case.
+  template <typename BootstrapOpT>
   mlir::LogicalResult checkFixupBootstrapLUTs(mlir::IRRewriter &rewriter,
-                                              TFHE::BootstrapGLWEOp oldBSOp,
-                                              TFHE::BootstrapGLWEOp newBSOp) {
+                                              BootstrapOpT oldBSOp,
+                                              BootstrapOpT newBSOp) {
     TFHE::GLWEBootstrapKeyAttr oldBSKeyAttr =
         oldBSOp->getAttrOfType<TFHE::GLWEBootstrapKeyAttr>("key");
 
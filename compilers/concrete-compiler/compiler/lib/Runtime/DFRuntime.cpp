@@ -17,6 +17,7 @@
 #include <hpx/hpx_start.hpp>
 #include <hpx/hpx_suspend.hpp>
 #include <hwloc.h>
+#include <limits>
 #include <omp.h>
 
 #include "concretelang/Runtime/DFRuntime.hpp"
@@ -32,6 +33,11 @@ static std::vector<GenericComputeClient> gcc;
 static hpx::distributed::barrier *_dfr_jit_phase_barrier;
 static hpx::distributed::barrier *_dfr_startup_barrier;
 static size_t num_nodes = 0;
+enum class dfr_placement_policy { round_robin, locality_aware };
+static dfr_placement_policy placement_policy =
+    dfr_placement_policy::round_robin;
+// Estimated cost of the tasks running or queued on each node.
+static std::unique_ptr<std::atomic<uint64_t>[]> node_load;
 #if CONCRETELANG_TIMING_ENABLED
 static struct timespec init_timer, broadcast_timer, compute_timer, whole_timer;
 #endif
@@ -332,6 +338,16 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
       lazy = true;
   _dfr_node_level_runtime_context_manager = new RuntimeContextManager(lazy);
 
+  // Task placement policy across nodes: either "round-robin" (the
+  // default) or "locality-aware", which weighs the current load of
+  // each node against the cost of the task and of its data transfers.
+  env = getenv("DFR_TASK_PLACEMENT");
+  if (env != nullptr && !strcmp(env, "locality-aware"))
+    placement_policy = dfr_placement_policy::locality_aware;
+  node_load.reset(new std::atomic<uint64_t>[num_nodes]);
+  for (size_t node = 0; node < num_nodes; ++node)
+    node_load[node] = 0;
+
   _dfr_jit_phase_barrier = new hpx::distributed::barrier(
       "phase_barrier", num_nodes, hpx::get_locality_id());
   _dfr_startup_barrier = new hpx::distributed::barrier(
@@ -472,8 +488,25 @@ void _dfr_print_debug(size_t val) {
 
 #else // CONCRETELANG_DATAFLOW_EXECUTION_ENABLED
 
+/// Without HPX, dataflow tasks are executed in-process on the
+/// work-stealing pool shared with the asynchronous operations (see
+/// work_stealing_pool.hpp).  A task is submitted to the pool once all
+/// its input futures are ready, so workers never block on task
+/// dependences.
+
+#include <cstdarg>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mlir/ExecutionEngine/CRunnerUtils.h>
+
 #include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Runtime/dfr_debug_interface.h"
 #include "concretelang/Runtime/time_util.h"
+#include "concretelang/Runtime/work_stealing_pool.hpp"
 
 namespace mlir {
 namespace concretelang {
@@ -485,6 +518,152 @@ static size_t num_nodes = 1;
 #if CONCRETELANG_TIMING_ENABLED
 static struct timespec compute_timer;
 #endif
+
+typedef struct dfr_refcounted_future {
+  std::mutex guard;
+  bool ready = false;
+  void *value = nullptr;
+  // Exception thrown by the task producing the value, rethrown to the
+  // threads awaiting the future.
+  std::exception_ptr error;
+  // Continuations of the tasks waiting on this future, run once the
+  // value is set.
+  std::vector<std::function<void()>> waiters;
+  std::atomic<std::size_t> count;
+  bool cloned_memref_p;
+  dfr_refcounted_future(size_t c, bool clone_p)
+      : count(c), cloned_memref_p(clone_p) {}
+} dfr_refcounted_future_t, *dfr_refcounted_future_p;
+
+static void dfr_set_future_value(dfr_refcounted_future_p drf, void *value,
+                                 std::exception_ptr error = nullptr) {
+  std::vector<std::function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(drf->guard);
+    drf->value = value;
+    drf->error = error;
+    drf->ready = true;
+    waiters.swap(drf->waiters);
+  }
+  WorkStealingPool::global().notifyWaiters();
+  for (auto &waiter : waiters)
+    waiter();
+}
+
+static inline void _dfr_checked_aligned_alloc(void **out, size_t align,
+                                              size_t size) {
+  if (posix_memalign(out, align, size) != 0)
+    throw std::runtime_error("DFR: memory allocation failed");
+}
+
+// The generated work function calls report unsupported arities with
+// the HPX exception macro.
+#define HPX_THROW_EXCEPTION(code, where, message)                              \
+  throw std::runtime_error(std::string(where) + ": " + (message))
+
+struct TaskInputs {
+  std::vector<void *> params;
+  std::vector<size_t> output_sizes;
+};
+
+static std::vector<void *> dfr_call_work_function(wfnptr wfn,
+                                                  const TaskInputs &inputs) {
+  std::vector<void *> outputs;
+  switch (inputs.output_sizes.size()) {
+
+#include "concretelang/Runtime/generated/dfr_task_work_function_calls.h"
+
+  default:
+    HPX_THROW_EXCEPTION(hpx::error::no_success, "dfr_call_work_function",
+                        "Error: number of task outputs not supported.");
+  }
+  return outputs;
+}
+
+#undef HPX_THROW_EXCEPTION
+
+struct dfr_task {
+  wfnptr wfn;
+  void *ctx;
+  std::vector<dfr_refcounted_future_p> inputs;
+  std::vector<dfr_refcounted_future_p> outputs;
+  std::vector<size_t> output_sizes;
+  // Number of inputs not yet ready, plus one while the task is being
+  // created.
+  std::atomic<size_t> missing{1};
+};
+
+static void dfr_run_task(dfr_task *task) {
+  // A failed task, or a task whose inputs failed, completes its outputs
+  // with the exception so that their awaiters rethrow it rather than
+  // waiting forever.
+  std::exception_ptr error;
+  std::vector<void *> values(task->outputs.size(), nullptr);
+  for (auto input : task->inputs)
+    if (input->error && !error)
+      error = input->error;
+  if (!error) {
+    try {
+      TaskInputs inputs;
+      for (auto input : task->inputs)
+        inputs.params.push_back(input->value);
+      if (task->ctx)
+        inputs.params.push_back(task->ctx);
+      inputs.output_sizes = task->output_sizes;
+      values = dfr_call_work_function(task->wfn, inputs);
+    } catch (...) {
+      error = std::current_exception();
+      values.assign(task->outputs.size(), nullptr);
+    }
+  }
+
+  for (size_t i = 0; i < task->outputs.size(); ++i) {
+    dfr_set_future_value(task->outputs[i], values[i], error);
+    _dfr_deallocate_future(task->outputs[i]);
+  }
+  for (auto input : task->inputs)
+    _dfr_deallocate_future(input);
+  delete task;
+}
+
+static void dfr_input_ready(dfr_task *task) {
+  if (task->missing.fetch_sub(1) == 1)
+    WorkStealingPool::global().submit([task]() { dfr_run_task(task); });
+}
+
+static void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
+                                       std::vector<void *> &refcounted_futures,
+                                       std::vector<void *> &outputs,
+                                       std::vector<size_t> &output_sizes,
+                                       std::vector<uint64_t> &output_types) {
+  auto task = new dfr_task();
+  task->wfn = wfn;
+  task->ctx = ctx;
+  task->output_sizes = output_sizes;
+
+  // Output futures are referenced by the caller and by the task until
+  // it has set their value.
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto drf = new dfr_refcounted_future_t(
+        2, _dfr_get_arg_type(output_types[i]) == _DFR_TASK_ARG_MEMREF);
+    task->outputs.push_back(drf);
+    *((void **)outputs[i]) = (void *)drf;
+  }
+
+  // Take a reference on each future argument and register the task
+  // on the ones that are not ready yet.
+  for (auto rcf : refcounted_futures) {
+    auto drf = (dfr_refcounted_future_p)rcf;
+    drf->count.fetch_add(1);
+    task->inputs.push_back(drf);
+    std::lock_guard<std::mutex> lock(drf->guard);
+    if (!drf->ready) {
+      task->missing.fetch_add(1);
+      drf->waiters.push_back([task]() { dfr_input_ready(task); });
+    }
+  }
+  dfr_input_ready(task);
+}
 } // namespace
 
 void _dfr_set_required(bool is_required) {}
@@ -503,8 +682,127 @@ void _dfr_register_lib(void *dlh) {}
 
 using namespace mlir::concretelang::dfr;
 
+void *_dfr_make_ready_future(void *in, size_t memref_clone_p) {
+  auto drf = new dfr_refcounted_future_t(1, memref_clone_p);
+  drf->value = in;
+  drf->ready = true;
+  return (void *)drf;
+}
+
+void *_dfr_await_future(void *in) {
+  auto drf = static_cast<dfr_refcounted_future_p>(in);
+  // Work functions may await futures from a pool worker, the waiting thread
+  // then runs pending tasks itself so that the ones the future depends on
+  // still get to run.
+  mlir::concretelang::WorkStealingPool::global().waitUntil([drf]() {
+    std::lock_guard<std::mutex> lock(drf->guard);
+    return drf->ready;
+  });
+  if (drf->error)
+    std::rethrow_exception(drf->error);
+  return drf->value;
+}
+
+void _dfr_deallocate_future(void *in) {
+  auto drf = static_cast<dfr_refcounted_future_p>(in);
+  size_t prev_count = drf->count.fetch_sub(1);
+  if (prev_count == 1) {
+    // If this was a memref for which a clone was needed, deallocate first.
+    if (drf->cloned_memref_p && drf->value != nullptr)
+      free((void *)(static_cast<StridedMemRefType<char, 1> *>(drf->value)
+                        ->data));
+    free(drf->value);
+    delete drf;
+  }
+}
+
+/// Runtime generic async_task, see the HPX implementation above for
+/// the layout of the variadic arguments.
+void _dfr_create_async_task(wfnptr wfn, void *ctx, size_t num_params,
+                            size_t num_outputs, ...) {
+  std::vector<void *> refcounted_futures;
+  std::vector<void *> outputs;
+  std::vector<size_t> output_sizes;
+  std::vector<uint64_t> output_types;
+
+  va_list args;
+  va_start(args, num_outputs);
+  for (size_t i = 0; i < num_outputs; ++i) {
+    outputs.push_back(va_arg(args, void *));
+    output_sizes.push_back(va_arg(args, uint64_t));
+    output_types.push_back(va_arg(args, uint64_t));
+  }
+  for (size_t i = 0; i < num_params; ++i) {
+    refcounted_futures.push_back(va_arg(args, void *));
+    (void)va_arg(args, uint64_t);
+    (void)va_arg(args, uint64_t);
+  }
+  va_end(args);
+  dfr_create_async_task_impl(wfn, ctx, refcounted_futures, outputs,
+                             output_sizes, output_types);
+}
+
+/// Runtime generic async_task with vector parameters, see the HPX
+/// implementation above for the layout of the variadic arguments.
+void _dfr_create_async_task_vec(wfnptr wfn, void *ctx, size_t num_params,
+                                size_t num_outputs, ...) {
+  std::vector<void *> refcounted_futures;
+  std::vector<void *> outputs;
+  std::vector<size_t> output_sizes;
+  std::vector<uint64_t> output_types;
+
+  va_list args;
+  va_start(args, num_outputs);
+  for (size_t i = 0; i < num_outputs; ++i) {
+    size_t count = va_arg(args, uint64_t);
+    void **futures = va_arg(args, void **);
+    size_t sizes = va_arg(args, uint64_t);
+    size_t types = va_arg(args, uint64_t);
+    for (size_t j = 0; j < count; ++j) {
+      outputs.push_back(futures[j]);
+      output_sizes.push_back(sizes);
+      output_types.push_back(types);
+    }
+  }
+  for (size_t i = 0; i < num_params; ++i) {
+    size_t count = va_arg(args, uint64_t);
+    void **futures = va_arg(args, void **);
+    (void)va_arg(args, uint64_t);
+    (void)va_arg(args, uint64_t);
+    for (size_t j = 0; j < count; ++j)
+      refcounted_futures.push_back(futures[j]);
+  }
+  va_end(args);
+
+  dfr_create_async_task_impl(wfn, ctx, refcounted_futures, outputs,
+                             output_sizes, output_types);
+}
+
+// Work functions are called through their pointer, there is nothing
+// to register in shared memory.
+void _dfr_register_work_function(wfnptr wfn) {}
+
 void _dfr_start(int64_t use_dfr_p, void *ctx) {}
 void _dfr_stop(int64_t use_dfr_p) {}
 
 void _dfr_terminate() {}
+
+/**********************/
+/*  Debug interface.  */
+/**********************/
+size_t _dfr_debug_get_node_id() { return 0; }
+
+size_t _dfr_debug_get_worker_id() {
+  return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+void _dfr_debug_print_task(const char *name, size_t inputs, size_t outputs) {
+  printf("Task \"%s\t\" [%zu inputs, %zu outputs]  Executing on Node/Worker: "
+         "%zu / %zu\n",
+         name, inputs, outputs, _dfr_debug_get_node_id(),
+         _dfr_debug_get_worker_id());
+}
+
+/// Generic utility function for printing debug info
+void _dfr_print_debug(size_t val) { printf("_dfr_print_debug : %zu\n", val); }
 #endif
@@ -6,6 +6,7 @@
 #include "concretelang/Runtime/context.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include <algorithm>
 #include <assert.h>
 #include <stdio.h>
 
@@ -29,11 +30,72 @@ FFT::~FFT() {
   }
 }
 
+ScratchArena::~ScratchArena() {
+  for (auto &buffer : buffers) {
+    free(buffer.ptr);
+  }
+}
+
+uint8_t *ScratchArena::get(Slot slot, size_t size, size_t align) {
+  auto &buffer = buffers[slot];
+  if (buffer.size >= size && buffer.align >= align && buffer.ptr != nullptr) {
+    return buffer.ptr;
+  }
+  free(buffer.ptr);
+  // The content of the zeroed accumulator mask is lost, even if the new
+  // buffer happens to have the same address
+  if (slot == GLWE_ACCUMULATOR)
+    accumulator_ptr = nullptr;
+  buffer.align = std::max(align, buffer.align);
+  // The buffer keeps its high water mark when it is only reallocated for a
+  // larger alignment, and aligned_alloc requires the size to be a multiple of
+  // the alignment
+  size = std::max({size, buffer.size, (size_t)1});
+  buffer.size = (size + buffer.align - 1) / buffer.align * buffer.align;
+  buffer.ptr = (uint8_t *)aligned_alloc(buffer.align, buffer.size);
+  assert(buffer.ptr != nullptr && "bad alloc in scratch arena");
+  return buffer.ptr;
+}
+
+const uint64_t *ScratchArena::glwe_accumulator(const uint64_t *lut,
+                                               size_t glwe_dimension,
+                                               size_t polynomial_size) {
+  size_t mask_size = glwe_dimension * polynomial_size;
+  uint64_t *glwe_ct =
+      get<uint64_t>(GLWE_ACCUMULATOR, mask_size + polynomial_size);
+  if (glwe_ct != accumulator_ptr || mask_size != accumulator_mask_size) {
+    std::fill(glwe_ct, glwe_ct + mask_size, 0);
+    accumulator_ptr = glwe_ct;
+    accumulator_mask_size = mask_size;
+  }
+  std::copy(lut, lut + polynomial_size, glwe_ct + mask_size);
+  return glwe_ct;
+}
+
+size_t ScratchArena::memoryFootprint() const {
+  size_t footprint = 0;
+  for (auto &buffer : buffers) {
+    footprint += buffer.size;
+  }
+  return footprint;
+}
+
 RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
     : serverKeyset(serverKeyset) {
 
-  // Initialize for each bootstrap key the fourier one
+  // Initialize for each bootstrap key the fourier one, reusing the one of
+  // the keyset if it has been precomputed
   for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
+    auto precomputed = serverKeyset.getFourierBootstrapKey(i);
+    if (precomputed != nullptr) {
+      fourier_bootstrap_keys.push_back(*precomputed);
+      ffts.push_back(FFT(serverKeyset.lweBootstrapKeys[i]
+                             .getInfo()
+                             .asReader()
+                             .getParams()
+                             .getPolynomialSize()));
+      continue;
+    }
     auto fdbsk = convert_to_fourier_domain(serverKeyset.lweBootstrapKeys[i]);
     // Store the fourier_bootstrap_key in the context
     fourier_bootstrap_keys.push_back(fdbsk.second);
@@ -56,41 +118,118 @@ RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
 #endif
 }
 
-std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>
+std::pair<FFT, FourierLweBootstrapKey>
 RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
-  auto info = bsk.getInfo().asReader();
-
-  size_t decomposition_level_count = info.getParams().getLevelCount();
-  size_t decomposition_base_log = info.getParams().getBaseLog();
-  size_t glwe_dimension = info.getParams().getGlweDimension();
-  size_t polynomial_size = info.getParams().getPolynomialSize();
-  size_t input_lwe_dimension = info.getParams().getInputLweDimension();
+  size_t polynomial_size =
+      bsk.getInfo().asReader().getParams().getPolynomialSize();
 
   // Create the FFT
   FFT fft(polynomial_size);
 
-  // Allocate scratch for key conversion
-  size_t scratch_size;
-  size_t scratch_align;
-  concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(
-      &scratch_size, &scratch_align, fft.fft);
-  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+  // Convert bootstrap_key to the fourier domain
+  FourierLweBootstrapKey fourier_bsk(bsk, fft.fft);
+
+  return std::pair<FFT, FourierLweBootstrapKey>(std::move(fft), fourier_bsk);
+}
 
-  // Allocate the fourier_bootstrap_key
-  auto &bsk_buffer = bsk.getBuffer();
-  auto fourier_data = std::make_shared<std::vector<std::complex<double>>>();
-  fourier_data->resize(bsk_buffer.size() / 2);
-  auto bsk_data = bsk_buffer.data();
+ScratchArena &RuntimeContext::scratch_arena() {
+  // Arenas do not depend on the keys of the context, so a thread uses the same
+  // arena for all the contexts, which is released when the thread exits.
+  thread_local ScratchArena arena;
+  return arena;
+}
 
-  // Convert bootstrap_key to the fourier domain
-  concrete_cpu_bootstrap_key_convert_u64_to_fourier(
-      bsk_data, fourier_data->data(), decomposition_level_count,
-      decomposition_base_log, glwe_dimension, polynomial_size,
-      input_lwe_dimension, fft.fft, scratch, scratch_size);
-  free(scratch);
+size_t RuntimeContext::memoryFootprint() const {
+  // The fft plans are shared by the backend between all the users of a same
+  // polynomial size, so they are not accounted to the context.
+  size_t footprint = 0;
+  for (auto &fbk : fourier_bootstrap_keys) {
+    footprint += fbk.getSize() * sizeof(std::complex<double>);
+  }
+  return footprint;
+}
+
+RuntimeContextCache::KeysetIdentity
+RuntimeContextCache::getKeysetIdentity(const ServerKeyset &serverKeyset) {
+  // Key buffers are shared between copies of a key, so their addresses
+  // identify a keyset. Entries keep their keyset alive, which guarantees that
+  // an address can not be reused by another keyset while it is in the cache.
+  KeysetIdentity identity;
+  for (auto &bsk : serverKeyset.lweBootstrapKeys) {
+    identity.push_back(bsk.getTransportRawPtr());
+  }
+  for (auto &ksk : serverKeyset.lweKeyswitchKeys) {
+    identity.push_back(ksk.getTransportRawPtr());
+  }
+  for (auto &pksk : serverKeyset.packingKeyswitchKeys) {
+    identity.push_back(&pksk.getTransportBuffer());
+  }
+  return identity;
+}
 
-  return std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>(
-      std::move(fft), fourier_data);
+std::shared_ptr<RuntimeContext>
+RuntimeContextCache::get(const ServerKeyset &serverKeyset) {
+  auto identity = getKeysetIdentity(serverKeyset);
+  std::promise<std::shared_ptr<RuntimeContext>> promise;
+  std::shared_future<std::shared_ptr<RuntimeContext>> prepared;
+  {
+    std::lock_guard<std::mutex> lock(guard);
+    auto it = contexts.find(identity);
+    if (it != contexts.end()) {
+      hits++;
+      prepared = it->second;
+    } else {
+      misses++;
+      contexts.insert({identity, promise.get_future().share()});
+    }
+  }
+  if (prepared.valid()) {
+    return prepared.get();
+  }
+  // The context is built outside of the lock so that lookups for other
+  // keysets are not blocked. Concurrent lookups for this keyset wait on the
+  // shared future.
+  std::shared_ptr<RuntimeContext> context;
+  try {
+    context = std::make_shared<RuntimeContext>(serverKeyset);
+  } catch (...) {
+    // Concurrent lookups get the failure, and the entry is dropped so that
+    // later lookups try to build the context again.
+    promise.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> lock(guard);
+    auto it = contexts.find(identity);
+    if (it != contexts.end() &&
+        it->second.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready) {
+      contexts.erase(it);
+    }
+    throw;
+  }
+  promise.set_value(context);
+  return context;
+}
+
+bool RuntimeContextCache::evict(const ServerKeyset &serverKeyset) {
+  std::lock_guard<std::mutex> lock(guard);
+  return contexts.erase(getKeysetIdentity(serverKeyset)) != 0;
+}
+
+void RuntimeContextCache::evictAll() {
+  std::lock_guard<std::mutex> lock(guard);
+  contexts.clear();
+}
+
+RuntimeContextCache::Metrics RuntimeContextCache::getMetrics() {
+  std::lock_guard<std::mutex> lock(guard);
+  Metrics metrics{hits, misses, contexts.size(), 0};
+  for (auto &entry : contexts) {
+    // Contexts still under construction are not accounted for.
+    if (entry.second.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      metrics.memoryFootprint += entry.second.get()->memoryFootprint();
+    }
+  }
+  return metrics;
 }
 } // namespace concretelang
 } // namespace mlir
@@ -119,7 +258,7 @@ const uint64_t *DistributedRuntimeContext::keyswitch_key_buffer(size_t keyId) {
   }
   auto it = ksks.find(keyId);
   assert(it != ksks.end());
-  return it->second.getBuffer().data();
+  return it->second.getRawPtr();
 }
 
 void DistributedRuntimeContext::getBSKonNode(size_t keyId) {
@@ -130,9 +269,7 @@ void DistributedRuntimeContext::getBSKonNode(size_t keyId) {
       getBskAction(hpx::find_root_locality(), keyId);
 
   auto fdbsk = convert_to_fourier_domain(bskw.keys[0]);
-  fbks.insert(
-      std::pair<size_t, std::shared_ptr<std::vector<std::complex<double>>>>(
-          keyId, fdbsk.second));
+  fbks.insert(std::pair<size_t, FourierLweBootstrapKey>(keyId, fdbsk.second));
   dffts.insert(std::pair<size_t, FFT>(keyId, std::move(fdbsk.first)));
 }
 
@@ -146,7 +283,7 @@ DistributedRuntimeContext::fourier_bootstrap_key_buffer(size_t keyId) {
     getBSKonNode(keyId);
   auto it = fbks.find(keyId);
   assert(it != fbks.end());
-  return it->second->data();
+  return it->second.getRawPtr();
 }
 
 const uint64_t *
@@ -178,6 +315,18 @@ const struct Fft *DistributedRuntimeContext::fft(size_t keyId) {
   return it->second.fft;
 }
 
+uint32_t DistributedRuntimeContext::bootstrap_grouping_factor(size_t keyId) {
+  if (dfr::_dfr_is_root_node())
+    return RuntimeContext::bootstrap_grouping_factor(keyId);
+
+  std::lock_guard<std::mutex> guard(cm_guard);
+  if (fbks.find(keyId) == fbks.end())
+    getBSKonNode(keyId);
+  auto it = fbks.find(keyId);
+  assert(it != fbks.end());
+  return it->second.getInfo().asReader().getParams().getGroupingFactor();
+}
+
 } // namespace concretelang
 } // namespace mlir
 #endif
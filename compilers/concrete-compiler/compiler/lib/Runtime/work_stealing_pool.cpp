@@ -0,0 +1,189 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <stdlib.h>
+
+#include "concretelang/Runtime/work_stealing_pool.hpp"
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+// Pool and queue index of the calling thread when it is a pool worker.
+thread_local const WorkStealingPool *current_pool = nullptr;
+thread_local size_t current_worker = 0;
+// Number of nested `ConcurrentScope`s of the calling thread.
+thread_local size_t concurrent_scope_depth = 0;
+
+size_t get_global_pool_size() {
+  char *env = getenv("CONCRETE_ASYNC_NUM_THREADS");
+  if (env != nullptr) {
+    size_t num_threads = strtoul(env, NULL, 10);
+    if (num_threads > 0)
+      return num_threads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+} // namespace
+
+ConcurrentScope::ConcurrentScope() { concurrent_scope_depth++; }
+
+ConcurrentScope::~ConcurrentScope() { concurrent_scope_depth--; }
+
+bool ConcurrentScope::active() { return concurrent_scope_depth > 0; }
+
+WorkStealingPool::WorkStealingPool(size_t numWorkers) {
+  numWorkers = std::max<size_t>(numWorkers, 1);
+  for (size_t i = 0; i < numWorkers; i++)
+    queues.push_back(std::make_unique<Queue>());
+  for (size_t i = 0; i < numWorkers; i++)
+    workers.emplace_back([this, i]() { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepGuard);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+WorkStealingPool::Future WorkStealingPool::submit(std::function<void()> work) {
+  auto task = std::make_shared<Task>();
+  task->work = std::move(work);
+
+  size_t index = (current_pool == this)
+                     ? current_worker
+                     : nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                           queues.size();
+  // Account for the task before it becomes visible, so that `pending` never
+  // underflows when a thief takes it right away.
+  bool anyWaiting;
+  {
+    std::lock_guard<std::mutex> lock(sleepGuard);
+    pending++;
+    anyWaiting = numWaiting > 0;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->guard);
+    queues[index]->tasks.push_back(task);
+  }
+  wakeUp.notify_one();
+  if (anyWaiting)
+    waiting.notify_all();
+  return task;
+}
+
+void WorkStealingPool::wait(const Future &future) {
+  size_t index = (current_pool == this) ? current_worker : queues.size();
+  while (!future->isDone()) {
+    if (auto task = take(index)) {
+      run(task);
+      continue;
+    }
+    // Nothing left to help with: the awaited task is running on another
+    // thread.
+    std::unique_lock<std::mutex> lock(future->guard);
+    future->completed.wait(lock, [&]() { return future->isDone(); });
+  }
+  if (future->error)
+    std::rethrow_exception(future->error);
+}
+
+void WorkStealingPool::waitUntil(const std::function<bool()> &isDone) {
+  size_t index = (current_pool == this) ? current_worker : queues.size();
+  while (!isDone()) {
+    if (auto task = take(index)) {
+      run(task);
+      continue;
+    }
+    // Sleep until there is a task to help with or the condition may have
+    // changed. The condition is checked under `sleepGuard`, which
+    // `notifyWaiters` takes, so no notification is lost.
+    std::unique_lock<std::mutex> lock(sleepGuard);
+    numWaiting++;
+    waiting.wait(lock, [&]() { return pending > 0 || isDone(); });
+    numWaiting--;
+  }
+}
+
+void WorkStealingPool::notifyWaiters() {
+  {
+    std::lock_guard<std::mutex> lock(sleepGuard);
+    if (numWaiting == 0)
+      return;
+  }
+  waiting.notify_all();
+}
+
+WorkStealingPool &WorkStealingPool::global() {
+  static WorkStealingPool pool(get_global_pool_size());
+  return pool;
+}
+
+WorkStealingPool::Future WorkStealingPool::take(size_t index) {
+  Future task;
+  size_t n = queues.size();
+  if (index < n) {
+    std::lock_guard<std::mutex> lock(queues[index]->guard);
+    if (!queues[index]->tasks.empty()) {
+      task = std::move(queues[index]->tasks.back());
+      queues[index]->tasks.pop_back();
+    }
+  }
+  for (size_t k = 0; !task && k < n; k++) {
+    size_t victim = (index + 1 + k) % n;
+    if (victim == index)
+      continue;
+    std::lock_guard<std::mutex> lock(queues[victim]->guard);
+    if (!queues[victim]->tasks.empty()) {
+      task = std::move(queues[victim]->tasks.front());
+      queues[victim]->tasks.pop_front();
+    }
+  }
+  if (task) {
+    std::lock_guard<std::mutex> lock(sleepGuard);
+    pending--;
+  }
+  return task;
+}
+
+void WorkStealingPool::run(const Future &task) {
+  // An exception must not escape a worker, nor leave the task pending
+  // forever: it is kept for the thread waiting on the task.
+  try {
+    ConcurrentScope scope;
+    task->work();
+  } catch (...) {
+    task->error = std::current_exception();
+  }
+  task->work = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(task->guard);
+    task->done.store(true, std::memory_order_release);
+  }
+  task->completed.notify_all();
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+  current_pool = this;
+  current_worker = index;
+  while (true) {
+    if (auto task = take(index)) {
+      run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepGuard);
+    wakeUp.wait(lock, [&]() { return stopping || pending > 0; });
+    if (stopping && pending == 0)
+      return;
+  }
+}
+
+} // namespace concretelang
+} // namespace mlir
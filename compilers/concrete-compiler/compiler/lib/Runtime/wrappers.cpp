@@ -6,20 +6,28 @@
 #include "concretelang/Runtime/wrappers.h"
 #include "concrete-cpu.h"
 #include "concretelang/Common/Error.h"
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <bitset>
 #include <cmath>
 #include <execinfo.h>
 #include <functional>
 #include <iostream>
+#include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <vector>
 
 #include "concretelang/Common/CRT.h"
+#include "concretelang/Common/Lut.h"
+#include "concretelang/Runtime/work_stealing_pool.hpp"
 #include "concretelang/Runtime/wrappers.h"
 
+using mlir::concretelang::ScratchArena;
+using mlir::concretelang::WorkStealingPool;
+
 #ifdef CONCRETELANG_CUDA_SUPPORT
 
 // CUDA memory utils function /////////////////////////////////////////////////
@@ -397,54 +405,12 @@ void memref_encode_expand_lut_for_bootstrap(
   assert(output_lut_stride == 1 && "Runtime: stride not equal to 1, check "
                                    "memref_encode_expand_lut_bootstrap");
 
-  size_t mega_case_size = output_lut_size / input_lut_size;
-
-  assert((mega_case_size % 2) == 0);
-
-  // When the bootstrap is executed on encrypted signed integers, the lut must
-  // be half-rotated. This map takes care about properly indexing into the input
-  // lut depending on what bootstrap gets executed.
-  std::function<size_t(size_t)> indexMap;
-  if (is_signed) {
-    size_t halfInputSize = input_lut_size / 2;
-    indexMap = [=](size_t idx) {
-      if (idx < halfInputSize) {
-        return idx + halfInputSize;
-      } else {
-        return idx - halfInputSize;
-      }
-    };
-  } else {
-    indexMap = [=](size_t idx) { return idx; };
-  }
-
-  // The first lut value should be centered over zero. This means that half of
-  // it should appear at the beginning of the output lut, and half of it at the
-  // end (but negated).
-  for (size_t idx = 0; idx < mega_case_size / 2; ++idx) {
-    output_lut_aligned[output_lut_offset + idx] =
-        input_lut_aligned[input_lut_offset + indexMap(0)]
-        << (64 - out_MESSAGE_BITS - 1);
-  }
-  for (size_t idx = (input_lut_size - 1) * mega_case_size + mega_case_size / 2;
-       idx < output_lut_size; ++idx) {
-    output_lut_aligned[output_lut_offset + idx] =
-        -(input_lut_aligned[input_lut_offset + indexMap(0)]
-          << (64 - out_MESSAGE_BITS - 1));
-  }
-
-  // Treats the other ut values.
-  for (size_t lut_idx = 1; lut_idx < input_lut_size; ++lut_idx) {
-    uint64_t lut_value = input_lut_aligned[input_lut_offset + indexMap(lut_idx)]
-                         << (64 - out_MESSAGE_BITS - 1);
-    size_t start = mega_case_size * (lut_idx - 1) + mega_case_size / 2;
-    for (size_t output_idx = start; output_idx < start + mega_case_size;
-         ++output_idx) {
-      output_lut_aligned[output_lut_offset + output_idx] = lut_value;
-    }
-  }
-
-  return;
+  // Constant luts are encoded by the compiler, see the lowering of
+  // `TFHE.encode_expand_lut_for_bootstrap`
+  concretelang::lut::encodeExpandForBootstrap(
+      input_lut_aligned + input_lut_offset, input_lut_size,
+      output_lut_aligned + output_lut_offset, output_lut_size,
+      out_MESSAGE_BITS, is_signed);
 }
 
 void memref_encode_lut_for_crt_woppbs(
@@ -644,6 +610,165 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
       output_dimension);
 }
 
+namespace {
+
+// Number of threads used by the batched wrappers, 0 until it has been set or
+// read from the environment.
+std::atomic<size_t> batch_num_threads{0};
+
+size_t get_batch_num_threads() {
+  size_t num_threads = batch_num_threads.load();
+  if (num_threads != 0)
+    return num_threads;
+  char *env = getenv("CONCRETE_BATCH_NUM_THREADS");
+  if (env != nullptr)
+    num_threads = strtoul(env, NULL, 10);
+  if (num_threads == 0)
+    num_threads = omp_get_max_threads();
+  batch_num_threads.store(num_threads);
+  return num_threads;
+}
+
+// Number of threads computing the key bundles of a single multi-bit bootstrap,
+// the calling thread only when it runs alongside other threads: in a parallel
+// region, a dataflow task or a concurrent call.
+size_t get_multi_bit_num_threads() {
+  if (omp_in_parallel() || mlir::concretelang::ConcurrentScope::active())
+    return 1;
+  return get_batch_num_threads();
+}
+
+// Vector 64 bits multiplications are only native from AVX-512, so the
+// arithmetic kernels of the runtime are compiled for several instruction sets
+// and the best one is selected when the runtime is loaded.
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define RUNTIME_TARGET_CLONES                                                  \
+  __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#endif
+#endif
+#ifndef RUNTIME_TARGET_CLONES
+#define RUNTIME_TARGET_CLONES
+#endif
+
+// Minimum number of lwe coefficients of a batched leveled operation for it to
+// be split over the batch worker threads, smaller batches being dominated by
+// the cost of waking up the threads.
+constexpr size_t LEVELED_PARALLEL_THRESHOLD = 1 << 16;
+
+/// Operands of a batched leveled operation, which computes for the i-th
+/// ciphertext of the batch `out[i] = ct0[i] * cleartexts[i] + ct1[i]`, then
+/// adds `plaintexts[i]` to the body of `out[i]`.
+///
+/// A null `cleartexts`, `ct1` or `plaintexts` respectively stands for 1, 0 and
+/// 0, and a zero stride shares the same scalar between all the ciphertexts.
+/// `out` may be the same buffer as `ct0` or `ct1`.
+struct LeveledBatch {
+  uint64_t *out;
+  uint64_t out_stride0;
+  uint64_t out_stride1;
+  const uint64_t *ct0;
+  uint64_t ct0_stride0;
+  uint64_t ct0_stride1;
+  const uint64_t *ct1;
+  uint64_t ct1_stride0;
+  uint64_t ct1_stride1;
+  const uint64_t *cleartexts;
+  uint64_t cleartexts_stride;
+  const uint64_t *plaintexts;
+  uint64_t plaintexts_stride;
+  size_t batch_size;
+  size_t lwe_size;
+};
+
+/// Computes `len` contiguous coefficients of a ciphertext of a batched
+/// leveled operation. Each coefficient is read before the same coefficient of
+/// `out` is written, so `out` can alias the inputs.
+template <bool MUL, bool ADD>
+inline __attribute__((always_inline)) void
+leveled_row_u64(uint64_t *out, const uint64_t *ct0, const uint64_t *ct1,
+                uint64_t cleartext, size_t len) {
+#pragma omp simd
+  for (size_t l = 0; l < len; l++) {
+    uint64_t coefficient = ct0[l];
+    if (MUL)
+      coefficient *= cleartext;
+    if (ADD)
+      coefficient += ct1[l];
+    out[l] = coefficient;
+  }
+}
+
+/// Computes the ciphertexts `[first, last)` of a batched leveled operation.
+RUNTIME_TARGET_CLONES void leveled_rows_u64(const LeveledBatch &batch,
+                                            size_t first, size_t last) {
+  size_t len = batch.lwe_size;
+  bool contiguous =
+      batch.out_stride1 == 1 && batch.ct0_stride1 == 1 &&
+      (batch.ct1 == nullptr || batch.ct1_stride1 == 1);
+
+  for (size_t i = first; i < last; i++) {
+    uint64_t *out = batch.out + i * batch.out_stride0;
+    const uint64_t *ct0 = batch.ct0 + i * batch.ct0_stride0;
+    const uint64_t *ct1 =
+        batch.ct1 == nullptr ? nullptr : batch.ct1 + i * batch.ct1_stride0;
+    uint64_t cleartext = batch.cleartexts == nullptr
+                             ? 1
+                             : batch.cleartexts[i * batch.cleartexts_stride];
+
+    if (!contiguous) {
+      for (size_t l = 0; l < len; l++) {
+        uint64_t coefficient = ct0[l * batch.ct0_stride1] * cleartext;
+        if (ct1 != nullptr)
+          coefficient += ct1[l * batch.ct1_stride1];
+        out[l * batch.out_stride1] = coefficient;
+      }
+    } else if (ct1 == nullptr) {
+      if (cleartext != 1)
+        leveled_row_u64<true, false>(out, ct0, ct1, cleartext, len);
+      else if (out != ct0)
+        leveled_row_u64<false, false>(out, ct0, ct1, cleartext, len);
+    } else {
+      if (cleartext != 1)
+        leveled_row_u64<true, true>(out, ct0, ct1, cleartext, len);
+      else
+        leveled_row_u64<false, true>(out, ct0, ct1, cleartext, len);
+    }
+
+    if (batch.plaintexts != nullptr)
+      out[(len - 1) * batch.out_stride1] +=
+          batch.plaintexts[i * batch.plaintexts_stride];
+  }
+}
+
+/// Computes a batched leveled operation, splitting the batch in contiguous
+/// ranges over the batch worker threads when it is large enough. When called
+/// from an already parallel region, a dataflow task or a concurrent call, the
+/// batch is processed by the calling thread only.
+void batched_leveled_u64(const LeveledBatch &batch) {
+  if (batch.batch_size == 0 || batch.lwe_size == 0)
+    return;
+
+  size_t num_threads = 1;
+  if (batch.batch_size * batch.lwe_size >= LEVELED_PARALLEL_THRESHOLD &&
+      !omp_in_parallel() && !mlir::concretelang::ConcurrentScope::active())
+    num_threads = std::min(get_batch_num_threads(), batch.batch_size);
+  if (num_threads <= 1) {
+    leveled_rows_u64(batch, 0, batch.batch_size);
+    return;
+  }
+
+#pragma omp parallel num_threads(num_threads)
+  {
+    size_t thread = omp_get_thread_num();
+    size_t threads = omp_get_num_threads();
+    leveled_rows_u64(batch, batch.batch_size * thread / threads,
+                     batch.batch_size * (thread + 1) / threads);
+  }
+}
+
+} // namespace
+
 void memref_batched_add_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -652,14 +777,13 @@ void memref_batched_add_lwe_ciphertexts_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
     uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_lwe_ciphertexts_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        ct1_allocated + i * ct1_size1, ct1_aligned + i * ct1_size1, ct1_offset,
-        ct1_size1, ct1_stride1);
-  }
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size0 &&
+         out_size1 == ct0_size1 && out_size1 == ct1_size1 &&
+         "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       ct1_aligned + ct1_offset, ct1_stride0, ct1_stride1,
+                       nullptr, 0, nullptr, 0, out_size0, out_size1});
 }
 
 void memref_batched_add_plaintext_lwe_ciphertext_u64(
@@ -670,13 +794,12 @@ void memref_batched_add_plaintext_lwe_ciphertext_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
     uint64_t ct1_stride) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
-  }
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size &&
+         out_size1 == ct0_size1 && "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       nullptr, 0, 0, nullptr, 0, ct1_aligned + ct1_offset,
+                       ct1_stride, out_size0, out_size1});
 }
 
 void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
@@ -685,13 +808,12 @@ void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        plaintext);
-  }
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       nullptr, 0, 0, nullptr, 0, &plaintext, 0, out_size0,
+                       out_size1});
 }
 
 void memref_batched_mul_cleartext_lwe_ciphertext_u64(
@@ -702,13 +824,12 @@ void memref_batched_mul_cleartext_lwe_ciphertext_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
     uint64_t ct1_stride) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
-  }
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size &&
+         out_size1 == ct0_size1 && "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       nullptr, 0, 0, ct1_aligned + ct1_offset, ct1_stride,
+                       nullptr, 0, out_size0, out_size1});
 }
 
 void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
@@ -717,13 +838,12 @@ void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        cleartext);
-  }
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       nullptr, 0, 0, &cleartext, 0, nullptr, 0, out_size0,
+                       out_size1});
 }
 
 void memref_batched_negate_lwe_ciphertext_u64(
@@ -732,12 +852,34 @@ void memref_batched_negate_lwe_ciphertext_u64(
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_negate_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1);
-  }
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         "size of lwe buffer are incompatible");
+  // The negation wraps around 2^64 as a multiplication by -1 does
+  uint64_t minus_one = UINT64_MAX;
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       nullptr, 0, 0, &minus_one, 0, nullptr, 0, out_size0,
+                       out_size1});
+}
+
+void memref_batched_mul_cleartext_add_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride, uint64_t *ct2_allocated, uint64_t *ct2_aligned,
+    uint64_t ct2_offset, uint64_t ct2_size0, uint64_t ct2_size1,
+    uint64_t ct2_stride0, uint64_t ct2_stride1) {
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size &&
+         out_size0 == ct2_size0 && out_size1 == ct0_size1 &&
+         out_size1 == ct2_size1 && "size of lwe buffer are incompatible");
+  batched_leveled_u64({out_aligned + out_offset, out_stride0, out_stride1,
+                       ct0_aligned + ct0_offset, ct0_stride0, ct0_stride1,
+                       ct2_aligned + ct2_offset, ct2_stride0, ct2_stride1,
+                       ct1_aligned + ct1_offset, ct1_stride, nullptr, 0,
+                       out_size0, out_size1});
 }
 
 void memref_batched_keyswitch_lwe_u64(
@@ -768,28 +910,31 @@ void memref_bootstrap_lwe_u64(
     uint32_t glwe_dimension, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
 
-  uint64_t glwe_ct_size = polynomial_size * (glwe_dimension + 1);
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
-  auto tlu = tlu_aligned + tlu_offset;
-
+  auto &arena = context->scratch_arena();
   // Glwe trivial encryption
-  for (size_t i = 0; i < polynomial_size * glwe_dimension; i++) {
-    glwe_ct[i] = 0;
-  }
-  for (size_t i = 0; i < polynomial_size; i++) {
-    glwe_ct[polynomial_size * glwe_dimension + i] = tlu[i];
-  }
+  auto glwe_ct = arena.glwe_accumulator(tlu_aligned + tlu_offset,
+                                        glwe_dimension, polynomial_size);
 
   // Get fourrier bootstrap key
-  const auto &fft = context->fft(bsk_index);
   auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto grouping_factor = context->bootstrap_grouping_factor(bsk_index);
+  if (grouping_factor > 1) {
+    concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+        out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
+        bootstrap_key, decomposition_level_count, decomposition_base_log,
+        glwe_dimension, polynomial_size, input_lwe_dimension, grouping_factor,
+        get_multi_bit_num_threads());
+    return;
+  }
+  const auto &fft = context->fft(bsk_index);
   // Get stack parameter
   size_t scratch_size;
   size_t scratch_align;
   concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
       &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
-  // Allocate scratch
-  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+  // Get scratch
+  auto scratch =
+      arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
 
   // Bootstrap
   concrete_cpu_bootstrap_lwe_ciphertext_u64(
@@ -797,9 +942,271 @@ void memref_bootstrap_lwe_u64(
       bootstrap_key, decomposition_level_count, decomposition_base_log,
       glwe_dimension, polynomial_size, input_lwe_dimension, fft, scratch,
       scratch_size);
+}
 
-  free(glwe_ct);
-  free(scratch);
+void memref_many_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t input_lwe_dimension,
+    uint32_t polynomial_size, uint32_t decomposition_level_count,
+    uint32_t decomposition_base_log, uint32_t glwe_dimension,
+    uint32_t lut_stride, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  // The outputs are extracted one after the other by concrete-cpu
+  assert(out_stride1 == 1 && out_stride0 == out_size1);
+  assert(out_size0 * lut_stride <= polynomial_size);
+
+  auto &arena = context->scratch_arena();
+  // Glwe trivial encryption of the packed lookup tables
+  auto glwe_ct = arena.glwe_accumulator(tlu_aligned + tlu_offset,
+                                        glwe_dimension, polynomial_size);
+
+  // Get fourrier bootstrap key
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto grouping_factor = context->bootstrap_grouping_factor(bsk_index);
+  if (grouping_factor > 1) {
+    // The stack only holds the rotated accumulator
+    size_t scratch_size;
+    size_t scratch_align;
+    concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64_scratch(
+        &scratch_size, &scratch_align, glwe_dimension, polynomial_size);
+    auto scratch =
+        arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
+    concrete_cpu_multi_bit_bootstrap_many_lut_lwe_ciphertext_u64(
+        out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
+        bootstrap_key, decomposition_level_count, decomposition_base_log,
+        glwe_dimension, polynomial_size, input_lwe_dimension, grouping_factor,
+        out_size0, lut_stride, get_multi_bit_num_threads(), scratch,
+        scratch_size);
+    return;
+  }
+  const auto &fft = context->fft(bsk_index);
+  // Get stack parameter, the many lut bootstrap has the same requirements as
+  // the single lut one
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
+  // Get scratch
+  auto scratch =
+      arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
+
+  // Bootstrap once, extract `out_size0` ciphertexts
+  concrete_cpu_bootstrap_many_lut_lwe_ciphertext_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
+      bootstrap_key, decomposition_level_count, decomposition_base_log,
+      glwe_dimension, polynomial_size, input_lwe_dimension, out_size0,
+      lut_stride, fft, scratch, scratch_size);
+}
+
+// Asynchronous wrappers //////////////////////////////////////////////////////
+
+void *memref_keyswitch_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto &pool = WorkStealingPool::global();
+  return new WorkStealingPool::Future(pool.submit([=]() {
+    memref_keyswitch_lwe_u64(out_allocated, out_aligned, out_offset, out_size,
+                             out_stride, ct0_allocated, ct0_aligned,
+                             ct0_offset, ct0_size, ct0_stride, level, base_log,
+                             input_lwe_dim, output_lwe_dim, ksk_index, context);
+  }));
+}
+
+void *memref_bootstrap_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  // The bootstrap runs on a pool worker and therefore uses that worker's
+  // scratch arena, so concurrent bootstraps never share scratch space.
+  auto &pool = WorkStealingPool::global();
+  return new WorkStealingPool::Future(pool.submit([=]() {
+    memref_bootstrap_lwe_u64(
+        out_allocated, out_aligned, out_offset, out_size, out_stride,
+        ct0_allocated, ct0_aligned, ct0_offset, ct0_size, ct0_stride,
+        tlu_allocated, tlu_aligned, tlu_offset, tlu_size, tlu_stride,
+        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
+        context);
+  }));
+}
+
+void memref_await_future(uint64_t *out_allocated, uint64_t *out_aligned,
+                         uint64_t out_offset, uint64_t out_size,
+                         uint64_t out_stride, void *future,
+                         uint64_t *in_allocated, uint64_t *in_aligned,
+                         uint64_t in_offset, uint64_t in_size,
+                         uint64_t in_stride) {
+  auto handle = static_cast<WorkStealingPool::Future *>(future);
+  WorkStealingPool::global().wait(*handle);
+  delete handle;
+
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *in = in_aligned + in_offset;
+  if (out == in)
+    return;
+  assert(out_size == in_size);
+  for (size_t i = 0; i < out_size; i++)
+    out[i * out_stride] = in[i * in_stride];
+}
+
+namespace {
+
+/// Bootstraps the `batch_size` ciphertexts of `ct0`, using the lut
+/// `tlus + i * tlu_stride` for the i-th ciphertext.
+///
+/// The batch is split over the batch worker threads, each of them using the
+/// scratch of its own scratch arena for all the ciphertexts it processes. A
+/// lut shared by the whole batch (`tlu_stride == 0`) is encrypted once into an
+/// accumulator read by all the threads, otherwise each thread rebuilds the
+/// accumulator of its own arena for each ciphertext. When called from an
+/// already parallel region (e.g. a loop parallelized by the compiler), the
+/// batch is processed by the calling thread only. The multi-bit bootstraps of
+/// a batch are computed on a single thread each, the batch being parallel.
+void batched_bootstrap_lwe_u64(uint64_t *out, uint64_t out_size,
+                               const uint64_t *ct0, uint64_t ct0_size,
+                               size_t batch_size, const uint64_t *tlus,
+                               uint64_t tlu_stride, uint32_t input_lwe_dim,
+                               uint32_t poly_size, uint32_t level,
+                               uint32_t base_log, uint32_t glwe_dim,
+                               uint32_t bsk_index,
+                               mlir::concretelang::RuntimeContext *context) {
+  if (batch_size == 0)
+    return;
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto grouping_factor = context->bootstrap_grouping_factor(bsk_index);
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dim, poly_size, fft);
+  size_t num_threads = std::min(get_batch_num_threads(), batch_size);
+
+  const uint64_t *shared_glwe_ct = nullptr;
+  if (tlu_stride == 0)
+    shared_glwe_ct =
+        context->scratch_arena().glwe_accumulator(tlus, glwe_dim, poly_size);
+
+#pragma omp parallel num_threads(num_threads)
+  {
+    // Per thread buffers
+    auto &arena = context->scratch_arena();
+    auto scratch =
+        arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
+
+#pragma omp for schedule(static)
+    for (size_t i = 0; i < batch_size; i++) {
+      // Glwe trivial encryption
+      auto glwe_ct = shared_glwe_ct != nullptr
+                         ? shared_glwe_ct
+                         : arena.glwe_accumulator(tlus + i * tlu_stride,
+                                                  glwe_dim, poly_size);
+      if (grouping_factor > 1)
+        concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+            out + i * out_size, ct0 + i * ct0_size, glwe_ct, bootstrap_key,
+            level, base_log, glwe_dim, poly_size, input_lwe_dim,
+            grouping_factor, 1);
+      else
+        concrete_cpu_bootstrap_lwe_ciphertext_u64(
+            out + i * out_size, ct0 + i * ct0_size, glwe_ct, bootstrap_key,
+            level, base_log, glwe_dim, poly_size, input_lwe_dim, fft, scratch,
+            scratch_size);
+    }
+  }
+}
+
+// Number of output ciphertexts of a row computed together by the matrix
+// product, each chunk of an input ciphertext being loaded once for all of them.
+constexpr size_t MATMUL_COLUMN_BLOCK = 8;
+// Number of lwe coefficients processed together by the matrix product, so
+// that the output chunks of a block stay in the L1 cache while accumulating
+// and the input chunks of a row in the L2 cache across the column blocks.
+constexpr size_t MATMUL_LWE_BLOCK = 256;
+
+/// Accumulates `COLUMNS` output chunks of `len` lwe coefficients,
+/// `out[c][l] = sum_k lhs[k * lhs_stride + l] * rhs[k * rhs_stride + c *
+/// rhs_column_stride]`.
+///
+/// The products and the sums wrap around 2^64, as the leveled operations on
+/// lwe ciphertexts do. Cleartexts that are zero for all the columns of the
+/// block are skipped, quantized weights being often sparse.
+template <size_t COLUMNS>
+inline __attribute__((always_inline)) void
+matmul_lwe_block_u64(uint64_t *const *out, const uint64_t *lhs,
+                     uint64_t lhs_stride, const uint64_t *rhs,
+                     uint64_t rhs_stride, uint64_t rhs_column_stride,
+                     size_t k_size, size_t len) {
+  for (size_t c = 0; c < COLUMNS; c++)
+    std::fill(out[c], out[c] + len, 0);
+
+  for (size_t k = 0; k < k_size; k++) {
+    uint64_t cleartexts[COLUMNS];
+    bool all_zero = true;
+    for (size_t c = 0; c < COLUMNS; c++) {
+      cleartexts[c] = rhs[k * rhs_stride + c * rhs_column_stride];
+      all_zero &= cleartexts[c] == 0;
+    }
+    if (all_zero)
+      continue;
+
+    const uint64_t *ct = lhs + k * lhs_stride;
+#pragma omp simd
+    for (size_t l = 0; l < len; l++) {
+      uint64_t coefficient = ct[l];
+      for (size_t c = 0; c < COLUMNS; c++)
+        out[c][l] += coefficient * cleartexts[c];
+    }
+  }
+}
+
+/// Computes the chunks `[first_coefficient, first_coefficient + len)` of the
+/// ciphertexts of the `row`-th row of the matrix product.
+RUNTIME_TARGET_CLONES void
+matmul_lwe_row_chunk_u64(uint64_t *out, uint64_t out_stride0,
+                         uint64_t out_stride1, const uint64_t *ct0,
+                         uint64_t ct0_stride0, uint64_t ct0_stride1,
+                         const uint64_t *ct1, uint64_t ct1_stride0,
+                         uint64_t ct1_stride1, size_t inner, size_t columns,
+                         size_t row, size_t first_coefficient, size_t len) {
+  const uint64_t *lhs = ct0 + row * ct0_stride0 + first_coefficient;
+  uint64_t *chunks[MATMUL_COLUMN_BLOCK];
+  for (size_t first_column = 0; first_column < columns;
+       first_column += MATMUL_COLUMN_BLOCK) {
+    size_t num_columns = std::min(MATMUL_COLUMN_BLOCK, columns - first_column);
+    const uint64_t *rhs = ct1 + first_column * ct1_stride1;
+    for (size_t c = 0; c < num_columns; c++)
+      chunks[c] = out + row * out_stride0 + (first_column + c) * out_stride1 +
+                  first_coefficient;
+
+    if (num_columns == MATMUL_COLUMN_BLOCK) {
+      matmul_lwe_block_u64<MATMUL_COLUMN_BLOCK>(chunks, lhs, ct0_stride1, rhs,
+                                                ct1_stride0, ct1_stride1,
+                                                inner, len);
+    } else {
+      for (size_t c = 0; c < num_columns; c++)
+        matmul_lwe_block_u64<1>(&chunks[c], lhs, ct0_stride1,
+                                rhs + c * ct1_stride1, ct1_stride0,
+                                ct1_stride1, inner, len);
+    }
+  }
+}
+
+} // namespace
+
+void concrete_set_batch_num_threads(size_t num_threads) {
+  batch_num_threads.store(num_threads);
 }
 
 void memref_batched_bootstrap_lwe_u64(
@@ -812,15 +1219,11 @@ void memref_batched_bootstrap_lwe_u64(
     uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
-
-  for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated, tlu_aligned,
-        tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size, level,
-        base_log, glwe_dim, bsk_index, context);
-  }
+  batched_bootstrap_lwe_u64(out_aligned + out_offset, out_size1,
+                            ct0_aligned + ct0_offset, ct0_size1, out_size0,
+                            tlu_aligned + tlu_offset, 0, input_lwe_dim,
+                            poly_size, level, base_log, glwe_dim, bsk_index,
+                            context);
 }
 
 void memref_batched_mapped_bootstrap_lwe_u64(
@@ -835,14 +1238,52 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
   assert(out_size0 == tlu_size0 && "Number of LUTs does not match batch size");
-  for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated,
-        tlu_aligned + i * tlu_size1, tlu_offset, tlu_size1, tlu_stride1,
-        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
-        context);
+  batched_bootstrap_lwe_u64(out_aligned + out_offset, out_size1,
+                            ct0_aligned + ct0_offset, ct0_size1, out_size0,
+                            tlu_aligned + tlu_offset, tlu_size1, input_lwe_dim,
+                            poly_size, level, base_log, glwe_dim, bsk_index,
+                            context);
+}
+
+void memref_matmul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_stride0, uint64_t out_stride1, uint64_t out_stride2,
+    uint64_t *ct0_allocated, uint64_t *ct0_aligned, uint64_t ct0_offset,
+    uint64_t ct0_size0, uint64_t ct0_size1, uint64_t ct0_size2,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  assert(out_stride2 == 1 && ct0_stride2 == 1);
+  assert(out_size0 == ct0_size0 && "number of rows does not match");
+  assert(out_size1 == ct1_size1 && "number of columns does not match");
+  assert(ct0_size1 == ct1_size0 && "inner dimensions do not match");
+  assert(out_size2 == ct0_size2 && "size of lwe buffer are incompatible");
+
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  const uint64_t *ct1 = ct1_aligned + ct1_offset;
+  size_t rows = out_size0;
+  size_t columns = out_size1;
+  size_t lwe_size = out_size2;
+
+  // The rows are split in chunks of MATMUL_LWE_BLOCK coefficients, the
+  // chunks being independent.
+  size_t lwe_blocks = (lwe_size + MATMUL_LWE_BLOCK - 1) / MATMUL_LWE_BLOCK;
+  size_t num_tiles = rows * lwe_blocks;
+  if (num_tiles == 0 || columns == 0)
+    return;
+  size_t num_threads = std::min(get_batch_num_threads(), num_tiles);
+
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (size_t tile = 0; tile < num_tiles; tile++) {
+    size_t row = tile / lwe_blocks;
+    size_t first_coefficient = (tile % lwe_blocks) * MATMUL_LWE_BLOCK;
+    size_t len = std::min(MATMUL_LWE_BLOCK, lwe_size - first_coefficient);
+    matmul_lwe_row_chunk_u64(out, out_stride0, out_stride1, ct0, ct0_stride0,
+                             ct0_stride1, ct1, ct1_stride0, ct1_stride1,
+                             ct0_size1, columns, row, first_coefficient, len);
   }
 }
 
@@ -898,9 +1339,12 @@ void memref_wop_pbs_crt_buffer(
   assert(lwe_big_dim % polynomial_size == 0);
   uint64_t glwe_dim = lwe_big_dim / polynomial_size;
 
+  auto &arena = context->scratch_arena();
+
   // Compute the numbers of bits to extract for each block and the total one.
   uint64_t total_number_of_bits_per_block = 0;
-  auto number_of_bits_per_block = new uint64_t[crt_decomp_size]();
+  auto number_of_bits_per_block =
+      arena.get<uint64_t>(ScratchArena::BIT_COUNTS, crt_decomp_size);
   for (uint64_t i = 0; i < crt_decomp_size; i++) {
     uint64_t modulus = crt_decomp_aligned[i + crt_decomp_offset];
     uint64_t nb_bit_to_extract =
@@ -916,13 +1360,19 @@ void memref_wop_pbs_crt_buffer(
   //
   // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
   // is the size of the crt decomposition
-  auto extract_bits_output_buffer =
-      new uint64_t[lwe_small_size * total_number_of_bits_per_block]{0};
+  auto extract_bits_output_size =
+      lwe_small_size * total_number_of_bits_per_block;
+  auto extract_bits_output_buffer = arena.get<uint64_t>(
+      ScratchArena::OUTPUT_CIPHERTEXTS, extract_bits_output_size);
+  memset(extract_bits_output_buffer, 0,
+         extract_bits_output_size * sizeof(uint64_t));
 
   // We make a private copy to apply a subtraction on the body
   auto first_ciphertext = in_aligned + in_offset;
   auto copy_size = crt_decomp_size * lwe_big_size;
-  std::vector<uint64_t> in_copy(first_ciphertext, first_ciphertext + copy_size);
+  auto in_copy =
+      arena.get<uint64_t>(ScratchArena::INPUT_CIPHERTEXTS, copy_size);
+  memcpy(in_copy, first_ciphertext, copy_size * sizeof(uint64_t));
   // Extraction of each bit for each block
 
   const auto &fft = context->fft(bsk_index);
@@ -947,8 +1397,9 @@ void memref_wop_pbs_crt_buffer(
     concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
         &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim, glwe_dim,
         polynomial_size, fft);
-    // Allocate scratch
-    auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+    // Get scratch
+    auto *scratch =
+        arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
 
     concrete_cpu_extract_bit_lwe_ciphertext_u64(
         &extract_bits_output_buffer[lwe_small_size *
@@ -958,8 +1409,6 @@ void memref_wop_pbs_crt_buffer(
         bsk_level_count, bsk_base_log, glwe_dim, polynomial_size, lwe_small_dim,
         ksk_level_count, ksk_base_log, lwe_big_dim, lwe_small_dim, fft, scratch,
         scratch_size);
-
-    free(scratch);
   }
 
   size_t ct_in_count = total_number_of_bits_per_block;
@@ -978,7 +1427,8 @@ void memref_wop_pbs_crt_buffer(
       lut_size, lut_count, glwe_dim, polynomial_size, polynomial_size,
       cbs_level_count, fft);
 
-  auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+  auto *scratch =
+      arena.get(ScratchArena::FFT_SCRATCH, scratch_size, scratch_align);
 
   auto fp_keyswicth_key = context->fp_keyswitch_key_buffer(pksk_index);
 
@@ -990,8 +1440,6 @@ void memref_wop_pbs_crt_buffer(
       lwe_small_dim, fpksk_level_count, fpksk_base_log, lwe_big_dim, glwe_dim,
       polynomial_size, glwe_dim + 1, cbs_level_count, cbs_base_log, fft,
       scratch, scratch_size);
-
-  free(scratch);
 }
 
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
@@ -7,17 +7,20 @@
 #include <functional>
 #include <llvm/ADT/SmallSet.h>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "boost/outcome.h"
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/Parallel.h"
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/DFRuntime.hpp"
 #include "concretelang/Runtime/context.h"
+#include "concretelang/Runtime/work_stealing_pool.hpp"
 #include "concretelang/ServerLib/ServerLib.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -429,28 +432,118 @@ bool getGateIsSigned(const Message<concreteprotocol::GateInfo> &gateInfo) {
   assert(false);
 }
 
+/// Returns pointers to the elements of `values`.
+std::vector<const TransportValue *>
+toTransportValueRefs(const std::vector<TransportValue> &values) {
+  std::vector<const TransportValue *> refs;
+  refs.reserve(values.size());
+  for (auto &value : values) {
+    refs.push_back(&value);
+  }
+  return refs;
+}
+
 Result<std::vector<TransportValue>>
 ServerCircuit::call(const ServerKeyset &serverKeyset,
-                    std::vector<TransportValue> &args) {
-  std::vector<TransportValue> returns(returnsBuffer.size());
+                    std::vector<TransportValue> &args) const {
+  return call(serverKeyset, toTransportValueRefs(args));
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::call(const ServerKeyset &serverKeyset,
+                    const std::vector<const TransportValue *> &args) const {
+  mlir::concretelang::dfr::_dfr_register_lib(dynamicModule->libraryHandle);
+  if (!mlir::concretelang::dfr::_dfr_is_root_node()) {
+    mlir::concretelang::dfr::_dfr_run_remote_scheduler();
+    return std::vector<TransportValue>(returnTransformers.size());
+  }
+
+  // We get the runtime context prepared for the keyset. The context is shared
+  // with the other calls made with the same keyset.
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      runtimeContextCache->get(serverKeyset);
+  return callWithContext(runtimeContext.get(), args);
+}
+
+Result<std::vector<std::vector<TransportValue>>>
+ServerCircuit::callBatch(const ServerKeyset &serverKeyset,
+                         std::vector<std::vector<TransportValue>> &batch,
+                         BatchOptions options) const {
+  std::vector<std::vector<const TransportValue *>> batchRefs;
+  batchRefs.reserve(batch.size());
+  for (auto &args : batch) {
+    batchRefs.push_back(toTransportValueRefs(args));
+  }
+  return callBatch(serverKeyset, batchRefs, options);
+}
+
+Result<std::vector<std::vector<TransportValue>>> ServerCircuit::callBatch(
+    const ServerKeyset &serverKeyset,
+    const std::vector<std::vector<const TransportValue *>> &batch,
+    BatchOptions options) const {
+  std::vector<std::vector<TransportValue>> returns(batch.size());
   mlir::concretelang::dfr::_dfr_register_lib(dynamicModule->libraryHandle);
   if (!mlir::concretelang::dfr::_dfr_is_root_node()) {
     mlir::concretelang::dfr::_dfr_run_remote_scheduler();
     return returns;
   }
 
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      runtimeContextCache->get(serverKeyset);
+
+  // The calls share nothing but the (read-only) circuit and runtime context,
+  // so that they can run in any order.
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      batch.size());
+  auto callOne = [&](size_t i) {
+    results[i] = callWithContext(runtimeContext.get(), batch[i]);
+  };
+  if (options.concurrent && batch.size() > 1) {
+    size_t numThreads =
+        options.numThreads > 0
+            ? options.numThreads
+            : parallel::getNumThreads("CONCRETE_SERVER_NUM_THREADS");
+    // The calls keep their multi-bit bootstraps on their own thread.
+    parallel::parallelFor(batch.size(), numThreads, [&](size_t i) {
+      mlir::concretelang::ConcurrentScope scope;
+      callOne(i);
+    });
+  } else {
+    for (size_t i = 0; i < batch.size(); i++) {
+      callOne(i);
+    }
+  }
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    OUTCOME_TRY(returns[i], std::move(*results[i]));
+  }
+  return returns;
+}
+
+Result<std::vector<TransportValue>> ServerCircuit::callWithContext(
+    RuntimeContext *runtimeContext,
+    const std::vector<const TransportValue *> &args) const {
+  // The args and returns buffers are local to this call, which makes it
+  // possible to call the same circuit from multiple threads.
+  std::vector<Value> argsBuffer(argTransformers.size());
+  std::vector<Value> returnsBuffer(returnTransformers.size());
+  std::vector<TransportValue> returns(returnsBuffer.size());
+
   if (args.size() != argsBuffer.size()) {
     return StringError("Called circuit with wrong number of arguments");
   }
 
   // We load the processed arguments in the args buffer.
   for (size_t i = 0; i < argsBuffer.size(); i++) {
-    OUTCOME_TRY(argsBuffer[i], argTransformers[i](args[i]));
+    if (args[i] == nullptr) {
+      return StringError("Called circuit with a missing argument");
+    }
+    OUTCOME_TRY(argsBuffer[i], argTransformers[i](*args[i]));
   }
 
   // The arguments has been pushed in the arg buffer, we are now ready to
   // invoke the circuit function.
-  invoke(serverKeyset);
+  invoke(runtimeContext, argsBuffer, returnsBuffer);
 
   // We process the return values to turn them into transport values.
   for (size_t i = 0; i < returnsBuffer.size(); i++) {
@@ -461,7 +554,13 @@ ServerCircuit::call(const ServerKeyset &serverKeyset,
 }
 
 Result<std::vector<TransportValue>>
-ServerCircuit::simulate(std::vector<TransportValue> &args) {
+ServerCircuit::simulate(std::vector<TransportValue> &args) const {
+  ServerKeyset emptyKeyset;
+  return call(emptyKeyset, args);
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::simulate(const std::vector<const TransportValue *> &args) const {
   ServerKeyset emptyKeyset;
   return call(emptyKeyset, args);
 }
@@ -472,12 +571,15 @@ std::string ServerCircuit::getName() {
 
 Result<ServerCircuit> ServerCircuit::fromDynamicModule(
     const Message<concreteprotocol::CircuitInfo> &circuitInfo,
-    std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation = false) {
+    std::shared_ptr<DynamicModule> dynamicModule,
+    std::shared_ptr<RuntimeContextCache> runtimeContextCache,
+    bool useSimulation = false) {
 
   ServerCircuit output;
   output.circuitInfo = circuitInfo;
   output.useSimulation = useSimulation;
   output.dynamicModule = dynamicModule;
+  output.runtimeContextCache = runtimeContextCache;
   output.func = (void (*)(void *, ...))dlsym(
       dynamicModule->libraryHandle,
       (std::string("_mlir_concrete_") +
@@ -534,11 +636,6 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
     output.returnTransformers.push_back(transformer);
   }
 
-  output.argsBuffer =
-      std::vector<Value>(circuitInfo.asReader().getInputs().size());
-  output.returnsBuffer =
-      std::vector<Value>(circuitInfo.asReader().getOutputs().size());
-
   output.argRawSize = 0;
   for (auto gateInfo : circuitInfo.asReader().getInputs()) {
     auto descriptorSize = getGateDescriptionSize(
@@ -558,12 +655,12 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
   return output;
 }
 
-void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
+void ServerCircuit::invoke(RuntimeContext *runtimeContext,
+                           std::vector<Value> &argsBuffer,
+                           std::vector<Value> &returnsBuffer) const {
 
-  // We create a runtime context from the keyset, and place a pointer to it in
-  // the structure.
-  RuntimeContext runtimeContext = RuntimeContext(serverKeyset);
-  RuntimeContext *_runtimeContextPtr = &runtimeContext;
+  // We place a pointer to the runtime context in the structure.
+  RuntimeContext *_runtimeContextPtr = runtimeContext;
 
   auto _argRaws = std::vector<void *>(this->argRawSize);
   auto _argRawMaps = std::vector<llvm::MutableArrayRef<void *>>();
@@ -638,15 +735,17 @@ ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
   ServerProgram output;
   OUTCOME_TRY(auto dynamicModule, DynamicModule::open(sharedLibPath));
   auto sharedDynamicModule = std::shared_ptr<DynamicModule>(dynamicModule);
+  auto runtimeContextCache = std::make_shared<RuntimeContextCache>();
   std::vector<ServerCircuit> serverCircuits;
   for (auto circuitInfo : programInfo.asReader().getCircuits()) {
     OUTCOME_TRY(auto serverCircuit,
                 ServerCircuit::fromDynamicModule(
                     (Message<concreteprotocol::CircuitInfo>)circuitInfo,
-                    sharedDynamicModule, useSimulation));
+                    sharedDynamicModule, runtimeContextCache, useSimulation));
     serverCircuits.push_back(serverCircuit);
   }
   output.serverCircuits = serverCircuits;
+  output.runtimeContextCache = runtimeContextCache;
   return output;
 }
 
@@ -661,5 +760,17 @@ ServerProgram::getServerCircuit(const std::string &circuitName) {
                      "`");
 }
 
+bool ServerProgram::evictRuntimeContext(const ServerKeyset &serverKeyset) {
+  return runtimeContextCache->evict(serverKeyset);
+}
+
+void ServerProgram::evictAllRuntimeContexts() {
+  runtimeContextCache->evictAll();
+}
+
+RuntimeContextCache::Metrics ServerProgram::getRuntimeContextCacheMetrics() {
+  return runtimeContextCache->getMetrics();
+}
+
 } // namespace serverlib
 } // namespace concretelang
@@ -0,0 +1,17 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Support/BuildId.h"
+
+// Generated from the sources at build time, see lib/Support/CMakeLists.txt
+#include "BuildIdStamp.h"
+
+namespace mlir {
+namespace concretelang {
+
+const char *getCompilerBuildId() { return CONCRETELANG_BUILD_ID; }
+
+} // namespace concretelang
+} // namespace mlir
@@ -87,9 +87,15 @@ void ProgramCompilationFeedback::fillFromProgramInfo(
     auto outputLweDimension = outputKeyInfo.getParams().getLweDimension();
     auto level = bskInfo.getParams().getLevelCount();
     auto glweDimension = bskInfo.getParams().getGlweDimension();
+    auto groupingFactor = bskInfo.getParams().getGroupingFactor();
     totalBootstrapKeysSize +=
-        concrete_cpu_bootstrap_key_size_u64(
-            level, glweDimension, outputLweDimension, inputLweDimension) *
+        (groupingFactor > 1
+             ? concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                   level, glweDimension, outputLweDimension, inputLweDimension,
+                   groupingFactor)
+             : concrete_cpu_bootstrap_key_size_u64(level, glweDimension,
+                                                   outputLweDimension,
+                                                   inputLweDimension)) *
         byteSize;
   }
   // Compute the keyswitch keys size
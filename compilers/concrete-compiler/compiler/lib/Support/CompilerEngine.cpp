@@ -35,12 +35,15 @@
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/ExecutionEngine/OptUtils.h"
 #include "mlir/Parser/Parser.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SMLoc.h"
 
 #include "concrete-protocol.capnp.h"
+#include "concretelang/Common/Parallel.h"
 #include "concretelang/Conversion/Utils/GlobalFHEContext.h"
 #include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
 #include "concretelang/Dialect/Concrete/Transforms/BufferizableOpInterfaceImpl.h"
@@ -57,6 +60,7 @@
 #include "concretelang/Dialect/Tracing/Transforms/BufferizableOpInterfaceImpl.h"
 #include "concretelang/Dialect/TypeInference/IR/TypeInferenceDialect.h"
 #include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Support/BuildId.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/Support/Encodings.h"
 #include "concretelang/Support/Error.h"
@@ -99,6 +103,130 @@ std::string getCompilationFeedbackPath(std::string outputDirPath) {
   llvm::sys::path::append(compilationFeedbackPath, "compilation_feedback.json");
   return compilationFeedbackPath.str().str();
 }
+
+/// Returns whether the compilation options can be fully described by
+/// `writeCompilationOptionsSignature`.
+bool isCacheable(const mlir::concretelang::CompilationOptions &options) {
+  return options.optimizerConfig.keyset_restriction == nullptr;
+}
+
+template <typename T>
+void writeListSignature(llvm::raw_ostream &os, const T &values) {
+  os << "[";
+  for (auto value : values)
+    os << value << ",";
+  os << "]";
+}
+
+/// Writes every compilation option that may change the compilation artifacts.
+void writeCompilationOptionsSignature(
+    llvm::raw_ostream &os,
+    const mlir::concretelang::CompilationOptions &options) {
+  if (options.v0FHEConstraints.has_value()) {
+    os << "v0FHEConstraints:" << options.v0FHEConstraints->norm2 << ","
+       << options.v0FHEConstraints->p << "\n";
+  }
+  auto writeLargeInteger =
+      [&](const mlir::concretelang::LargeIntegerParameter &param) {
+        writeListSignature(os, param.crtDecomposition);
+        auto &pks = param.wopPBS.packingKeySwitch;
+        auto &cbs = param.wopPBS.circuitBootstrap;
+        os << "," << pks.inputLweDimension << "," << pks.outputPolynomialSize
+           << "," << pks.level << "," << pks.baseLog << "," << cbs.level << ","
+           << cbs.baseLog;
+      };
+  if (options.v0Parameter.has_value()) {
+    auto &param = *options.v0Parameter;
+    os << "v0Parameter:" << param.glweDimension << ","
+       << param.logPolynomialSize << "," << param.nSmall << ","
+       << param.brLevel << "," << param.brLogBase << "," << param.ksLevel
+       << "," << param.ksLogBase << ",";
+    if (param.largeInteger.has_value())
+      writeLargeInteger(*param.largeInteger);
+    os << "\n";
+  }
+  if (options.largeIntegerParameter.has_value()) {
+    os << "largeIntegerParameter:";
+    writeLargeInteger(*options.largeIntegerParameter);
+    os << "\n";
+  }
+  os << "flags:" << options.simulate
+     << options.enableOverflowDetectionInSimulation << options.autoParallelize
+     << options.loopParallelize << options.dataflowParallelize
+     << options.compressEvaluationKeys << options.compressInputCiphertexts
+     << options.emitGPUOps
+     << options.batchTFHEOps << options.asyncTFHEOps << options.gemmTFHEOps
+     << options.emitSDFGOps
+     << options.unrollLoopsWithSDFGConvertibleOps << options.optimizeTFHE
+     << options.chunkIntegers << options.skipProgramInfo
+     << options.enableTluFusing << options.manyLookupTables << "\n";
+  os << "maxBatchSize:" << options.maxBatchSize << "\n";
+  os << "dataflowTaskDuration:" << options.dataflowTaskDuration << "\n";
+  os << "chunks:" << options.chunkSize << "," << options.chunkWidth << "\n";
+  os << "manyLookupTablesMaxWidth:" << options.manyLookupTablesMaxWidth
+     << "\n";
+  os << "maxMultiBitGroupingFactor:" << options.maxMultiBitGroupingFactor
+     << "\n";
+  if (options.fhelinalgTileSizes.has_value()) {
+    os << "fhelinalgTileSizes:";
+    writeListSignature(os, *options.fhelinalgTileSizes);
+    os << "\n";
+  }
+  if (options.encodings.has_value()) {
+    os << "encodings:"
+       << options.encodings->asReader().toString().flatten().cStr() << "\n";
+  }
+
+  auto &config = options.optimizerConfig;
+  os << "optimizer:" << llvm::format("%a,%a,", config.p_error,
+                                     config.global_p_error)
+     << (int)config.strategy << "," << config.key_sharing << ","
+     << (int)config.multi_param_strategy << "," << config.security << ","
+     << llvm::format("%a,", config.fallback_log_norm_woppbs)
+     << config.use_gpu_constraints << "," << (int)config.encoding << ","
+     << config.ciphertext_modulus_log << "," << config.fft_precision << ","
+     << config.composable << "\n";
+  if (config.range_restriction != nullptr) {
+    auto &restriction = *config.range_restriction;
+    os << "rangeRestriction:";
+    writeListSignature(os, restriction.glwe_log_polynomial_sizes);
+    writeListSignature(os, restriction.glwe_dimensions);
+    writeListSignature(os, restriction.internal_lwe_dimensions);
+    writeListSignature(os, restriction.pbs_level_count);
+    writeListSignature(os, restriction.pbs_base_log);
+    writeListSignature(os, restriction.ks_level_count);
+    writeListSignature(os, restriction.ks_base_log);
+    os << "\n";
+  }
+  for (auto &rule : config.composition_rules) {
+    os << "compositionRule:" << rule.from_func << "," << rule.from_pos << ","
+       << rule.to_func << "," << rule.to_pos << "\n";
+  }
+}
+
+/// Copies the artifacts listed in `names` from `fromDir` to `toDir`.
+llvm::Error copyArtifacts(llvm::StringRef fromDir, llvm::StringRef toDir,
+                          const std::vector<std::string> &names) {
+  if (auto err = llvm::sys::fs::create_directories(toDir)) {
+    return llvm::make_error<llvm::StringError>(
+        llvm::Twine("Cannot create directory \"") + toDir +
+            "\": " + err.message(),
+        err);
+  }
+  for (auto &name : names) {
+    llvm::SmallString<0> from(fromDir);
+    llvm::sys::path::append(from, name);
+    llvm::SmallString<0> to(toDir);
+    llvm::sys::path::append(to, name);
+    if (auto err = llvm::sys::fs::copy_file(from, to)) {
+      return llvm::make_error<llvm::StringError>(
+          llvm::Twine("Cannot copy \"") + from + "\" to \"" + to +
+              "\": " + err.message(),
+          err);
+    }
+  }
+  return llvm::Error::success();
+}
 } // namespace
 
 namespace mlir {
@@ -187,6 +315,7 @@ void CompilerEngine::setMaxMANP(size_t v) { this->overrideMaxMANP = v; }
 void CompilerEngine::setEnablePass(
     std::function<bool(mlir::Pass *)> enablePass) {
   this->enablePass = enablePass;
+  this->customEnablePass = true;
 }
 
 /// Returns the optimizer::Description
@@ -427,6 +556,14 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     }
   }
 
+  if (options.manyLookupTables && !options.emitGPUOps) {
+    if (mlir::concretelang::pipeline::transformFHEManyLookupTables(
+            mlirContext, module, enablePass, options.manyLookupTablesMaxWidth)
+            .failed()) {
+      return StreamStringError("Packing FHE lookup tables failed");
+    }
+  }
+
   // FHE High level pass to determine FHE parameters
   if (auto err = this->determineFHEParameters(res))
     return std::move(err);
@@ -466,8 +603,12 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return std::move(res);
 
   // FHELinalg -> FHE
-  if (mlir::concretelang::pipeline::lowerFHELinalgToLinalg(mlirContext, module,
-                                                           enablePass)
+  // The dense matrix product kernel is only available with the scalar lowering
+  bool gemmTFHEOps =
+      options.gemmTFHEOps && !options.simulate && res.fheContext.has_value() &&
+      !getCrtDecompositionFromSolution(res.fheContext->solution).has_value();
+  if (mlir::concretelang::pipeline::lowerFHELinalgToLinalg(
+          mlirContext, module, enablePass, gemmTFHEOps)
           .failed()) {
     return StreamStringError("Lowering from FHELinalg to Linalg failed");
   }
@@ -499,7 +640,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // Dataflow parallelization
   if (dataflowParallelize &&
-      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass)
+      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass,
+                                            options.dataflowTaskDuration)
           .failed()) {
     return StreamStringError("Dataflow parallelization failed");
   }
@@ -574,7 +716,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
           mlir::concretelang::createProgramInfoFromTfheDialect(
               module, options.optimizerConfig.security,
               options.encodings.value(), options.compressEvaluationKeys,
-              options.compressInputCiphertexts);
+              options.compressInputCiphertexts, options.optimizerConfig,
+              options.emitGPUOps ? 0 : options.maxMultiBitGroupingFactor);
 
       if (!programInfoOrErr)
         return programInfoOrErr.takeError();
@@ -681,7 +824,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   // the SDFG dialect.
   bool lowerDirectlyToGPUOps = (options.emitGPUOps && !options.emitSDFGOps);
   if (mlir::concretelang::pipeline::lowerToCAPI(mlirContext, module, enablePass,
-                                                lowerDirectlyToGPUOps)
+                                                lowerDirectlyToGPUOps,
+                                                options.asyncTFHEOps)
           .failed()) {
     return StreamStringError("Failed to lower to CAPI");
   }
@@ -760,22 +904,147 @@ CompilerEngine::compile(std::vector<std::string> inputs,
                         std::string runtimeLibraryPath, bool generateSharedLib,
                         bool generateStaticLib, bool generateClientParameters,
                         bool generateCompilationFeedback) {
-  using Library = mlir::concretelang::CompilerEngine::Library;
-  auto outputLib = std::make_shared<Library>(outputDirPath, runtimeLibraryPath);
-  auto target = CompilerEngine::Target::LIBRARY;
-  for (auto input : inputs) {
-    auto compilation = compile(input, target, outputLib);
-    if (!compilation) {
-      return compilation.takeError();
+  auto sources = [&]() {
+    std::string sources;
+    for (auto &input : inputs) {
+      sources += std::to_string(input.size()) + ":" + input;
     }
+    return sources;
+  };
+  return compileLibraryWithCache(
+      sources, outputDirPath, runtimeLibraryPath, generateSharedLib,
+      generateStaticLib, generateClientParameters, generateCompilationFeedback,
+      [&]() -> llvm::Expected<Library> {
+        auto outputLib =
+            std::make_shared<Library>(outputDirPath, runtimeLibraryPath);
+        auto target = CompilerEngine::Target::LIBRARY;
+        for (auto input : inputs) {
+          auto compilation = compile(input, target, outputLib);
+          if (!compilation) {
+            return compilation.takeError();
+          }
+        }
+        if (auto err = outputLib->emitArtifacts(
+                generateSharedLib, generateStaticLib, generateClientParameters,
+                generateCompilationFeedback)) {
+          return StreamStringError("Can't emit artifacts: ")
+                 << llvm::toString(std::move(err));
+        }
+        return *outputLib.get();
+      });
+}
+
+llvm::Expected<CompilerEngine::Library> CompilerEngine::compileLibraryWithCache(
+    std::function<std::string()> sources, std::string outputDirPath,
+    std::string runtimeLibraryPath, bool generateSharedLib,
+    bool generateStaticLib, bool generateClientParameters,
+    bool generateCompilationFeedback,
+    std::function<llvm::Expected<Library>()> compileLibrary) {
+  std::string cacheDir;
+  if (compilerOptions.compilationCacheDir.has_value()) {
+    cacheDir = *compilerOptions.compilationCacheDir;
+  } else if (char *env = getenv("CONCRETE_COMPILATION_CACHE_DIR")) {
+    cacheDir = env;
   }
-  if (auto err = outputLib->emitArtifacts(generateSharedLib, generateStaticLib,
-                                          generateClientParameters,
-                                          generateCompilationFeedback)) {
-    return StreamStringError("Can't emit artifacts: ")
-           << llvm::toString(std::move(err));
+  if (cacheDir.empty() || customEnablePass || !isCacheable(compilerOptions)) {
+    return compileLibrary();
   }
-  return *outputLib.get();
+
+  // Everything that may change the artifacts takes part in the key
+  std::string signature;
+  llvm::raw_string_ostream os(signature);
+  // Artifacts produced by another compiler build are never reused
+  os << "compiler:" << getCompilerBuildId() << "\n";
+  writeCompilationOptionsSignature(os, compilerOptions);
+  os << "overrides:" << overrideMaxEintPrecision.value_or(0) << ","
+     << overrideMaxMANP.value_or(0) << "," << generateProgramInfo << "\n";
+  os << "runtime:" << runtimeLibraryPath << "\n";
+  os << "artifacts:" << generateSharedLib << generateStaticLib
+     << generateClientParameters << generateCompilationFeedback << "\n";
+  os << "sources:" << sources();
+  os.flush();
+
+  std::vector<std::string> artifacts;
+  if (generateSharedLib)
+    artifacts.push_back(::getSharedLibraryPath(""));
+  if (generateStaticLib)
+    artifacts.push_back(::getStaticLibraryPath(""));
+  if (generateClientParameters)
+    artifacts.push_back(::getProgramInfoPath(""));
+  if (generateCompilationFeedback)
+    artifacts.push_back(::getCompilationFeedbackPath(""));
+
+  size_t hash = std::hash<std::string>{}(signature);
+  llvm::SmallString<0> folderPath(cacheDir);
+  llvm::sys::path::append(folderPath, std::to_string(hash));
+  llvm::SmallString<0> signaturePath(folderPath);
+  llvm::sys::path::append(signaturePath, "signature");
+
+  // Creating a lock so that concurrent compilations of the same program wait
+  // for the first one instead of all running the pipeline
+  llvm::SmallString<0> lockPath(folderPath);
+  lockPath.append("lock");
+  int lockFD;
+  llvm::sys::fs::create_directories(cacheDir);
+  if (auto err = llvm::sys::fs::openFile(
+          lockPath, lockFD, llvm::sys::fs::CreationDisposition::CD_OpenAlways,
+          llvm::sys::fs::FileAccess::FA_Write,
+          llvm::sys::fs::OpenFlags::OF_None)) {
+    return StreamStringError("Cannot access \"")
+           << std::string(lockPath) << "\": " << err.message();
+  }
+  auto unlockAtReturn = llvm::make_scope_exit([&]() {
+    llvm::sys::fs::unlockFile(lockFD);
+    llvm::sys::fs::closeFile(lockFD);
+    llvm::sys::fs::remove(lockPath);
+  });
+  llvm::sys::fs::lockFile(lockFD);
+
+  if (llvm::sys::fs::exists(folderPath)) {
+    // A hash collision must not hand out the artifacts of another program
+    auto cached = llvm::MemoryBuffer::getFile(signaturePath);
+    if (cached && (*cached)->getBuffer() == signature) {
+      if (auto err = copyArtifacts(folderPath, outputDirPath, artifacts)) {
+        return StreamStringError("Cannot reuse compilation cache entry: ")
+               << llvm::toString(std::move(err));
+      }
+      Library library(outputDirPath, runtimeLibraryPath);
+      if (generateSharedLib)
+        library.sharedLibraryPath = library.getSharedLibraryPath();
+      if (generateStaticLib)
+        library.staticLibraryPath = library.getStaticLibraryPath();
+      return library;
+    }
+    llvm::sys::fs::remove_directories(folderPath);
+  }
+
+  auto library = compileLibrary();
+  if (!library) {
+    return library.takeError();
+  }
+
+  // Failing to fill the cache does not fail the compilation
+  llvm::SmallString<0> folderIncompletePath(folderPath);
+  folderIncompletePath.append(".incomplete");
+  llvm::SmallString<0> incompleteSignaturePath(folderIncompletePath);
+  llvm::sys::path::append(incompleteSignaturePath, "signature");
+  bool stored = false;
+  if (auto err = copyArtifacts(outputDirPath, folderIncompletePath,
+                               artifacts)) {
+    llvm::consumeError(std::move(err));
+  } else {
+    std::error_code error;
+    llvm::raw_fd_ostream out(incompleteSignaturePath, error);
+    out << signature;
+    out.close();
+    stored = !error && !out.has_error() &&
+             !llvm::sys::fs::rename(folderIncompletePath, folderPath);
+    out.clear_error();
+  }
+  if (!stored) {
+    llvm::sys::fs::remove_directories(folderIncompletePath);
+  }
+  return library;
 }
 
 template <typename T>
@@ -808,9 +1077,23 @@ CompilerEngine::compile(llvm::SourceMgr &sm, std::string outputDirPath,
                         std::string runtimeLibraryPath, bool generateSharedLib,
                         bool generateStaticLib, bool generateClientParameters,
                         bool generateCompilationFeedback) {
-  return compileModuleOrSource<llvm::SourceMgr &>(
-      this, sm, outputDirPath, runtimeLibraryPath, generateSharedLib,
-      generateStaticLib, generateClientParameters, generateCompilationFeedback);
+  auto sources = [&]() {
+    std::string sources;
+    for (unsigned id = 1; id <= sm.getNumBuffers(); id++) {
+      auto buffer = sm.getMemoryBuffer(id)->getBuffer();
+      sources += std::to_string(buffer.size()) + ":" + buffer.str();
+    }
+    return sources;
+  };
+  return compileLibraryWithCache(
+      sources, outputDirPath, runtimeLibraryPath, generateSharedLib,
+      generateStaticLib, generateClientParameters, generateCompilationFeedback,
+      [&]() {
+        return compileModuleOrSource<llvm::SourceMgr &>(
+            this, sm, outputDirPath, runtimeLibraryPath, generateSharedLib,
+            generateStaticLib, generateClientParameters,
+            generateCompilationFeedback);
+      });
 }
 
 llvm::Expected<CompilerEngine::Library>
@@ -818,9 +1101,22 @@ CompilerEngine::compile(mlir::ModuleOp module, std::string outputDirPath,
                         std::string runtimeLibraryPath, bool generateSharedLib,
                         bool generateStaticLib, bool generateClientParameters,
                         bool generateCompilationFeedback) {
-  return compileModuleOrSource<mlir::ModuleOp>(
-      this, module, outputDirPath, runtimeLibraryPath, generateSharedLib,
-      generateStaticLib, generateClientParameters, generateCompilationFeedback);
+  auto sources = [&]() {
+    std::string sources;
+    llvm::raw_string_ostream os(sources);
+    module.print(os);
+    os.flush();
+    return sources;
+  };
+  return compileLibraryWithCache(
+      sources, outputDirPath, runtimeLibraryPath, generateSharedLib,
+      generateStaticLib, generateClientParameters, generateCompilationFeedback,
+      [&]() {
+        return compileModuleOrSource<mlir::ModuleOp>(
+            this, module, outputDirPath, runtimeLibraryPath, generateSharedLib,
+            generateStaticLib, generateClientParameters,
+            generateCompilationFeedback);
+      });
 }
 
 const std::string CompilerEngine::Library::OBJECT_EXT = ".o";
@@ -945,19 +1241,39 @@ CompilerEngine::Library::setCompilationResult(CompilationResult &compilation) {
     sourceName = this->outputDirPath + "/program.module-" +
                  std::to_string(objectsPath.size()) + ".mlir";
   }
-  auto objectPath = sourceName + OBJECT_EXT;
-  if (auto error = mlir::concretelang::emitObject(*module, objectPath)) {
+  // Programs with many circuits are code generated in parallel, in as many
+  // partitions as circuits at most. Which functions go in which partition is
+  // left to llvm::SplitModule.
+  size_t numPartitions = 1;
+  if (compilation.programInfo) {
+    numPartitions = std::min<size_t>(
+        compilation.programInfo->asReader().getCircuits().size(),
+        ::concretelang::parallel::getNumThreads(
+            "CONCRETE_COMPILER_NUM_THREADS"));
+    numPartitions = std::max<size_t>(numPartitions, 1);
+  }
+  std::vector<std::string> objectPaths;
+  if (numPartitions == 1) {
+    objectPaths.push_back(sourceName + OBJECT_EXT);
+  } else {
+    for (size_t i = 0; i < numPartitions; i++) {
+      objectPaths.push_back(sourceName + "-" + std::to_string(i) + OBJECT_EXT);
+    }
+  }
+  if (auto error = mlir::concretelang::emitObjects(*module, objectPaths)) {
     return std::move(error);
   }
 
-  addExtraObjectFilePath(objectPath);
+  for (auto &path : objectPaths) {
+    addExtraObjectFilePath(path);
+  }
   if (compilation.programInfo) {
     programInfo = *compilation.programInfo;
   }
   if (compilation.feedback.has_value()) {
     compilationFeedback = compilation.feedback.value();
   }
-  return objectPath;
+  return objectPaths.front();
 }
 
 bool stringEndsWith(std::string path, std::string requiredExt) {
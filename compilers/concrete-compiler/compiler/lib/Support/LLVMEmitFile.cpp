@@ -6,6 +6,7 @@
 #include <errno.h>
 
 #include "llvm/MC/SubtargetFeature.h"
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/MC/TargetRegistry.h>
@@ -25,9 +26,8 @@ namespace concretelang {
 using std::string;
 using std::vector;
 
-// Get target machine from current machine and setup LLVM module accordingly
-std::unique_ptr<llvm::TargetMachine>
-getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
+// Get target machine for the current machine
+std::unique_ptr<llvm::TargetMachine> createHostTargetMachine() {
   // Setup the machine properties from the current architecture.
   auto targetTriple = llvm::sys::getDefaultTargetTriple();
   std::string errorMessage;
@@ -52,8 +52,19 @@ getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
     llvm::errs() << "Unable to create target machine\n";
     return nullptr;
   }
+  machine->setOptLevel(llvm::CodeGenOpt::Level::Aggressive);
+  return machine;
+}
+
+// Get target machine from current machine and setup LLVM module accordingly
+std::unique_ptr<llvm::TargetMachine>
+getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
+  auto machine = createHostTargetMachine();
+  if (!machine) {
+    return nullptr;
+  }
   llvmModule->setDataLayout(machine->createDataLayout());
-  llvmModule->setTargetTriple(targetTriple);
+  llvmModule->setTargetTriple(machine->getTargetTriple().str());
   return machine;
 }
 
@@ -130,35 +141,54 @@ static void packFunctionArguments(llvm::Module *module) {
 }
 
 llvm::Error emitObject(llvm::Module &module, string objectPath) {
+  return emitObjects(module, {objectPath});
+}
+
+llvm::Error emitObjects(llvm::Module &module, vector<string> objectPaths) {
   auto targetMachine = getTargetMachineAndSetupModule(&module);
   if (!targetMachine) {
     return StreamStringError("No default target machine for object generation");
   }
 
-  string Error;
-  std::unique_ptr<llvm::ToolOutputFile> objectFile =
-      mlir::openOutputFile(objectPath, &Error);
-  if (!objectFile) {
-    return StreamStringError("Cannot create/open " + objectPath);
+  vector<std::unique_ptr<llvm::ToolOutputFile>> objectFiles;
+  vector<llvm::raw_pwrite_stream *> objectStreams;
+  for (auto &objectPath : objectPaths) {
+    string Error;
+    auto objectFile = mlir::openOutputFile(objectPath, &Error);
+    if (!objectFile) {
+      return StreamStringError("Cannot create/open " + objectPath);
+    }
+    objectStreams.push_back(&objectFile->os());
+    objectFiles.push_back(std::move(objectFile));
   }
 
   packFunctionArguments(&module);
 
-  // The legacy PassManager is mandatory for final code generation.
-  // https://llvm.org/docs/NewPassManager.html#status-of-the-new-and-legacy-pass-managers
-  llvm::legacy::PassManager pm;
   auto FileType = llvm::CGFT_ObjectFile;
-  targetMachine->setOptLevel(llvm::CodeGenOpt::Level::Aggressive);
-  if (targetMachine->addPassesToEmitFile(pm, objectFile->os(), nullptr,
-                                         FileType, false)) {
-    return StreamStringError("TheTargetMachine can't emit object file");
+  if (objectFiles.size() == 1) {
+    // The legacy PassManager is mandatory for final code generation.
+    // https://llvm.org/docs/NewPassManager.html#status-of-the-new-and-legacy-pass-managers
+    llvm::legacy::PassManager pm;
+    if (targetMachine->addPassesToEmitFile(pm, *objectStreams[0], nullptr,
+                                           FileType, false)) {
+      return StreamStringError("TheTargetMachine can't emit object file");
+    }
+    pm.run(module);
+  } else {
+    // Each partition is code generated on its own thread, in its own context,
+    // and the resulting objects are linked together in the library. Locals
+    // are preserved: SplitModule keeps each of them in the partition of its
+    // users instead of making it external, so the library exports the same
+    // symbols as a single object would.
+    llvm::splitCodeGen(module, objectStreams, {}, createHostTargetMachine,
+                       FileType, /*PreserveLocals=*/true);
   }
 
-  pm.run(module);
-
-  objectFile->os().flush();
-  objectFile->os().close();
-  objectFile->keep();
+  for (auto &objectFile : objectFiles) {
+    objectFile->os().flush();
+    objectFile->os().close();
+    objectFile->keep();
+  }
   return llvm::Error::success();
 }
 
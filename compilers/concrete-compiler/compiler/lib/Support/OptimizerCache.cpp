@@ -0,0 +1,442 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "concretelang/Support/BuildId.h"
+#include "concretelang/Support/OptimizerCache.h"
+
+namespace mlir {
+namespace concretelang {
+namespace optimizer {
+
+namespace {
+
+using concrete_optimizer::dag::BootstrapKey;
+using concrete_optimizer::dag::BrDecompositionParameters;
+using concrete_optimizer::dag::CircuitBoostrapKey;
+using concrete_optimizer::dag::ConversionKeySwitchKey;
+using concrete_optimizer::dag::InstructionKeys;
+using concrete_optimizer::dag::KeySwitchKey;
+using concrete_optimizer::dag::KsDecompositionParameters;
+using concrete_optimizer::dag::SecretLweKey;
+
+// The fields of the solutions, listed once for both the writer and the reader.
+
+template <typename Visitor>
+void visit(Visitor &v, BrDecompositionParameters &params) {
+  v("level", params.level);
+  v("log2_base", params.log2_base);
+}
+
+template <typename Visitor>
+void visit(Visitor &v, KsDecompositionParameters &params) {
+  v("level", params.level);
+  v("log2_base", params.log2_base);
+}
+
+template <typename Visitor> void visit(Visitor &v, SecretLweKey &key) {
+  v("identifier", key.identifier);
+  v("polynomial_size", key.polynomial_size);
+  v("glwe_dimension", key.glwe_dimension);
+  v("description", key.description);
+}
+
+template <typename Visitor> void visit(Visitor &v, BootstrapKey &key) {
+  v("identifier", key.identifier);
+  v("input_key", key.input_key);
+  v("output_key", key.output_key);
+  v("br_decomposition_parameter", key.br_decomposition_parameter);
+  v("description", key.description);
+}
+
+template <typename Visitor> void visit(Visitor &v, KeySwitchKey &key) {
+  v("identifier", key.identifier);
+  v("input_key", key.input_key);
+  v("output_key", key.output_key);
+  v("ks_decomposition_parameter", key.ks_decomposition_parameter);
+  v("description", key.description);
+}
+
+template <typename Visitor>
+void visit(Visitor &v, ConversionKeySwitchKey &key) {
+  v("identifier", key.identifier);
+  v("input_key", key.input_key);
+  v("output_key", key.output_key);
+  v("ks_decomposition_parameter", key.ks_decomposition_parameter);
+  v("fast_keyswitch", key.fast_keyswitch);
+  v("description", key.description);
+}
+
+template <typename Visitor> void visit(Visitor &v, CircuitBoostrapKey &key) {
+  v("identifier", key.identifier);
+  v("representation_key", key.representation_key);
+  v("br_decomposition_parameter", key.br_decomposition_parameter);
+  v("description", key.description);
+}
+
+template <typename Visitor>
+void visit(Visitor &v, PrivateFunctionalPackingBoostrapKey &key) {
+  v("identifier", key.identifier);
+  v("representation_key", key.representation_key);
+  v("br_decomposition_parameter", key.br_decomposition_parameter);
+  v("description", key.description);
+}
+
+template <typename Visitor> void visit(Visitor &v, CircuitKeys &keys) {
+  v("secret_keys", keys.secret_keys);
+  v("keyswitch_keys", keys.keyswitch_keys);
+  v("bootstrap_keys", keys.bootstrap_keys);
+  v("conversion_keyswitch_keys", keys.conversion_keyswitch_keys);
+  v("circuit_bootstrap_keys", keys.circuit_bootstrap_keys);
+  v("private_functional_packing_keys", keys.private_functional_packing_keys);
+}
+
+template <typename Visitor> void visit(Visitor &v, InstructionKeys &keys) {
+  v("input_key", keys.input_key);
+  v("tlu_keyswitch_key", keys.tlu_keyswitch_key);
+  v("tlu_bootstrap_key", keys.tlu_bootstrap_key);
+  v("tlu_circuit_bootstrap_key", keys.tlu_circuit_bootstrap_key);
+  v("tlu_private_functional_packing_key",
+    keys.tlu_private_functional_packing_key);
+  v("output_key", keys.output_key);
+  v("extra_conversion_keys", keys.extra_conversion_keys);
+}
+
+template <typename Visitor> void visit(Visitor &v, DagSolution &solution) {
+  v("input_lwe_dimension", solution.input_lwe_dimension);
+  v("internal_ks_output_lwe_dimension",
+    solution.internal_ks_output_lwe_dimension);
+  v("ks_decomposition_level_count", solution.ks_decomposition_level_count);
+  v("ks_decomposition_base_log", solution.ks_decomposition_base_log);
+  v("glwe_polynomial_size", solution.glwe_polynomial_size);
+  v("glwe_dimension", solution.glwe_dimension);
+  v("br_decomposition_level_count", solution.br_decomposition_level_count);
+  v("br_decomposition_base_log", solution.br_decomposition_base_log);
+  v("complexity", solution.complexity);
+  v("noise_max", solution.noise_max);
+  v("p_error", solution.p_error);
+  v("global_p_error", solution.global_p_error);
+  v("use_wop_pbs", solution.use_wop_pbs);
+  v("cb_decomposition_level_count", solution.cb_decomposition_level_count);
+  v("cb_decomposition_base_log", solution.cb_decomposition_base_log);
+  v("pp_decomposition_level_count", solution.pp_decomposition_level_count);
+  v("pp_decomposition_base_log", solution.pp_decomposition_base_log);
+  v("crt_decomposition", solution.crt_decomposition);
+}
+
+template <typename Visitor> void visit(Visitor &v, CircuitSolution &solution) {
+  v("circuit_keys", solution.circuit_keys);
+  v("instructions_keys", solution.instructions_keys);
+  v("crt_decomposition", solution.crt_decomposition);
+  v("complexity", solution.complexity);
+  v("p_error", solution.p_error);
+  v("global_p_error", solution.global_p_error);
+  v("is_feasible", solution.is_feasible);
+  v("error_msg", solution.error_msg);
+}
+
+/// Writes the visited fields to a JSON object. Integers are stored as their
+/// signed bit pattern since JSON numbers do not cover the whole `uint64_t`
+/// range, and the optimizer uses `u64::MAX` for absent keys.
+class JsonWriter {
+public:
+  void operator()(llvm::StringRef name, uint64_t &value) {
+    object[name] = (int64_t)value;
+  }
+  void operator()(llvm::StringRef name, double &value) {
+    finite &= std::isfinite(value);
+    object[name] = value;
+  }
+  void operator()(llvm::StringRef name, bool &value) { object[name] = value; }
+  void operator()(llvm::StringRef name, rust::String &value) {
+    object[name] = std::string(value);
+  }
+  void operator()(llvm::StringRef name, rust::Vec<uint64_t> &values) {
+    llvm::json::Array array;
+    for (auto value : values)
+      array.push_back((int64_t)value);
+    object[name] = std::move(array);
+  }
+  template <typename T> void operator()(llvm::StringRef name, T &value) {
+    object[name] = write(value);
+  }
+  template <typename T>
+  void operator()(llvm::StringRef name, rust::Vec<T> &values) {
+    llvm::json::Array array;
+    for (auto &value : values)
+      array.push_back(write(value));
+    object[name] = std::move(array);
+  }
+
+  template <typename T> llvm::json::Value write(T &value) {
+    JsonWriter writer;
+    visit(writer, value);
+    finite &= writer.finite;
+    return std::move(writer.object);
+  }
+
+  llvm::json::Object object;
+  /// Whether all the doubles were finite, the others having no JSON
+  /// representation.
+  bool finite = true;
+};
+
+/// Reads the visited fields from a JSON object, `ok` being reset on the first
+/// missing or mistyped field.
+class JsonReader {
+public:
+  JsonReader(const llvm::json::Object &object) : object(object) {}
+
+  void operator()(llvm::StringRef name, uint64_t &value) {
+    if (auto i = object.getInteger(name))
+      value = (uint64_t)*i;
+    else
+      ok = false;
+  }
+  void operator()(llvm::StringRef name, double &value) {
+    if (auto d = object.getNumber(name))
+      value = *d;
+    else
+      ok = false;
+  }
+  void operator()(llvm::StringRef name, bool &value) {
+    if (auto b = object.getBoolean(name))
+      value = *b;
+    else
+      ok = false;
+  }
+  void operator()(llvm::StringRef name, rust::String &value) {
+    if (auto s = object.getString(name))
+      value = rust::String(s->str());
+    else
+      ok = false;
+  }
+  void operator()(llvm::StringRef name, rust::Vec<uint64_t> &values) {
+    auto array = object.getArray(name);
+    if (array == nullptr) {
+      ok = false;
+      return;
+    }
+    for (auto &element : *array) {
+      auto i = element.getAsInteger();
+      if (!i) {
+        ok = false;
+        return;
+      }
+      values.push_back((uint64_t)*i);
+    }
+  }
+  template <typename T> void operator()(llvm::StringRef name, T &value) {
+    auto field = object.getObject(name);
+    ok = ok && field != nullptr && read(*field, value);
+  }
+  template <typename T>
+  void operator()(llvm::StringRef name, rust::Vec<T> &values) {
+    auto array = object.getArray(name);
+    if (array == nullptr) {
+      ok = false;
+      return;
+    }
+    for (auto &element : *array) {
+      auto field = element.getAsObject();
+      T value{};
+      if (field == nullptr || !read(*field, value)) {
+        ok = false;
+        return;
+      }
+      values.push_back(std::move(value));
+    }
+  }
+
+  template <typename T>
+  static bool read(const llvm::json::Object &object, T &value) {
+    JsonReader reader(object);
+    visit(reader, value);
+    return reader.ok;
+  }
+
+  const llvm::json::Object &object;
+  bool ok = true;
+};
+
+template <typename Solution>
+std::optional<Solution> lookupSolution(llvm::StringRef path,
+                                       llvm::StringRef key) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return std::nullopt;
+  auto json = llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    llvm::consumeError(json.takeError());
+    return std::nullopt;
+  }
+  auto entry = json->getAsObject();
+  if (entry == nullptr ||
+      entry->getInteger("version") != SolutionCache::VERSION)
+    return std::nullopt;
+  auto entryKey = entry->getString("key");
+  auto solution = entry->getObject("solution");
+  if (!entryKey || *entryKey != key || solution == nullptr)
+    return std::nullopt;
+  Solution result{};
+  if (!JsonReader::read(*solution, result))
+    return std::nullopt;
+  return result;
+}
+
+template <typename Solution>
+void storeSolution(llvm::StringRef directory, llvm::StringRef path,
+                   llvm::StringRef key, const Solution &solution) {
+  // The visitors take mutable references, so serialize a copy
+  Solution copy = solution;
+  JsonWriter writer;
+  auto serialized = writer.write(copy);
+  if (!writer.finite)
+    return;
+  llvm::json::Object entry;
+  entry["version"] = SolutionCache::VERSION;
+  entry["key"] = key.str();
+  entry["solution"] = std::move(serialized);
+
+  // Failing to store an entry only costs a later optimization, so errors are
+  // silently ignored.
+  if (llvm::sys::fs::create_directories(directory))
+    return;
+  int fd;
+  llvm::SmallString<256> tmpPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmpPath))
+    return;
+  bool failed;
+  {
+    llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+    out << llvm::json::Value(std::move(entry));
+    out.close();
+    failed = out.has_error();
+    out.clear_error();
+  }
+  if (failed || llvm::sys::fs::rename(tmpPath, path))
+    llvm::sys::fs::remove(tmpPath);
+}
+
+} // namespace
+
+std::optional<SolutionCache> SolutionCache::fromEnvironment() {
+  char *env = getenv("CONCRETE_OPTIMIZER_CACHE_DIR");
+  if (env == nullptr || *env == '\0')
+    return std::nullopt;
+  return SolutionCache(env);
+}
+
+std::optional<std::string>
+SolutionCache::getKey(llvm::StringRef kind, const concrete_optimizer::Dag &dag,
+                      const concrete_optimizer::Options &options) {
+  // Optimizations restricted to a keyset are not cached
+  if (options.keyset_restriction)
+    return std::nullopt;
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << "kind: " << kind << "\n";
+  os << "compiler: " << getCompilerBuildId() << "\n";
+  os << "security_level: " << options.security_level << "\n";
+  os << "maximum_acceptable_error_probability: "
+     << llvm::format("%a", options.maximum_acceptable_error_probability)
+     << "\n";
+  os << "key_sharing: " << options.key_sharing << "\n";
+  os << "multi_param_strategy: " << (int)options.multi_param_strategy << "\n";
+  os << "default_log_norm2_woppbs: "
+     << llvm::format("%a", options.default_log_norm2_woppbs) << "\n";
+  os << "use_gpu_constraints: " << options.use_gpu_constraints << "\n";
+  os << "encoding: " << (int)options.encoding << "\n";
+  os << "ciphertext_modulus_log: " << options.ciphertext_modulus_log << "\n";
+  os << "fft_precision: " << options.fft_precision << "\n";
+  if (auto restriction = options.range_restriction) {
+    auto writeRange = [&](llvm::StringRef name,
+                          const rust::Vec<uint64_t> &values) {
+      os << name << ":";
+      for (auto value : values)
+        os << " " << value;
+      os << "\n";
+    };
+    writeRange("glwe_log_polynomial_sizes",
+               restriction->glwe_log_polynomial_sizes);
+    writeRange("glwe_dimensions", restriction->glwe_dimensions);
+    writeRange("internal_lwe_dimensions", restriction->internal_lwe_dimensions);
+    writeRange("pbs_level_count", restriction->pbs_level_count);
+    writeRange("pbs_base_log", restriction->pbs_base_log);
+    writeRange("ks_level_count", restriction->ks_level_count);
+    writeRange("ks_base_log", restriction->ks_base_log);
+  }
+  os << "dag:\n" << std::string(dag.fingerprint());
+  return os.str();
+}
+
+std::string SolutionCache::getEntryPath(llvm::StringRef key) {
+  llvm::SmallString<256> path(directory);
+  llvm::sys::path::append(
+      path, std::to_string(std::hash<std::string>()(key.str())) + ".json");
+  return path.str().str();
+}
+
+std::optional<DagSolution>
+SolutionCache::lookupDagSolution(llvm::StringRef key) {
+  return lookupSolution<DagSolution>(getEntryPath(key), key);
+}
+
+std::optional<CircuitSolution>
+SolutionCache::lookupCircuitSolution(llvm::StringRef key) {
+  return lookupSolution<CircuitSolution>(getEntryPath(key), key);
+}
+
+void SolutionCache::store(llvm::StringRef key, const DagSolution &solution) {
+  storeSolution(directory, getEntryPath(key), key, solution);
+}
+
+void SolutionCache::store(llvm::StringRef key,
+                          const CircuitSolution &solution) {
+  storeSolution(directory, getEntryPath(key), key, solution);
+}
+
+DagSolution
+SolutionCache::getOrOptimizeMono(const concrete_optimizer::Dag &dag,
+                                 const concrete_optimizer::Options &options,
+                                 std::function<DagSolution()> optimize) {
+  auto key = getKey("dag-mono", dag, options);
+  if (key)
+    if (auto solution = lookupDagSolution(*key))
+      return std::move(*solution);
+  auto solution = optimize();
+  if (key)
+    store(*key, solution);
+  return solution;
+}
+
+CircuitSolution
+SolutionCache::getOrOptimizeMulti(const concrete_optimizer::Dag &dag,
+                                  const concrete_optimizer::Options &options,
+                                  std::function<CircuitSolution()> optimize) {
+  auto key = getKey("dag-multi", dag, options);
+  if (key)
+    if (auto solution = lookupCircuitSolution(*key))
+      return std::move(*solution);
+  auto solution = optimize();
+  if (key)
+    store(*key, solution);
+  return solution;
+}
+
+} // namespace optimizer
+} // namespace concretelang
+} // namespace mlir
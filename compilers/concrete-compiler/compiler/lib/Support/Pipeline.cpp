@@ -43,6 +43,7 @@
 #include "concretelang/Dialect/FHE/Transforms/Boolean/Boolean.h"
 #include "concretelang/Dialect/FHE/Transforms/DynamicTLU/DynamicTLU.h"
 #include "concretelang/Dialect/FHE/Transforms/EncryptedMulToDoubleTLU/EncryptedMulToDoubleTLU.h"
+#include "concretelang/Dialect/FHE/Transforms/ManyLookupTables/ManyLookupTables.h"
 #include "concretelang/Dialect/FHE/Transforms/Max/Max.h"
 #include "concretelang/Dialect/FHE/Transforms/Optimizer/Optimizer.h"
 #include "concretelang/Dialect/FHELinalg/Transforms/Tiling.h"
@@ -191,12 +192,25 @@ mlir::LogicalResult materializeOptimizerPartitionFrontiers(
 }
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass) {
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t dataflowTaskDuration) {
   mlir::PassManager pm(&context);
   pipelinePrinting("AutoPar", pm, context);
 
+  if (dataflowTaskDuration != 0) {
+    addPotentiallyNestedPass(
+        pm,
+        mlir::concretelang::createMarkDataflowTaskSplitsPass(
+            dataflowTaskDuration),
+        enablePass);
+    addPotentiallyNestedPass(pm, mlir::concretelang::createLinalgTilingPass(),
+                             enablePass);
+  }
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createBuildDataflowTaskGraphPass(), enablePass);
+      pm,
+      mlir::concretelang::createBuildDataflowTaskGraphPass(
+          dataflowTaskDuration),
+      enablePass);
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createLowerDataflowTasksPass(), enablePass);
   addPotentiallyNestedPass(pm, mlir::concretelang::createHoistAwaitFuturePass(),
@@ -247,11 +261,13 @@ transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerFHELinalgToLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                       std::function<bool(mlir::Pass *)> enablePass) {
+                       std::function<bool(mlir::Pass *)> enablePass,
+                       bool gemm) {
   mlir::PassManager pm(&context);
   pipelinePrinting("FHELinalgToLinalg", pm, context);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertFHETensorOpsToLinalg(), enablePass);
+      pm, mlir::concretelang::createConvertFHETensorOpsToLinalg(gemm),
+      enablePass);
   addPotentiallyNestedPass(pm, mlir::createLinalgGeneralizationPass(),
                            enablePass);
   return pm.run(module.getOperation());
@@ -299,6 +315,19 @@ transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+transformFHEManyLookupTables(mlir::MLIRContext &context,
+                             mlir::ModuleOp &module,
+                             std::function<bool(mlir::Pass *)> enablePass,
+                             unsigned int maxLutWidth) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("FHEManyLookupTables", pm, context);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createFHEManyLookupTablesPass(maxLutWidth),
+      enablePass);
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                std::optional<V0FHEContext> &fheContext,
@@ -597,12 +626,13 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
                                 std::function<bool(mlir::Pass *)> enablePass,
-                                bool gpu) {
+                                bool gpu, bool async) {
   mlir::PassManager pm(&context);
   pipelinePrinting("Lowering to CAPI", pm, context);
 
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertConcreteToCAPIPass(gpu), enablePass);
+      pm, mlir::concretelang::createConvertConcreteToCAPIPass(gpu, async),
+      enablePass);
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createConvertTracingToCAPIPass(), enablePass);
 
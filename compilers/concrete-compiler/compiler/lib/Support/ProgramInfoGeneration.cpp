@@ -25,6 +25,7 @@
 #include "concretelang/Support/Encodings.h"
 #include "concretelang/Support/Error.h"
 #include "concretelang/Support/TFHECircuitKeys.h"
+#include "concretelang/Support/V0Parameters.h"
 #include "concretelang/Support/Variants.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
@@ -35,6 +36,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/abi-breaking.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 
 using concretelang::protocol::Message;
 
@@ -179,10 +181,45 @@ generateGate(mlir::Type inputType,
   return output;
 }
 
+/// Returns the grouping factors of the bootstrap keys of `circuitKeys`, 0 for
+/// the keys that stay classic bootstrap keys.
+///
+/// A key is replaced by a multi-bit bootstrap key when a multi-bit bootstrap is
+/// cheaper without being noisier, so that the error probability guaranteed by
+/// the optimizer still holds. The keys of the wop-pbs, whose circuit bootstrap
+/// has no multi-bit variant, stay classic.
+llvm::SmallVector<uint32_t>
+getMultiBitGroupingFactors(mlir::ModuleOp module,
+                           const TFHE::TFHECircuitKeys &circuitKeys,
+                           const optimizer::Config &optimizerConfig,
+                           unsigned int maxGroupingFactor) {
+  llvm::SmallVector<uint32_t> groupingFactors(circuitKeys.bootstrapKeys.size(),
+                                              0);
+  if (maxGroupingFactor < 2)
+    return groupingFactors;
+
+  llvm::SmallVector<TFHE::GLWEBootstrapKeyAttr> wopPbsKeys;
+  module->walk(
+      [&](TFHE::WopPBSGLWEOp op) { wopPbsKeys.push_back(op.getBsk()); });
+
+  auto options = options_from_config(optimizerConfig);
+  for (auto [i, bsk] : llvm::enumerate(circuitKeys.bootstrapKeys)) {
+    if (llvm::is_contained(wopPbsKeys, bsk))
+      continue;
+    groupingFactors[i] =
+        concrete_optimizer::utils::get_multi_bit_grouping_factor(
+            options, llvm::Log2_64(bsk.getPolySize()), bsk.getGlweDim(),
+            bsk.getInputKey().getNormalized().value().dimension,
+            bsk.getLevels(), bsk.getBaseLog(), maxGroupingFactor);
+  }
+  return groupingFactors;
+}
+
 Message<concreteprotocol::KeysetInfo>
 extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
                   ::concretelang::security::SecurityCurve curve,
-                  bool compressEvaluationKeys) {
+                  bool compressEvaluationKeys,
+                  llvm::ArrayRef<uint32_t> groupingFactors) {
 
   auto output = Message<concreteprotocol::KeysetInfo>();
 
@@ -263,6 +300,7 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
     paramsBuilder.setIntegerPrecision(64);
     paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
     paramsBuilder.initModulus().initMod().initNative();
+    paramsBuilder.setGroupingFactor(groupingFactors[i]);
     bootstrapKeysBuilder.setWithCaveats(i, infoMessage.asReader());
   }
 
@@ -389,7 +427,9 @@ llvm::Expected<Message<concreteprotocol::ProgramInfo>>
 createProgramInfoFromTfheDialect(
     mlir::ModuleOp module, int bitsOfSecurity,
     const Message<concreteprotocol::ProgramEncodingInfo> &encodings,
-    bool compressEvaluationKeys, bool compressInputCiphertexts) {
+    bool compressEvaluationKeys, bool compressInputCiphertexts,
+    const optimizer::Config &optimizerConfig,
+    unsigned int maxMultiBitGroupingFactor) {
 
   // Check that security curves exist
   const auto curve =
@@ -409,9 +449,14 @@ createProgramInfoFromTfheDialect(
   // Extract the output Program Info.
   Message<concreteprotocol::ProgramInfo> output = *maybeProgramInfo;
 
-  // We extract the keys of the circuit
-  auto keysetInfo = extractKeysetInfo(TFHE::extractCircuitKeys(module), *curve,
-                                      compressEvaluationKeys);
+  // We extract the keys of the circuit, multi-bit bootstrap keys having no
+  // compressed form
+  auto circuitKeys = TFHE::extractCircuitKeys(module);
+  auto groupingFactors = getMultiBitGroupingFactors(
+      module, circuitKeys, optimizerConfig,
+      compressEvaluationKeys ? 0 : maxMultiBitGroupingFactor);
+  auto keysetInfo = extractKeysetInfo(circuitKeys, *curve,
+                                      compressEvaluationKeys, groupingFactors);
   output.asBuilder().setKeyset(keysetInfo.asReader());
 
   return output;
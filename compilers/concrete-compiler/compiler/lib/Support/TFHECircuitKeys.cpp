@@ -119,6 +119,12 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
     secretKeys.insert(op.getKeyAttr().getOutputKey());
   });
 
+  moduleOp->walk([&](TFHE::ManyBootstrapGLWEOp op) {
+    bootstrapKeys.insert(op.getKeyAttr());
+    secretKeys.insert(op.getKeyAttr().getInputKey());
+    secretKeys.insert(op.getKeyAttr().getOutputKey());
+  });
+
   // Gathering circuit packing keyswitch keys
   SmallSet<TFHE::GLWEPackingKeyswitchKeyAttr> packingKeyswitchKeys;
   moduleOp->walk([&](TFHE::WopPBSGLWEOp op) {
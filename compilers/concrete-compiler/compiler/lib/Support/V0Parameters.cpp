@@ -18,6 +18,7 @@
 
 #include "concrete-optimizer.hpp"
 #include "concretelang/Support/Error.h"
+#include "concretelang/Support/OptimizerCache.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "concretelang/Support/logging.h"
 
@@ -120,8 +121,12 @@ Solution getSolutionWithGlobalPError(optimizer::Config config,
 
 optimizer::DagSolution getDagMonoSolution(optimizer::Dag &dag,
                                           optimizer::Config config) {
+  auto cache = optimizer::SolutionCache::fromEnvironment();
   auto optimize =
       [&](concrete_optimizer::Options options) -> optimizer::DagSolution {
+    if (cache)
+      return cache->getOrOptimizeMono(
+          *dag, options, [&]() { return dag->optimize(options); });
     return dag->optimize(options);
   };
   if (!std::isnan(config.global_p_error)) {
@@ -133,9 +138,12 @@ optimizer::DagSolution getDagMonoSolution(optimizer::Dag &dag,
 
 optimizer::CircuitSolution getDagMultiSolution(optimizer::Dag &dag,
                                                optimizer::Config config) {
-
+  auto cache = optimizer::SolutionCache::fromEnvironment();
   auto optimize =
       [&](concrete_optimizer::Options options) -> optimizer::CircuitSolution {
+    if (cache)
+      return cache->getOrOptimizeMulti(
+          *dag, options, [&]() { return dag->optimize_multi(options); });
     return dag->optimize_multi(options);
   };
   if (!std::isnan(config.global_p_error)) {
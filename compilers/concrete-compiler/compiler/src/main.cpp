@@ -205,6 +205,18 @@ llvm::cl::opt<bool> batchTFHEOps(
                    "operations out of loop nests as batched operations"),
     llvm::cl::init(false));
 
+llvm::cl::opt<bool> asyncTFHEOps(
+    "async-tfhe-ops",
+    llvm::cl::desc("Offload CPU keyswitches and bootstraps to the runtime "
+                   "worker pool and await their results at their first use"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> gemmTFHEOps(
+    "gemm-tfhe-ops",
+    llvm::cl::desc("Lower encrypted by clear matrix products, dot products "
+                   "and convolutions to a dense matrix product kernel"),
+    llvm::cl::init(false));
+
 llvm::cl::opt<int64_t>
     maxBatchSize("max-batch-size",
                  llvm::cl::desc("Maximum number of operands materialized in a "
@@ -229,6 +241,13 @@ llvm::cl::opt<bool> dataflowParallelize(
     llvm::cl::desc("Generate the program as a dataflow graph"),
     llvm::cl::init(false));
 
+llvm::cl::opt<uint64_t> dataflowTaskDuration(
+    "dataflow-task-duration",
+    llvm::cl::desc("Target estimated duration of dataflow tasks in "
+                   "microseconds, cheaper operations being merged and longer "
+                   "ones split (0 creates one task per candidate operation)"),
+    llvm::cl::init(mlir::concretelang::DEFAULT_DATAFLOW_TASK_DURATION));
+
 llvm::cl::opt<bool>
     chunkIntegers("chunk-integers",
                   llvm::cl::desc("Whether to decompose integer into chunks or "
@@ -247,6 +266,26 @@ llvm::cl::opt<unsigned int> chunkWidth(
         "Chunk width while decomposing big integers into chunks, default is 2"),
     llvm::cl::init<unsigned int>(2));
 
+llvm::cl::opt<bool> manyLookupTables(
+    "many-lookup-tables",
+    llvm::cl::desc("Evaluate constant lookup tables applied to the same "
+                   "encrypted integer with a single many-lut bootstrap"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<unsigned int> manyLookupTablesMaxWidth(
+    "many-lookup-tables-max-width",
+    llvm::cl::desc("Maximum width in bits of a table packing several lookup "
+                   "tables for --many-lookup-tables"),
+    llvm::cl::init<unsigned int>(
+        mlir::concretelang::DEFAULT_MANY_LOOKUP_TABLES_MAX_WIDTH));
+
+llvm::cl::opt<unsigned int> maxMultiBitGroupingFactor(
+    "max-multi-bit-grouping-factor",
+    llvm::cl::desc("Use multi-bit bootstrap keys grouping up to this number of "
+                   "secret key bits when they are cheaper without being "
+                   "noisier than the classic ones, default is 0 (disabled)"),
+    llvm::cl::init<unsigned int>(0));
+
 llvm::cl::opt<double> pbsErrorProbability(
     "pbs-error-probability",
     llvm::cl::desc("Change the default probability of error for all pbs"),
@@ -412,8 +451,11 @@ cmdlineCompilationOptions() {
   options.autoParallelize = cmdline::autoParallelize;
   options.loopParallelize = cmdline::loopParallelize;
   options.dataflowParallelize = cmdline::dataflowParallelize;
+  options.dataflowTaskDuration = cmdline::dataflowTaskDuration;
   options.batchTFHEOps = cmdline::batchTFHEOps;
   options.maxBatchSize = cmdline::maxBatchSize;
+  options.asyncTFHEOps = cmdline::asyncTFHEOps;
+  options.gemmTFHEOps = cmdline::gemmTFHEOps;
   options.emitSDFGOps = cmdline::emitSDFGOps;
   options.unrollLoopsWithSDFGConvertibleOps =
       cmdline::unrollLoopsWithSDFGConvertibleOps;
@@ -424,6 +466,9 @@ cmdlineCompilationOptions() {
   options.chunkIntegers = cmdline::chunkIntegers;
   options.chunkSize = cmdline::chunkSize;
   options.chunkWidth = cmdline::chunkWidth;
+  options.manyLookupTables = cmdline::manyLookupTables;
+  options.manyLookupTablesMaxWidth = cmdline::manyLookupTablesMaxWidth;
+  options.maxMultiBitGroupingFactor = cmdline::maxMultiBitGroupingFactor;
   options.skipProgramInfo = cmdline::skipProgramInfo;
 
   if (!cmdline::v0Constraint.empty()) {
@@ -0,0 +1,22 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --async-tfhe-ops --skip-program-info %s 2>&1| FileCheck %s
+
+// Each keyswitch is awaited right before the bootstrap consuming it, while
+// both bootstraps are only awaited before the addition of their results.
+//CHECK: llvm.call @memref_keyswitch_async_lwe_u64
+//CHECK: llvm.call @memref_await_future
+//CHECK: llvm.call @memref_bootstrap_async_lwe_u64
+//CHECK: llvm.call @memref_keyswitch_async_lwe_u64
+//CHECK: llvm.call @memref_await_future
+//CHECK: llvm.call @memref_bootstrap_async_lwe_u64
+//CHECK: llvm.call @memref_await_future
+//CHECK: llvm.call @memref_await_future
+//CHECK: llvm.call @memref_add_lwe_ciphertexts_u64
+func.func @main(%arg0: tensor<1025xi64>, %arg1: tensor<1025xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %2 = "Concrete.keyswitch_lwe_tensor"(%arg1) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %3 = "Concrete.bootstrap_lwe_tensor"(%2, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %4 = "Concrete.add_lwe_tensor"(%1, %3) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  return %4 : tensor<1025xi64>
+}
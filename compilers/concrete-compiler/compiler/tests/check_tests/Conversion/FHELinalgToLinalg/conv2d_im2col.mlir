@@ -0,0 +1,37 @@
+// RUN: concretecompiler --action=dump-fhe-linalg-generic --gemm-tfhe-ops --passes fhe-tensor-ops-to-linalg %s 2>&1 | FileCheck %s
+
+// CHECK-DAG:  #[[patches:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d3, d1 + d4, d2 + d5)>
+// CHECK-DAG:  #[[id6:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d2, d3, d4, d5)>
+// CHECK-DAG:  #[[weight:.*]] = affine_map<(d0, d1, d2, d3) -> (d3, d0, d1, d2)>
+// CHECK-DAG:  #[[id4:.*]] = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+// CHECK-DAG:  #[[product:.*]] = affine_map<(d0, d1, d2, d3) -> (d0, d2, d3, d1)>
+// CHECK-DAG:  #[[bias:.*]] = affine_map<(d0, d1, d2, d3) -> (d1)>
+
+// CHECK:      func.func @conv2d(%[[INPUT:.*]]: tensor<1x2x4x4x!FHE.eint<6>>, %[[WEIGHT:.*]]: tensor<3x2x2x2xi7>, %[[BIAS:.*]]: tensor<3xi7>) -> tensor<1x3x3x3x!FHE.eint<6>> {
+
+// The 3x3 patches of 2x2x2 elements of the padded input are gathered in a 9x8
+// matrix
+// CHECK:        %[[PADDED:.*]] = tensor.pad %[[INPUT]]
+// CHECK:        %[[P0:.*]] = tensor.empty() : tensor<1x3x3x2x2x2x!FHE.eint<6>>
+// CHECK-NEXT:   %[[P1:.*]] = linalg.generic {indexing_maps = [#[[patches]], #[[id6]]], iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "parallel"]} ins(%[[PADDED]] : tensor<1x2x4x4x!FHE.eint<6>>) outs(%[[P0]] : tensor<1x3x3x2x2x2x!FHE.eint<6>>)
+// CHECK:        %[[LHS:.*]] = tensor.collapse_shape %[[P1]] {{\[\[}}0, 1, 2], [3, 4, 5]] : tensor<1x3x3x2x2x2x!FHE.eint<6>> into tensor<9x8x!FHE.eint<6>>
+
+// The weight is reshaped to a 8x3 matrix
+// CHECK:        %[[W0:.*]] = tensor.empty() : tensor<2x2x2x3xi7>
+// CHECK-NEXT:   %[[W1:.*]] = linalg.generic {indexing_maps = [#[[weight]], #[[id4]]], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%[[WEIGHT]] : tensor<3x2x2x2xi7>) outs(%[[W0]] : tensor<2x2x2x3xi7>)
+// CHECK:        %[[RHS:.*]] = tensor.collapse_shape %[[W1]] {{\[\[}}0, 1, 2], [3]] : tensor<2x2x2x3xi7> into tensor<8x3xi7>
+
+// The product is kept as a matrix product, then permuted back and biased
+// CHECK-NEXT:   %[[M:.*]] = "FHELinalg.matmul_eint_int"(%[[LHS]], %[[RHS]]) : (tensor<9x8x!FHE.eint<6>>, tensor<8x3xi7>) -> tensor<9x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[E:.*]] = tensor.expand_shape %[[M]] {{\[\[}}0, 1, 2], [3]] : tensor<9x3x!FHE.eint<6>> into tensor<1x3x3x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[R0:.*]] = tensor.empty() : tensor<1x3x3x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[R1:.*]] = linalg.generic {indexing_maps = [#[[product]], #[[bias]], #[[id4]]], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%[[E]], %[[BIAS]] : tensor<1x3x3x3x!FHE.eint<6>>, tensor<3xi7>) outs(%[[R0]] : tensor<1x3x3x3x!FHE.eint<6>>)
+// CHECK-NEXT:   ^bb0(%[[A0:.*]]: !FHE.eint<6>, %[[A1:.*]]: i7, %[[A2:.*]]: !FHE.eint<6>):
+// CHECK-NEXT:     %[[ADD:.*]] = "FHE.add_eint_int"(%[[A0]], %[[A1]]) : (!FHE.eint<6>, i7) -> !FHE.eint<6>
+// CHECK-NEXT:     linalg.yield %[[ADD]] : !FHE.eint<6>
+// CHECK-NEXT:   } -> tensor<1x3x3x3x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[R1]] : tensor<1x3x3x3x!FHE.eint<6>>
+func.func @conv2d(%input: tensor<1x2x4x4x!FHE.eint<6>>, %weight: tensor<3x2x2x2xi7>, %bias: tensor<3xi7>) -> tensor<1x3x3x3x!FHE.eint<6>> {
+  %1 = "FHELinalg.conv2d"(%input, %weight, %bias){strides = dense<[1,1]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>, group = 1 : i64}: (tensor<1x2x4x4x!FHE.eint<6>>, tensor<3x2x2x2xi7>, tensor<3xi7>) -> tensor<1x3x3x3x!FHE.eint<6>>
+  return %1 : tensor<1x3x3x3x!FHE.eint<6>>
+}
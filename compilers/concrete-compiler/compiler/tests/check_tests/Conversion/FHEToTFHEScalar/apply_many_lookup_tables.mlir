@@ -0,0 +1,13 @@
+// RUN: concretecompiler %s --optimize-tfhe=false --optimizer-strategy=dag-mono --action=dump-tfhe 2>&1| FileCheck %s
+
+// CHECK: func.func @apply_many_lookup_tables(%arg0: !TFHE.glwe<sk?>, %arg1: tensor<8xi64>) -> (!TFHE.glwe<sk?>, !TFHE.glwe<sk?>) {
+// CHECK-NEXT: %[[V0:.*]] = "TFHE.encode_expand_lut_for_bootstrap"(%arg1) {isSigned = false, outputBits = 3 : i32, polySize = {{[0-9]+}} : i32} : (tensor<8xi64>) -> tensor<{{[0-9]+}}xi64>
+// CHECK-NEXT: %[[V1:.*]] = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk?, sk?, -1, -1>} : (!TFHE.glwe<sk?>) -> !TFHE.glwe<sk?>
+// CHECK-NEXT: %[[V2:.*]] = "TFHE.many_bootstrap_glwe"(%[[V1]], %[[V0]]) {key = #TFHE.bsk<sk?, sk?, -1, -1, -1, -1>, lutWidth = 3 : i32} : (!TFHE.glwe<sk?>, tensor<{{[0-9]+}}xi64>) -> tensor<2x!TFHE.glwe<sk?>>
+// CHECK: %[[V3:.*]] = tensor.extract %[[V2]][%{{.*}}] : tensor<2x!TFHE.glwe<sk?>>
+// CHECK: %[[V4:.*]] = tensor.extract %[[V2]][%{{.*}}] : tensor<2x!TFHE.glwe<sk?>>
+// CHECK-NEXT: return %[[V3]], %[[V4]] : !TFHE.glwe<sk?>, !TFHE.glwe<sk?>
+func.func @apply_many_lookup_tables(%arg0: !FHE.eint<2>, %arg1: tensor<8xi64>) -> (!FHE.eint<3>, !FHE.eint<3>) {
+  %0:2 = "FHE.apply_many_lookup_tables"(%arg0, %arg1): (!FHE.eint<2>, tensor<8xi64>) -> (!FHE.eint<3>, !FHE.eint<3>)
+  return %0#0, %0#1: !FHE.eint<3>, !FHE.eint<3>
+}
@@ -0,0 +1,28 @@
+// RUN: concretecompiler %s --split-input-file --passes=fhe-to-tfhe-scalar --v0-parameter=2,10,693,4,9,7,2 --action=dump-tfhe 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @matmul_eint_int(%arg0: tensor<3x4x!TFHE.glwe<sk?>>, %arg1: tensor<4x2xi8>) -> tensor<3x2x!TFHE.glwe<sk?>>
+func.func @matmul_eint_int(%arg0: tensor<3x4x!FHE.eint<7>>, %arg1: tensor<4x2xi8>) -> tensor<3x2x!FHE.eint<7>> {
+  // CHECK:      %[[V0:.*]] = tensor.empty() : tensor<4x2xi64>
+  // CHECK-NEXT: %[[V1:.*]] = linalg.generic {{.*}} ins(%arg1 : tensor<4x2xi8>) outs(%[[V0]] : tensor<4x2xi64>)
+  // CHECK:        arith.extsi %{{.*}} : i8 to i64
+  // CHECK:      %[[V2:.*]] = "TFHE.matmul_glwe_int"(%arg0, %[[V1]]) : (tensor<3x4x!TFHE.glwe<sk?>>, tensor<4x2xi64>) -> tensor<3x2x!TFHE.glwe<sk?>>
+  // CHECK-NEXT: return %[[V2]] : tensor<3x2x!TFHE.glwe<sk?>>
+
+  %0 = "FHELinalg.matmul_eint_int"(%arg0, %arg1): (tensor<3x4x!FHE.eint<7>>, tensor<4x2xi8>) -> tensor<3x2x!FHE.eint<7>>
+  return %0: tensor<3x2x!FHE.eint<7>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @dot_eint_int(%arg0: tensor<4x!TFHE.glwe<sk?>>, %arg1: tensor<4xi8>) -> !TFHE.glwe<sk?>
+func.func @dot_eint_int(%arg0: tensor<4x!FHE.eint<7>>, %arg1: tensor<4xi8>) -> !FHE.eint<7> {
+  // CHECK:      %[[V0:.*]] = tensor.expand_shape %arg0 {{\[\[}}0, 1]] : tensor<4x!TFHE.glwe<sk?>> into tensor<1x4x!TFHE.glwe<sk?>>
+  // CHECK:      %[[V1:.*]] = linalg.generic {{.*}} ins(%arg1 : tensor<4xi8>) outs(%{{.*}} : tensor<4xi64>)
+  // CHECK:      %[[V2:.*]] = tensor.expand_shape %[[V1]] {{\[\[}}0, 1]] : tensor<4xi64> into tensor<4x1xi64>
+  // CHECK-NEXT: %[[V3:.*]] = "TFHE.matmul_glwe_int"(%[[V0]], %[[V2]]) : (tensor<1x4x!TFHE.glwe<sk?>>, tensor<4x1xi64>) -> tensor<1x1x!TFHE.glwe<sk?>>
+  // CHECK:      %[[V4:.*]] = tensor.extract %[[V3]][%{{.*}}, %{{.*}}] : tensor<1x1x!TFHE.glwe<sk?>>
+  // CHECK-NEXT: return %[[V4]] : !TFHE.glwe<sk?>
+
+  %0 = "FHELinalg.dot_eint_int"(%arg0, %arg1): (tensor<4x!FHE.eint<7>>, tensor<4xi8>) -> !FHE.eint<7>
+  return %0: !FHE.eint<7>
+}
@@ -0,0 +1,10 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete --skip-program-info %s 2>&1| FileCheck %s
+
+//CHECK: func.func @batched_mul_add_glwe_int(%[[A0:.*]]: tensor<8x1025xi64>, %[[A1:.*]]: tensor<8xi64>, %[[A2:.*]]: tensor<8x1025xi64>) -> tensor<8x1025xi64> {
+//CHECK:   %[[V0:.*]] = "Concrete.batched_mul_cleartext_add_lwe_tensor"(%[[A0]], %[[A1]], %[[A2]]) : (tensor<8x1025xi64>, tensor<8xi64>, tensor<8x1025xi64>) -> tensor<8x1025xi64>
+//CHECK:   return %[[V0]] : tensor<8x1025xi64>
+//CHECK: }
+func.func @batched_mul_add_glwe_int(%arg0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<8xi64>, %arg2: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> tensor<8x!TFHE.glwe<sk[1]<1,1024>>> {
+  %0 = "TFHE.batched_mul_add_glwe_int"(%arg0, %arg1, %arg2): (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, tensor<8xi64>, tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>
+}
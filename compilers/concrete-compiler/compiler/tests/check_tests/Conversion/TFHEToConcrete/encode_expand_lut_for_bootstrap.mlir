@@ -1,4 +1,4 @@
-// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete --skip-program-info %s 2>&1| FileCheck %s
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete --split-input-file --skip-program-info %s 2>&1| FileCheck %s
 
 // CHECK:  func.func @apply_lookup_table(%arg0: tensor<4xi64>) -> tensor<1024xi64> {
 // CHECK-NEXT:    %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%arg0) {isSigned = true, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
@@ -8,3 +8,15 @@ func.func @apply_lookup_table(%arg1: tensor<4xi64>) -> tensor<1024xi64> {
     %0 = "TFHE.encode_expand_lut_for_bootstrap"(%arg1) {outputBits = 3 : i32, polySize = 1024 : i32, isSigned = true} : (tensor<4xi64>) -> tensor<1024xi64>
     return %0: tensor<1024xi64>
 }
+
+// -----
+
+// CHECK:  func.func @apply_lookup_table_cst() -> tensor<8xi64> {
+// CHECK:         %[[V0:.*]] = arith.constant dense<[4611686018427387904, 4611686018427387904, 0, 0, 0, 0, -4611686018427387904, -4611686018427387904]> : tensor<8xi64>
+// CHECK-NEXT:    return %[[V0]] : tensor<8xi64>
+// CHECK-NEXT:  }
+func.func @apply_lookup_table_cst() -> tensor<8xi64> {
+    %lut = arith.constant dense<[1, 0]> : tensor<2xi64>
+    %0 = "TFHE.encode_expand_lut_for_bootstrap"(%lut) {outputBits = 1 : i32, polySize = 8 : i32, isSigned = false} : (tensor<2xi64>) -> tensor<8xi64>
+    return %0: tensor<8xi64>
+}
@@ -0,0 +1,12 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete --skip-program-info %s 2>&1| FileCheck %s
+
+//CHECK: func.func @many_bootstrap_lwe(%[[A0:.*]]: tensor<601xi64>) -> tensor<2x1025xi64> {
+//CHECK-NEXT:   %[[C0:.*]] = arith.constant dense<0> : tensor<1024xi64>
+//CHECK-NEXT:   %[[V1:.*]] = "Concrete.many_bootstrap_lwe_tensor"(%[[A0]], %[[C0]]) {baseLog = 1 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 600 : i32, level = 3 : i32, lutStride = 128 : i32, polySize = 1024 : i32} : (tensor<601xi64>, tensor<1024xi64>) -> tensor<2x1025xi64>
+//CHECK-NEXT:   return %[[V1]] : tensor<2x1025xi64>
+//CHECK-NEXT: }
+func.func @many_bootstrap_lwe(%ciphertext: !TFHE.glwe<sk[1]<1,600>>) -> tensor<2x!TFHE.glwe<sk[5]<1,1024>>> {
+  %cst = arith.constant dense<0> : tensor<1024xi64>
+  %bootstraped = "TFHE.many_bootstrap_glwe"(%ciphertext, %cst) {key = #TFHE.bsk<sk[1]<1,600>, sk[1]<1,1024>, 1024, 1, 3, 1>, lutWidth = 3 : i32}: (!TFHE.glwe<sk[1]<1,600>>, tensor<1024xi64>) -> tensor<2x!TFHE.glwe<sk[5]<1,1024>>>
+  return %bootstraped : tensor<2x!TFHE.glwe<sk[5]<1,1024>>>
+}
@@ -0,0 +1,10 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete --skip-program-info %s 2>&1| FileCheck %s
+
+//CHECK: func.func @matmul_glwe_int(%[[A0:.*]]: tensor<3x4x1025xi64>, %[[A1:.*]]: tensor<4x2xi64>) -> tensor<3x2x1025xi64> {
+//CHECK:   %[[V0:.*]] = "Concrete.matmul_cleartext_lwe_tensor"(%[[A0]], %[[A1]]) : (tensor<3x4x1025xi64>, tensor<4x2xi64>) -> tensor<3x2x1025xi64>
+//CHECK:   return %[[V0]] : tensor<3x2x1025xi64>
+//CHECK: }
+func.func @matmul_glwe_int(%arg0: tensor<3x4x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<4x2xi64>) -> tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>> {
+  %0 = "TFHE.matmul_glwe_int"(%arg0, %arg1): (tensor<3x4x!TFHE.glwe<sk[1]<1,1024>>>, tensor<4x2xi64>) -> (tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>>
+}
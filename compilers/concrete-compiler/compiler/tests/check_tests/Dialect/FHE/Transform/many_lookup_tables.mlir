@@ -0,0 +1,44 @@
+// RUN: concretecompiler --many-lookup-tables --many-lookup-tables-max-width 4 --passes fhe-many-lookup-tables --action=dump-fhe %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @pack_two(%arg0: !FHE.eint<2>) -> (!FHE.eint<3>, !FHE.eint<3>)
+func.func @pack_two(%arg0: !FHE.eint<2>) -> (!FHE.eint<3>, !FHE.eint<3>) {
+  // CHECK: %[[LUT:.*]] = arith.constant dense<[1, 0, 2, 0, 3, 1, 0, 1]> : tensor<8xi64>
+  // CHECK-NEXT: %[[V0:.*]]:2 = "FHE.apply_many_lookup_tables"(%arg0, %[[LUT]]) : (!FHE.eint<2>, tensor<8xi64>) -> (!FHE.eint<3>, !FHE.eint<3>)
+  // CHECK-NEXT: return %[[V0]]#0, %[[V0]]#1 : !FHE.eint<3>, !FHE.eint<3>
+  %lut0 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[0, 0, 1, 1]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %lut1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  return %0, %1: !FHE.eint<3>, !FHE.eint<3>
+}
+
+// CHECK-LABEL: func.func @pack_three(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>)
+func.func @pack_three(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>) {
+  // CHECK: %[[LUT:.*]] = arith.constant dense<[0, 3, 2, 0, 1, 2, 1, 0, 2, 1, 0, 0, 3, 0, 3, 0]> : tensor<16xi64>
+  // CHECK-NEXT: %[[V0:.*]]:3 = "FHE.apply_many_lookup_tables"(%arg0, %[[LUT]]) : (!FHE.eint<2>, tensor<16xi64>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>)
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %lut2 = arith.constant dense<[2, 1, 0, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %lut1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %2 = "FHE.apply_lookup_table"(%arg0, %lut2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0, %1, %2: !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>
+}
+
+// CHECK-LABEL: func.func @too_wide(%arg0: !FHE.eint<4>) -> (!FHE.eint<4>, !FHE.eint<4>)
+func.func @too_wide(%arg0: !FHE.eint<4>) -> (!FHE.eint<4>, !FHE.eint<4>) {
+  // CHECK-NOT: FHE.apply_many_lookup_tables
+  %lut = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  return %0, %1: !FHE.eint<4>, !FHE.eint<4>
+}
+
+// CHECK-LABEL: func.func @different_result_types(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<3>)
+func.func @different_result_types(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<3>) {
+  // CHECK-NOT: FHE.apply_many_lookup_tables
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  return %0, %1: !FHE.eint<2>, !FHE.eint<3>
+}
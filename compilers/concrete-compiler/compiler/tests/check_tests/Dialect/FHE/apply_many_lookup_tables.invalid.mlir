@@ -0,0 +1,23 @@
+// RUN: not concretecompiler --split-input-file --action=roundtrip  %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: error: 'FHE.apply_many_lookup_tables' op should have as `lut` a tensor of shape `<2^(p+q)>` with `p` the width of `a` (3)
+func.func @lut_too_small(%arg0: !FHE.eint<3>, %arg1: tensor<4xi64>) -> (!FHE.eint<3>, !FHE.eint<3>) {
+  %0:2 = "FHE.apply_many_lookup_tables"(%arg0, %arg1): (!FHE.eint<3>, tensor<4xi64>) -> (!FHE.eint<3>, !FHE.eint<3>)
+  return %0#0, %0#1: !FHE.eint<3>, !FHE.eint<3>
+}
+
+// -----
+
+// CHECK-LABEL: error: 'FHE.apply_many_lookup_tables' op should have between 1 and 2 results
+func.func @too_many_results(%arg0: !FHE.eint<2>, %arg1: tensor<8xi64>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>) {
+  %0:3 = "FHE.apply_many_lookup_tables"(%arg0, %arg1): (!FHE.eint<2>, tensor<8xi64>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>)
+  return %0#0, %0#1, %0#2: !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>
+}
+
+// -----
+
+// CHECK-LABEL: error: 'FHE.apply_many_lookup_tables' op should have results of the same type
+func.func @different_result_types(%arg0: !FHE.eint<2>, %arg1: tensor<8xi64>) -> (!FHE.eint<2>, !FHE.eint<3>) {
+  %0:2 = "FHE.apply_many_lookup_tables"(%arg0, %arg1): (!FHE.eint<2>, tensor<8xi64>) -> (!FHE.eint<2>, !FHE.eint<3>)
+  return %0#0, %0#1: !FHE.eint<2>, !FHE.eint<3>
+}
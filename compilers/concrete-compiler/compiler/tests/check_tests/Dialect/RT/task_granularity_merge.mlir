@@ -0,0 +1,26 @@
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize | FileCheck %s
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize --dataflow-task-duration=0 | FileCheck %s --check-prefix=NOMERGE
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize --skip-program-info --passes BuildDataflowTaskGraph | FileCheck %s --check-prefix=TASK
+
+// The two bootstraps together last no more than the target task duration and
+// get merged into a single task.
+// CHECK-COUNT-1: "RT.create_async_task"
+// CHECK-NOT:     "RT.create_async_task"
+
+// NOMERGE-COUNT-2: "RT.create_async_task"
+// NOMERGE-NOT:     "RT.create_async_task"
+
+// The result of the first lookup is passed to the second one within the task,
+// only the function arguments are task operands.
+// TASK:      %[[TASK:.*]]:2 = "RT.dataflow_task"(%arg0, %arg1) ({
+// TASK-NEXT:   %[[LUT0:.*]] = "FHE.apply_lookup_table"(%arg0, %arg1)
+// TASK-NEXT:   %[[LUT1:.*]] = "FHE.apply_lookup_table"(%[[LUT0]], %arg1)
+// TASK-NEXT:   "RT.dataflow_yield"(%[[LUT0]], %[[LUT1]])
+// TASK:      return %[[TASK]]#1
+// TASK-NOT:  "RT.dataflow_task"
+
+func.func @main(%a: !FHE.eint<2>, %lut: tensor<4xi64>) -> !FHE.eint<2> {
+  %0 = "FHE.apply_lookup_table"(%a, %lut) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+  %1 = "FHE.apply_lookup_table"(%0, %lut) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+  return %1 : !FHE.eint<2>
+}
@@ -0,0 +1,15 @@
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize | FileCheck %s
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize --dataflow-task-duration=0 | FileCheck %s --check-prefix=NOSPLIT
+
+// The 64 bootstraps last much longer than the target task duration, the
+// lookup is split into chunks of two bootstraps, each chunk being a task.
+// CHECK:     scf.forall (%{{.*}}) in (32)
+// CHECK:     "RT.create_async_task"
+
+// NOSPLIT-NOT: scf.forall
+
+func.func @main(%a: tensor<64x!FHE.eint<4>>) -> tensor<64x!FHE.eint<4>> {
+  %lut = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%a, %lut) : (tensor<64x!FHE.eint<4>>, tensor<16xi64>) -> tensor<64x!FHE.eint<4>>
+  return %0 : tensor<64x!FHE.eint<4>>
+}
@@ -0,0 +1,26 @@
+// RUN: concretecompiler --split-input-file --verify-diagnostics --action=roundtrip %s
+
+// Cleartexts batch shape
+func.func @batched_mul_add_glwe_int(%arg0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<4xi64>, %arg2: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> tensor<8x!TFHE.glwe<sk[1]<1,1024>>> {
+  // expected-error @+1 {{'TFHE.batched_mul_add_glwe_int' op should have batches of 8 cleartexts, addends and results}}
+  %0 = "TFHE.batched_mul_add_glwe_int"(%arg0, %arg1, %arg2): (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, tensor<4xi64>, tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>
+}
+
+// -----
+
+// Addends batch shape
+func.func @batched_mul_add_glwe_int(%arg0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<8xi64>, %arg2: tensor<4x!TFHE.glwe<sk[1]<1,1024>>>) -> tensor<8x!TFHE.glwe<sk[1]<1,1024>>> {
+  // expected-error @+1 {{'TFHE.batched_mul_add_glwe_int' op should have batches of 8 cleartexts, addends and results}}
+  %0 = "TFHE.batched_mul_add_glwe_int"(%arg0, %arg1, %arg2): (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, tensor<8xi64>, tensor<4x!TFHE.glwe<sk[1]<1,1024>>>) -> (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>
+}
+
+// -----
+
+// Result batch shape
+func.func @batched_mul_add_glwe_int(%arg0: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<8xi64>, %arg2: tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> tensor<4x!TFHE.glwe<sk[1]<1,1024>>> {
+  // expected-error @+1 {{'TFHE.batched_mul_add_glwe_int' op should have batches of 8 cleartexts, addends and results}}
+  %0 = "TFHE.batched_mul_add_glwe_int"(%arg0, %arg1, %arg2): (tensor<8x!TFHE.glwe<sk[1]<1,1024>>>, tensor<8xi64>, tensor<8x!TFHE.glwe<sk[1]<1,1024>>>) -> (tensor<4x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<4x!TFHE.glwe<sk[1]<1,1024>>>
+}
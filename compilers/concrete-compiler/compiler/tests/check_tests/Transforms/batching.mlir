@@ -323,3 +323,15 @@ func.func @apply_lookup_table_contiguous_hoistable_nonbatchable(%arg0: tensor<2x
   }
   return %1 : tensor<2x3x4x!TFHE.glwe<sk<0,1,2048>>>
 }
+
+// -----
+
+// CHECK-LABEL: func.func @fuse_batched_mul_add
+// CHECK: (%[[A0:.*]]: tensor<8x!TFHE.glwe<sk{{\[}}[[SK:.*]]{{\]}}<1,2048>>>, %[[A1:.*]]: tensor<8xi64>, %[[A2:.*]]: tensor<8x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>) -> tensor<8x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>> {
+// CHECK-NEXT: %[[V0:.*]] = "TFHE.batched_mul_add_glwe_int"(%[[A0]], %[[A1]], %[[A2]]) : (tensor<8x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>, tensor<8xi64>, tensor<8x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>) -> tensor<8x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>
+// CHECK-NEXT: return %[[V0]]
+func.func @fuse_batched_mul_add(%arg0: tensor<8x!TFHE.glwe<sk<0,1,2048>>>, %arg1: tensor<8xi64>, %arg2: tensor<8x!TFHE.glwe<sk<0,1,2048>>>) -> tensor<8x!TFHE.glwe<sk<0,1,2048>>> {
+  %0 = "TFHE.batched_mul_glwe_int"(%arg0, %arg1) : (tensor<8x!TFHE.glwe<sk<0,1,2048>>>, tensor<8xi64>) -> tensor<8x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = "TFHE.batched_add_glwe"(%arg2, %0) : (tensor<8x!TFHE.glwe<sk<0,1,2048>>>, tensor<8x!TFHE.glwe<sk<0,1,2048>>>) -> tensor<8x!TFHE.glwe<sk<0,1,2048>>>
+  return %1 : tensor<8x!TFHE.glwe<sk<0,1,2048>>>
+}
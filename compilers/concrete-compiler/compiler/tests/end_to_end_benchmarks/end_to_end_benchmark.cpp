@@ -4,6 +4,7 @@
 
 #include <benchmark/benchmark.h>
 #include <filesystem>
+#include <thread>
 
 #define BENCHMARK_HAS_CXX11
 #include "llvm/Support/Path.h"
@@ -19,33 +20,61 @@ using namespace concretelang::testlib;
     assert(false && "See error above");                                        \
   }
 
-/// Benchmark time of the compilation
+/// Sets the environment variable `name` to the number of threads benchmarked
+/// by `state`, i.e. `state.range(0)`, and unsets it when going out of scope.
+class ScopedNumThreads {
+public:
+  ScopedNumThreads(const char *name, benchmark::State &state) : name(name) {
+    setenv(name, std::to_string(state.range(0)).c_str(), 1);
+  }
+  ~ScopedNumThreads() { unsetenv(name); }
+
+private:
+  const char *name;
+};
+
+/// Makes `bench` run with `state.range(0)` going from 1 to the number of
+/// hardware threads.
+static benchmark::internal::Benchmark *
+withThreadRange(benchmark::internal::Benchmark *bench) {
+  return bench->RangeMultiplier(2)
+      ->Range(1, std::max(1u, std::thread::hardware_concurrency()))
+      ->UseRealTime();
+}
+
+/// Benchmark time of the compilation, with the circuits code generated by
+/// `state.range(0)` threads.
 static void BM_Compile(benchmark::State &state, EndToEndDesc description,
                        mlir::concretelang::CompilationOptions options) {
   TestProgram tc(options);
+  ScopedNumThreads numThreads("CONCRETE_COMPILER_NUM_THREADS", state);
   for (auto _ : state) {
     assert(tc.compile(description.program));
   }
 }
 
-/// Benchmark time of the key generation
+/// Benchmark time of the key generation, with the evaluation keys generated
+/// by `state.range(0)` threads.
 static void BM_KeyGen(benchmark::State &state, EndToEndDesc description,
                       mlir::concretelang::CompilationOptions options) {
   TestProgram tc(options);
   assert(tc.compile(description.program));
+  ScopedNumThreads numThreads("CONCRETE_KEYGEN_NUM_THREADS", state);
 
   for (auto _ : state) {
     assert(tc.generateKeyset(0, 0, false));
   }
 }
 
-/// Benchmark time of the encryption
+/// Benchmark time of the encryption, with the tensors encrypted by
+/// `state.range(0)` threads.
 static void BM_ExportArguments(benchmark::State &state,
                                EndToEndDesc description,
                                mlir::concretelang::CompilationOptions options) {
   TestProgram tc(options);
   assert(tc.compile(description.program));
   assert(tc.generateKeyset());
+  ScopedNumThreads numThreads("CONCRETE_CLIENT_NUM_THREADS", state);
 
   assert(description.tests.size() > 0);
   auto test = description.tests[0];
@@ -91,11 +120,105 @@ static void BM_Evaluate(benchmark::State &state, EndToEndDesc description,
   }
 }
 
+/// Benchmark throughput of concurrent evaluations of a single server circuit
+/// shared by `state.range(0)` threads.
+static void
+BM_EvaluateConcurrent(benchmark::State &state, EndToEndDesc description,
+                      mlir::concretelang::CompilationOptions options) {
+  size_t numThreads = state.range(0);
+  TestProgram tc(options);
+  assert(tc.compile(description.program));
+  assert(tc.generateKeyset());
+  auto clientCircuit = tc.getClientCircuit().value();
+
+  assert(description.tests.size() > 0);
+  auto test = description.tests[0];
+  auto inputArguments = std::vector<TransportValue>();
+  inputArguments.reserve(test.inputs.size());
+
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    auto input =
+        clientCircuit.prepareInput(test.inputs[i].getValue(), i).value();
+    inputArguments.push_back(input);
+  }
+
+  auto serverCircuit = tc.getServerCircuit().value();
+  auto serverKeyset = tc.getServerKeyset().value();
+  auto evaluate = [&]() {
+    auto args = inputArguments;
+    auto returns = tc.isSimulation() ? serverCircuit.simulate(args)
+                                     : serverCircuit.call(serverKeyset, args);
+    assert(returns);
+  };
+
+  // Warmup, also prepares the runtime context shared by all the threads.
+  evaluate();
+
+  for (auto _ : state) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < numThreads; i++) {
+      workers.emplace_back(evaluate);
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numThreads);
+}
+
+/// Benchmark throughput of batches of `state.range(0)` evaluations, run as
+/// sequential calls if `state.range(1)` is 0 and as a single `callBatch`
+/// otherwise.
+static void BM_EvaluateBatch(benchmark::State &state, EndToEndDesc description,
+                             mlir::concretelang::CompilationOptions options) {
+  size_t batchSize = state.range(0);
+  bool useCallBatch = state.range(1);
+  TestProgram tc(options);
+  assert(tc.compile(description.program));
+  assert(tc.generateKeyset());
+  auto clientCircuit = tc.getClientCircuit().value();
+
+  assert(description.tests.size() > 0);
+  auto test = description.tests[0];
+  auto inputArguments = std::vector<TransportValue>();
+  inputArguments.reserve(test.inputs.size());
+
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    auto input =
+        clientCircuit.prepareInput(test.inputs[i].getValue(), i).value();
+    inputArguments.push_back(input);
+  }
+
+  auto serverCircuit = tc.getServerCircuit().value();
+  auto serverKeyset = tc.getServerKeyset().value();
+  auto evaluate = [&]() {
+    auto batch = std::vector<std::vector<TransportValue>>(batchSize,
+                                                          inputArguments);
+    if (useCallBatch) {
+      assert(serverCircuit.callBatch(serverKeyset, batch));
+      return;
+    }
+    for (auto &args : batch) {
+      assert(serverCircuit.call(serverKeyset, args));
+    }
+  };
+
+  // Warmup, also prepares the runtime context shared by all the calls.
+  evaluate();
+
+  for (auto _ : state) {
+    evaluate();
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
 enum Action {
   COMPILE,
   KEYGEN,
   ENCRYPT,
   EVALUATE,
+  EVALUATE_CONCURRENT,
+  EVALUATE_BATCH,
 };
 
 void registerEndToEndBenchmark(std::string suiteName,
@@ -120,24 +243,24 @@ void registerEndToEndBenchmark(std::string suiteName,
     for (auto action : actions) {
       switch (action) {
       case Action::COMPILE:
-        benchmark::RegisterBenchmark(benchName("compile").c_str(),
-                                     [=](::benchmark::State &st) {
-                                       BM_Compile(st, description, options);
-                                     });
+        withThreadRange(benchmark::RegisterBenchmark(
+            benchName("compile").c_str(), [=](::benchmark::State &st) {
+              BM_Compile(st, description, options);
+            }));
         break;
       case Action::KEYGEN:
-        benchmark::RegisterBenchmark(benchName("keygen").c_str(),
-                                     [=](::benchmark::State &st) {
-                                       BM_KeyGen(st, description, options);
-                                     });
+        withThreadRange(benchmark::RegisterBenchmark(
+            benchName("keygen").c_str(), [=](::benchmark::State &st) {
+              BM_KeyGen(st, description, options);
+            }));
         break;
       case Action::ENCRYPT:
-        benchmark::RegisterBenchmark(
+        withThreadRange(benchmark::RegisterBenchmark(
             benchName("encrypt").c_str(), [=](::benchmark::State &st) {
               BM_ExportArguments(st, description, options);
-            });
+            }));
         break;
-      case Action::EVALUATE:
+      case Action::EVALUATE: {
         auto bench = benchmark::RegisterBenchmark(
             benchName("evaluate").c_str(), [=](::benchmark::State &st) {
               BM_Evaluate(st, description, options);
@@ -146,6 +269,30 @@ void registerEndToEndBenchmark(std::string suiteName,
           bench->Iterations(num_iterations);
         break;
       }
+      case Action::EVALUATE_CONCURRENT: {
+        auto bench = benchmark::RegisterBenchmark(
+            benchName("evaluate_concurrent").c_str(),
+            [=](::benchmark::State &st) {
+              BM_EvaluateConcurrent(st, description, options);
+            });
+        withThreadRange(bench);
+        if (num_iterations)
+          bench->Iterations(num_iterations);
+        break;
+      }
+      case Action::EVALUATE_BATCH: {
+        auto bench = benchmark::RegisterBenchmark(
+            benchName("evaluate_batch").c_str(), [=](::benchmark::State &st) {
+              BM_EvaluateBatch(st, description, options);
+            });
+        bench->RangeMultiplier(4)
+            ->Ranges({{1, 64}, {0, 1}})
+            ->ArgNames({"batch", "call_batch"})
+            ->UseRealTime();
+        if (num_iterations)
+          bench->Iterations(num_iterations);
+        break;
+      }
     }
   }
   setCurrentStackLimit(stackSizeRequirement);
@@ -165,7 +312,12 @@ int main(int argc, char **argv) {
       llvm::cl::values(
           clEnumValN(Action::ENCRYPT, "encrypt", "Run encrypt benchmark")),
       llvm::cl::values(
-          clEnumValN(Action::EVALUATE, "evaluate", "Run evaluate benchmark")));
+          clEnumValN(Action::EVALUATE, "evaluate", "Run evaluate benchmark")),
+      llvm::cl::values(clEnumValN(Action::EVALUATE_CONCURRENT,
+                                  "evaluate_concurrent",
+                                  "Run multi-threaded evaluate benchmark")),
+      llvm::cl::values(clEnumValN(Action::EVALUATE_BATCH, "evaluate_batch",
+                                  "Run batched evaluate benchmark")));
 
   // parse end to end test compiler options
   auto options = parseEndToEndCommandLine(argc, argv);
@@ -0,0 +1,63 @@
+import argparse
+
+import numpy as np
+
+from end_to_end_linalg_leveled_gen import P_ERROR
+
+
+def generate(args):
+    print("# /!\\ DO NOT EDIT MANUALLY THIS FILE MANUALLY")
+    print("# /!\\ THIS FILE HAS BEEN GENERATED")
+    np.random.seed(0)
+    for n_circuits in args.n_circuits:
+        for p in args.bitwidth:
+            max_value = (2 ** p) - 1
+            ty = f"tensor<{args.n_ct}x!FHE.eint<{p}>>"
+            luts = [np.random.randint(max_value+1, size=2**p) for _ in range(n_circuits)]
+            # The tests run `main`, the other circuits only add compilation work
+            names = ["main"] + [f"circuit_{i}" for i in range(1, n_circuits)]
+            print(f"description: multi_circuit_{p}bits_{args.n_ct}ct_{n_circuits}circuits")
+            print("program: |")
+            for name, lut in zip(names, luts):
+                print(f"  func.func @{name}(%arg0: {ty}) -> {ty} {{")
+                print(f"    %tlu = arith.constant dense<[{','.join(map(str, lut))}]> : tensor<{2**p}xi64>")
+                print(f"    %0 = \"FHELinalg.add_eint\"(%arg0, %arg0): ({ty}, {ty}) -> ({ty})")
+                print(f"    %1 = \"FHELinalg.apply_lookup_table\"(%0, %tlu): ({ty}, tensor<{2**p}xi64>) -> ({ty})")
+                print(f"    return %1: {ty}")
+                print("  }")
+            print(f"p-error: {P_ERROR}")
+            random_input = np.random.randint((max_value+1) // 2, size=args.n_ct)
+            outputs = [luts[0][2 * v] for v in random_input]
+            print("tests:")
+            print("  - inputs:")
+            print(f"    - tensor: [{','.join(map(str, random_input))}]")
+            print(f"      shape: [{args.n_ct}]")
+            print("    outputs:")
+            print(f"    - tensor: [{','.join(map(str, outputs))}]")
+            print(f"      shape: [{args.n_ct}]")
+            print("---")
+
+
+if __name__ == "__main__":
+    CLI = argparse.ArgumentParser()
+    CLI.add_argument(
+        "--bitwidth",
+        help="Specify the list of bitwidth to generate",
+        nargs="+",
+        type=int,
+        default=[4],
+    )
+    CLI.add_argument(
+        "--n-ct",
+        help="Specify the tensor size of the circuits",
+        type=int,
+        default=16,
+    )
+    CLI.add_argument(
+        "--n-circuits",
+        help="Specify the list of number of circuits to generate",
+        nargs="+",
+        type=int,
+        default=[1, 8, 32],
+    )
+    generate(CLI.parse_args())
@@ -502,3 +502,130 @@ func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
   ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.simulate({Tensor<uint64_t>(7)}));
   ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], (uint64_t)(7));
 }
+
+// Runs `src` on `args` compiled with and without the GEMM lowering of the
+// encrypted by clear products, and checks that both return `expected`.
+static void
+checkGemmMatchesDefault(llvm::StringRef src,
+                        std::vector<concretelang::values::Value> args,
+                        Tensor<uint64_t> expected) {
+  for (bool gemm : {false, true}) {
+    mlir::concretelang::CompilationOptions options;
+    options.optimizerConfig.global_p_error = DEFAULT_global_p_error;
+    options.gemmTFHEOps = gemm;
+    TestProgram circuit(options);
+    ASSERT_OUTCOME_HAS_VALUE(circuit.compile(src.str()));
+    ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+    ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.call(args));
+    ASSERT_EQ(result[0].getTensor<uint64_t>().value(), expected)
+        << "with gemm = " << gemm;
+  }
+}
+
+TEST(CompileAndRunGemm, matmul_eint_int) {
+  checkGemmMatchesDefault(R"XXX(
+func.func @main(%x: tensor<2x3x!FHE.eint<6>>, %y: tensor<3x2xi8>) -> tensor<2x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%x, %y): (tensor<2x3x!FHE.eint<6>>, tensor<3x2xi8>) -> tensor<2x2x!FHE.eint<6>>
+  return %0 : tensor<2x2x!FHE.eint<6>>
+}
+)XXX",
+                          {Tensor<uint64_t>({1, 2, 3, 3, 0, 1}, {2, 3}),
+                           Tensor<uint8_t>({2, 1, 0, 3, 1, 2}, {3, 2})},
+                          Tensor<uint64_t>({5, 13, 7, 5}, {2, 2}));
+}
+
+TEST(CompileAndRunGemm, dot_eint_int) {
+  checkGemmMatchesDefault(R"XXX(
+func.func @main(%x: tensor<4x!FHE.eint<6>>, %y: tensor<4xi8>) -> !FHE.eint<6> {
+  %0 = "FHELinalg.dot_eint_int"(%x, %y): (tensor<4x!FHE.eint<6>>, tensor<4xi8>) -> !FHE.eint<6>
+  return %0 : !FHE.eint<6>
+}
+)XXX",
+                          {Tensor<uint64_t>({1, 2, 3, 4}, {4}),
+                           Tensor<uint8_t>({4, 3, 2, 1}, {4})},
+                          Tensor<uint64_t>(20));
+}
+
+TEST(CompileAndRunGemm, conv2d) {
+  checkGemmMatchesDefault(R"XXX(
+func.func @main(%x: tensor<1x1x3x3x!FHE.eint<6>>, %w: tensor<2x1x2x2xi8>, %b: tensor<2xi8>) -> tensor<1x2x2x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.conv2d"(%x, %w, %b){strides = dense<[1,1]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>, group = 1 : i64}: (tensor<1x1x3x3x!FHE.eint<6>>, tensor<2x1x2x2xi8>, tensor<2xi8>) -> tensor<1x2x2x2x!FHE.eint<6>>
+  return %0 : tensor<1x2x2x2x!FHE.eint<6>>
+}
+)XXX",
+                          {Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7, 0},
+                                            {1, 1, 3, 3}),
+                           Tensor<uint8_t>({1, 0, 0, 1, 0, 1, 1, 0},
+                                           {2, 1, 2, 2}),
+                           Tensor<uint8_t>({1, 2}, {2})},
+                          Tensor<uint64_t>({5, 7, 11, 5, 6, 8, 12, 14},
+                                           {1, 2, 2, 2}));
+}
+
+TEST(CompileAndRunManyLookupTables, decrypt_every_output) {
+  mlir::concretelang::CompilationOptions options;
+  options.optimizerConfig.global_p_error = DEFAULT_global_p_error;
+  options.manyLookupTables = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>) {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %lut2 = arith.constant dense<[2, 1, 0, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %lut1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %2 = "FHE.apply_lookup_table"(%arg0, %lut2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0, %1, %2: !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  uint64_t luts[3][4] = {{0, 1, 2, 3}, {3, 2, 1, 0}, {2, 1, 0, 3}};
+  for (uint64_t x = 0; x < 4; x++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(results, circuit.call({Tensor<uint64_t>(x)}));
+    ASSERT_EQ(results.size(), 3u);
+    for (size_t j = 0; j < 3; j++) {
+      ASSERT_EQ(results[j].getTensor<uint64_t>().value()[0], luts[j][x])
+          << "output " << j << " of x = " << x;
+    }
+  }
+}
+
+TEST(CompileAndRunMultiBit, decrypt_lookup_tables) {
+  mlir::concretelang::CompilationOptions options;
+  options.optimizerConfig.global_p_error = DEFAULT_global_p_error;
+  // The optimized parameters favour the classic bootstrap, force parameters
+  // with a coarse blind rotation decomposition for which a multi-bit bootstrap
+  // is less noisy (see test_multi_bit_grouping_factor of the optimizer).
+  options.v0Parameter =
+      mlir::concretelang::V0Parameter{1, 11, 840, 3, 8, 5, 3, std::nullopt};
+  options.maxMultiBitGroupingFactor = 3;
+  options.manyLookupTables = true;
+  TestProgram circuit(options);
+  // The first lookup is a single bootstrap, the two others share theirs.
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> (!FHE.eint<3>, !FHE.eint<3>) {
+  %lut0 = arith.constant dense<[1, 3, 5, 7, 0, 2, 4, 6]> : tensor<8xi64>
+  %lut1 = arith.constant dense<[7, 6, 5, 4, 3, 2, 1, 0]> : tensor<8xi64>
+  %lut2 = arith.constant dense<[0, 0, 1, 1, 2, 2, 3, 3]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.apply_lookup_table"(%0, %lut1): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %2 = "FHE.apply_lookup_table"(%0, %lut2): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1, %2: !FHE.eint<3>, !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverKeyset, circuit.getServerKeyset());
+  bool multiBit = false;
+  for (auto &key : serverKeyset.lweBootstrapKeys)
+    if (key.getInfo().asReader().getParams().getGroupingFactor() > 1)
+      multiBit = true;
+  ASSERT_TRUE(multiBit);
+  for (uint64_t x = 0; x < 8; x++) {
+    uint64_t y = (2 * x + 1) % 8;
+    ASSERT_ASSIGN_OUTCOME_VALUE(results, circuit.call({Tensor<uint64_t>(x)}));
+    ASSERT_EQ(results[0].getTensor<uint64_t>().value()[0], 7 - y)
+        << "x = " << x;
+    ASSERT_EQ(results[1].getTensor<uint64_t>().value()[0], y / 2)
+        << "x = " << x;
+  }
+}
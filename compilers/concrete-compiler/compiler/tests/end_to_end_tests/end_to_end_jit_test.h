@@ -53,9 +53,7 @@ inline Result<TestProgram> internalCheckedJit(
         mlir::concretelang::optimizer::Strategy::V0;
   }
   options.loopParallelize = loopParallelize;
-#ifdef CONCRETELANG_DATAFLOW_EXECUTION_ENABLED
   options.dataflowParallelize = dataflowParallelize;
-#endif
   options.batchTFHEOps = batchTFHEOps;
 
   if (!use_multi_parameter)
@@ -70,6 +70,11 @@ parseEndToEndCommandLine(int argc, char **argv) {
       llvm::cl::desc(
           "Set the batchTFHEOps compilation options to run the tests"),
       llvm::cl::init(-1));
+  llvm::cl::opt<int> asyncTFHEOps(
+      "async-tfhe-ops",
+      llvm::cl::desc(
+          "Set the asyncTFHEOps compilation options to run the tests"),
+      llvm::cl::init(-1));
   llvm::cl::opt<bool> simulate("simulate",
                                llvm::cl::desc("Simulate the FHE execution"),
                                llvm::cl::init(false));
@@ -156,6 +161,8 @@ parseEndToEndCommandLine(int argc, char **argv) {
     compilationOptions.emitGPUOps = emitGPUOps.getValue();
   if (batchTFHEOps.getValue() != -1)
     compilationOptions.batchTFHEOps = batchTFHEOps.getValue();
+  if (asyncTFHEOps.getValue() != -1)
+    compilationOptions.asyncTFHEOps = asyncTFHEOps.getValue();
   compilationOptions.simulate = simulate.getValue();
   compilationOptions.compressEvaluationKeys = compressEvaluationKeys.getValue();
   compilationOptions.compressInputCiphertexts =
@@ -74,3 +74,26 @@ def test_accepted_array_as_scalar():
         pytest.fail(f"value of type {type(value)} should be supported")
     assert arg.is_scalar(), "should have been a scalar"
     assert arg.to_py_val() == value
+
+
+def test_accepted_strided_ndarray():
+    value = np.arange(24, dtype=np.int64).reshape(4, 6)[::2, 1::2]
+    arg = Value(value)
+    assert np.all(np.equal(arg.get_shape(), value.shape))
+    assert np.all(np.equal(value, arg.to_py_val()))
+
+
+def test_rejected_non_native_byte_order():
+    value = np.array([1, 2, 3], dtype=np.dtype(np.int64).newbyteorder())
+    with pytest.raises(RuntimeError):
+        Value(value)
+
+
+def test_to_py_val_is_read_only_view():
+    arg = Value(np.array([[1, 2], [3, 4]], dtype=np.int64))
+    array = arg.to_py_val()
+    assert not array.flags.writeable
+    assert not array.flags.owndata
+    # The view keeps the value alive
+    del arg
+    assert np.all(np.equal(array, [[1, 2], [3, 4]]))
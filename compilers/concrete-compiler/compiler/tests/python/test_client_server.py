@@ -2,6 +2,7 @@ import numpy as np
 import pytest
 import shutil
 import tempfile
+import threading
 
 from concrete.compiler import (
     Library,
@@ -149,3 +150,92 @@ def test_client_server_end_to_end(mlir, args, expected_results, keyset_cache):
                 for (result, expected) in zip(results_deserialized, expected_results)
             ]
         )
+
+
+def test_client_server_runtime_context_cache(keyset_cache):
+    mlir = """
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+    %lut = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+    %1 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+    return %1: !FHE.eint<3>
+}
+"""
+    with tempfile.TemporaryDirectory() as tmpdirname:
+        support = Compiler(
+            str(tmpdirname), lookup_runtime_lib(), generate_shared_lib=True
+        )
+        library = support.compile(mlir, CompilationOptions(Backend.CPU))
+
+        program_info = library.get_program_info()
+        keyset = Keyset(program_info, keyset_cache)
+        evaluation_keys = keyset.get_server_keys()
+
+        client_program = ClientProgram.create_encrypted(program_info, keyset)
+        client_circuit = client_program.get_client_circuit("main")
+
+        server_program = ServerProgram(library, False)
+        server_circuit = server_program.get_server_circuit("main")
+
+        for arg in range(3):
+            result = server_circuit.call(
+                [client_circuit.prepare_input(Value(arg), 0)], evaluation_keys
+            )
+            assert client_circuit.process_output(result[0], 0).to_py_val() == arg
+
+        metrics = server_program.get_runtime_context_cache_metrics()
+        assert metrics["misses"] == 1
+        assert metrics["hits"] == 2
+        assert metrics["entries"] == 1
+        assert metrics["memory_footprint"] > 0
+
+        assert server_program.evict_runtime_context(evaluation_keys)
+        assert server_program.get_runtime_context_cache_metrics()["entries"] == 0
+
+
+def test_client_server_prepare_input_from_threads(keyset_cache):
+    mlir = """
+func.func @main(%arg0: tensor<4x!FHE.eint<5>>) -> tensor<4x!FHE.eint<5>> {
+    %0 = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi6>
+    %1 = "FHELinalg.add_eint_int"(%arg0, %0): (tensor<4x!FHE.eint<5>>, tensor<4xi6>) -> tensor<4x!FHE.eint<5>>
+    return %1: tensor<4x!FHE.eint<5>>
+}
+"""
+    with tempfile.TemporaryDirectory() as tmpdirname:
+        support = Compiler(
+            str(tmpdirname), lookup_runtime_lib(), generate_shared_lib=True
+        )
+        library = support.compile(mlir, CompilationOptions(Backend.CPU))
+
+        program_info = library.get_program_info()
+        keyset = Keyset(program_info, keyset_cache)
+        evaluation_keys = keyset.get_server_keys()
+
+        # Both threads encrypt with the generator shared by the client program
+        client_program = ClientProgram.create_encrypted(program_info, keyset)
+        client_circuit = client_program.get_client_circuit("main")
+        arg = np.array([1, 2, 3, 4], dtype=np.int64)
+        num_inputs = 16
+        prepared = [[], []]
+
+        def prepare(thread_id):
+            for _ in range(num_inputs):
+                prepared[thread_id].append(client_circuit.prepare_input(Value(arg), 0))
+
+        threads = [threading.Thread(target=prepare, args=(i,)) for i in range(2)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        inputs = prepared[0] + prepared[1]
+        assert len(inputs) == 2 * num_inputs
+        # Encryptions of the same value never share their masks
+        serialized = {input.serialize() for input in inputs}
+        assert len(serialized) == len(inputs)
+
+        server_program = ServerProgram(library, False)
+        server_circuit = server_program.get_server_circuit("main")
+        for input in inputs:
+            result = server_circuit.call([input], evaluation_keys)
+            output = client_circuit.process_output(result[0], 0).to_py_val()
+            assert np.array_equal(output, arg + np.array([1, 2, 3, 4]))
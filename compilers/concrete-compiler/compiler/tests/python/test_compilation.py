@@ -267,6 +267,68 @@ def test_lib_compilation_artifacts():
     assert not os.path.exists(library.get_shared_lib_path())
 
 
+@pytest.mark.parametrize("mlir_input, args, expected_result", end_to_end_fixture[:1])
+def test_lib_compile_with_cache(mlir_input, args, expected_result, keyset_cache):
+    cache_dir = "./test_lib_compile_with_cache"
+    options = CompilationOptions(Backend.CPU)
+    options.set_compilation_cache_dir(cache_dir)
+
+    def entry_files():
+        (entry,) = os.listdir(cache_dir)
+        entry_dir = os.path.join(cache_dir, entry)
+        return [os.path.join(entry_dir, name) for name in os.listdir(entry_dir)]
+
+    # The first compilation fills the cache, the second one reuses it
+    for artifact_dir in ["./test_lib_compile_miss", "./test_lib_compile_hit"]:
+        compiler = Compiler(artifact_dir, lookup_runtime_lib())
+        compile_run_assert(
+            compiler, mlir_input, args, expected_result, keyset_cache, options
+        )
+        shutil.rmtree(artifact_dir)
+        if artifact_dir == "./test_lib_compile_miss":
+            # A compilation rewrites the entry, a hit leaves it untouched
+            for path in entry_files():
+                os.utime(path, (0, 0))
+    assert all(os.stat(path).st_mtime == 0 for path in entry_files())
+    shutil.rmtree(cache_dir)
+
+
+@pytest.mark.parametrize("mlir_input, args, expected_result", end_to_end_fixture[:1])
+def test_lib_compile_with_optimizer_cache(
+    mlir_input, args, expected_result, keyset_cache, monkeypatch
+):
+    cache_dir = "./test_lib_compile_with_optimizer_cache"
+    monkeypatch.setenv("CONCRETE_OPTIMIZER_CACHE_DIR", cache_dir)
+    artifact_dir = "./test_lib_compile_with_optimizer_cache_artifacts"
+
+    other_options = CompilationOptions(Backend.CPU)
+    other_options.set_global_p_error(0.00001)
+
+    # The first compilation fills the cache, the second one reuses its entries
+    # and the last one, whose options differ, misses them
+    entries = []
+    for options in [
+        CompilationOptions(Backend.CPU),
+        CompilationOptions(Backend.CPU),
+        other_options,
+    ]:
+        compiler = Compiler(artifact_dir, lookup_runtime_lib())
+        compile_run_assert(
+            compiler,
+            mlir_input,
+            args,
+            expected_result,
+            keyset_cache,
+            options,
+        )
+        shutil.rmtree(artifact_dir)
+        entries.append(sorted(os.listdir(cache_dir)))
+    assert len(entries[0]) > 0
+    assert entries[0] == entries[1]
+    assert set(entries[1]) < set(entries[2])
+    shutil.rmtree(cache_dir)
+
+
 def test_multi_circuits(keyset_cache):
     from mlir._mlir_libs._concretelang._compiler import OptimizerStrategy
 
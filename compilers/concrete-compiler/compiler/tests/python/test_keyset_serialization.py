@@ -17,7 +17,8 @@ from concrete.compiler import (
 )
 
 
-def test_keyset_serialization():
+@pytest.mark.parametrize("precompute_fourier", [False, True])
+def test_keyset_serialization(precompute_fourier):
     mlir = """
 
 module {
@@ -45,10 +46,18 @@ module {
         keyset = Keyset.deserialize(keyset.serialize())
 
         evaluation_keys = keyset.get_server_keys()
+        if precompute_fourier:
+            evaluation_keys.precompute_fourier_bootstrap_keys()
         evaluation_keys_serialized = evaluation_keys.serialize()
         evaluation_keys_deserialized = ServerKeyset.deserialize(
             evaluation_keys_serialized
         )
+        # The fourier key survives serialization and is picked by the runtime
+        # instead of converting the standard key again
+        assert (
+            evaluation_keys_deserialized.has_fourier_bootstrap_key(0)
+            == precompute_fourier
+        )
 
         client_program = ClientProgram.create_encrypted(program_info, keyset)
         client_circuit = client_program.get_client_circuit("main")
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include "concretelang/Runtime/context.h"
+#include <cstring>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+using concretelang::protocol::arrayToProtoPayload;
+using mlir::concretelang::RuntimeContext;
+using mlir::concretelang::RuntimeContextCache;
+using mlir::concretelang::ScratchArena;
+
+TEST(ScratchArena, grows_to_high_water_mark) {
+  ScratchArena arena;
+  auto first = arena.get(ScratchArena::FFT_SCRATCH, 1024, 64);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0u);
+  // Smaller requests reuse the buffer.
+  ASSERT_EQ(arena.get(ScratchArena::FFT_SCRATCH, 512, 64), first);
+  ASSERT_EQ(arena.memoryFootprint(), 1024u);
+  // Larger or more aligned requests grow it.
+  auto second = arena.get(ScratchArena::FFT_SCRATCH, 512, 4096);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(second) % 4096, 0u);
+  ASSERT_EQ(arena.get(ScratchArena::FFT_SCRATCH, 512, 64), second);
+  // Slots are independent.
+  ASSERT_NE(arena.get<uint64_t>(ScratchArena::GLWE_ACCUMULATOR, 8), second);
+}
+
+TEST(ScratchArena, realignment_keeps_high_water_mark) {
+  ScratchArena arena;
+  arena.get(ScratchArena::FFT_SCRATCH, 8192, 64);
+  auto realigned = arena.get(ScratchArena::FFT_SCRATCH, 512, 4096);
+  ASSERT_EQ(arena.memoryFootprint(), 8192u);
+  ASSERT_EQ(arena.get(ScratchArena::FFT_SCRATCH, 8192, 64), realigned);
+}
+
+TEST(ScratchArena, glwe_accumulator) {
+  ScratchArena arena;
+  std::vector<uint64_t> lut1{1, 2, 3, 4};
+  std::vector<uint64_t> lut2{5, 6, 7, 8};
+
+  auto acc = arena.glwe_accumulator(lut1.data(), 2, 4);
+  ASSERT_EQ(std::vector<uint64_t>(acc, acc + 12),
+            std::vector<uint64_t>({0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4}));
+  // Rebuilding the accumulator only replaces its body.
+  ASSERT_EQ(arena.glwe_accumulator(lut2.data(), 2, 4), acc);
+  ASSERT_EQ(std::vector<uint64_t>(acc, acc + 12),
+            std::vector<uint64_t>({0, 0, 0, 0, 0, 0, 0, 0, 5, 6, 7, 8}));
+  // A larger mask is zeroed again over the previous body.
+  acc = arena.glwe_accumulator(lut1.data(), 1, 4);
+  ASSERT_EQ(arena.glwe_accumulator(lut2.data(), 2, 4), acc);
+  ASSERT_EQ(std::vector<uint64_t>(acc, acc + 12),
+            std::vector<uint64_t>({0, 0, 0, 0, 0, 0, 0, 0, 5, 6, 7, 8}));
+}
+
+TEST(ScratchArena, one_arena_per_thread) {
+  RuntimeContext context{ServerKeyset()};
+  ScratchArena *mainArena = &context.scratch_arena();
+  ASSERT_EQ(&context.scratch_arena(), mainArena);
+  ScratchArena *otherArena = nullptr;
+  std::thread([&]() { otherArena = &context.scratch_arena(); }).join();
+  ASSERT_NE(otherArena, mainArena);
+  // The arena of a thread is shared by all the contexts.
+  RuntimeContext otherContext{ServerKeyset()};
+  ASSERT_EQ(&otherContext.scratch_arena(), mainArena);
+}
+
+TEST(RuntimeContextCache, reuses_context_of_same_keyset) {
+  RuntimeContextCache cache;
+  ServerKeyset keyset;
+  ServerKeyset keysetCopy = keyset;
+
+  auto first = cache.get(keyset);
+  auto second = cache.get(keysetCopy);
+  ASSERT_EQ(first.get(), second.get());
+
+  auto metrics = cache.getMetrics();
+  ASSERT_EQ(metrics.misses, 1u);
+  ASSERT_EQ(metrics.hits, 1u);
+  ASSERT_EQ(metrics.entries, 1u);
+  ASSERT_EQ(metrics.memoryFootprint, 0u);
+}
+
+TEST(RuntimeContextCache, evicted_context_is_rebuilt) {
+  RuntimeContextCache cache;
+  ServerKeyset keyset;
+
+  auto first = cache.get(keyset);
+  ASSERT_TRUE(cache.evict(keyset));
+  ASSERT_FALSE(cache.evict(keyset));
+  ASSERT_EQ(cache.getMetrics().entries, 0u);
+
+  // Evicted contexts stay valid for the calls still holding them.
+  auto second = cache.get(keyset);
+  ASSERT_NE(first.get(), second.get());
+  ASSERT_EQ(cache.getMetrics().misses, 2u);
+
+  cache.evictAll();
+  ASSERT_EQ(cache.getMetrics().entries, 0u);
+}
+
+TEST(RuntimeContext, uses_mapped_keyswitch_key_in_place) {
+  std::vector<uint64_t> payload(64, 42);
+  Message<concreteprotocol::LweKeyswitchKey> proto;
+  proto.asBuilder().initInfo().setCompression(
+      concreteprotocol::Compression::NONE);
+  proto.asBuilder().setPayload(
+      arrayToProtoPayload(payload.data(), payload.size()).asReader());
+  auto blob = proto.asReader().getPayload().getData()[0];
+
+  // The message outlives the key, so no owner is needed.
+  auto key = LweKeyswitchKey::fromProto(proto.asReader(), nullptr);
+  ASSERT_EQ(key.getRawPtr(), reinterpret_cast<const uint64_t *>(blob.begin()));
+  ASSERT_EQ(key.getSize(), payload.size());
+
+  ServerKeyset keyset;
+  keyset.lweKeyswitchKeys.push_back(key);
+  RuntimeContext context{keyset};
+  ASSERT_EQ(context.keyswitch_key_buffer(0), key.getRawPtr());
+  // The vector of the key is only filled on demand.
+  ASSERT_EQ(key.getBuffer(), payload);
+}
+
+/// Builds a keyswitch key message whose payload is split in two blobs of
+/// `payload`, the second blob being allocated first if `swapped`.
+Message<concreteprotocol::LweKeyswitchKey>
+splitKeyswitchKey(const std::vector<uint64_t> &payload, bool swapped) {
+  Message<concreteprotocol::LweKeyswitchKey> proto;
+  proto.asBuilder().initInfo().setCompression(
+      concreteprotocol::Compression::NONE);
+  auto blobs = proto.asBuilder().initPayload().initData(2);
+  size_t half = payload.size() / 2;
+  for (size_t i = 0; i < 2; i++) {
+    size_t index = swapped ? 1 - i : i;
+    auto blob = blobs.init(index, half * sizeof(uint64_t));
+    std::memcpy(blob.begin(), payload.data() + index * half,
+                half * sizeof(uint64_t));
+  }
+  return proto;
+}
+
+TEST(RuntimeContext, uses_mapped_keys_split_in_blobs_in_place) {
+  std::vector<uint64_t> payload(64);
+  std::iota(payload.begin(), payload.end(), 0);
+
+  // Blobs allocated in order follow each other, as for the keys of more than
+  // capnp::MAX_TEXT_SIZE bytes, and are viewed as a single array.
+  auto proto = splitKeyswitchKey(payload, false);
+  auto blob = proto.asReader().getPayload().getData()[0];
+  auto key = LweKeyswitchKey::fromProto(proto.asReader(), nullptr);
+  ASSERT_EQ(key.getRawPtr(), reinterpret_cast<const uint64_t *>(blob.begin()));
+  ASSERT_EQ(key.getSize(), payload.size());
+  ASSERT_EQ(key.getBuffer(), payload);
+
+  // Blobs which do not follow each other are copied.
+  auto swappedProto = splitKeyswitchKey(payload, true);
+  auto swappedBlob = swappedProto.asReader().getPayload().getData()[0];
+  auto copiedKey = LweKeyswitchKey::fromProto(swappedProto.asReader(), nullptr);
+  ASSERT_NE(copiedKey.getRawPtr(),
+            reinterpret_cast<const uint64_t *>(swappedBlob.begin()));
+  ASSERT_EQ(copiedKey.getBuffer(), payload);
+}
+
+TEST(RuntimeContext, uses_precomputed_fourier_bootstrap_key) {
+  Message<concreteprotocol::LweBootstrapKey> proto;
+  auto info = proto.asBuilder().initInfo();
+  info.setCompression(concreteprotocol::Compression::NONE);
+  auto params = info.initParams();
+  params.setLevelCount(1);
+  params.setBaseLog(10);
+  params.setGlweDimension(1);
+  params.setPolynomialSize(256);
+  params.setInputLweDimension(2);
+  std::vector<uint64_t> payload(2 * 1 * 2 * 2 * 256, 0);
+  proto.asBuilder().setPayload(
+      arrayToProtoPayload(payload.data(), payload.size()).asReader());
+  auto bsk = LweBootstrapKey::fromProto(proto);
+
+  auto fourierBuffer =
+      std::make_shared<std::vector<std::complex<double>>>(payload.size() / 2);
+  FourierLweBootstrapKey fourierBsk(
+      std::shared_ptr<const std::complex<double>>(fourierBuffer,
+                                                  fourierBuffer->data()),
+      fourierBuffer->size(), bsk.getInfo(), 256,
+      FourierLweBootstrapKey::LAYOUT_VERSION);
+
+  // The compression of the standard key does not matter, its parameters do.
+  auto compressedInfo = bsk.getInfo();
+  compressedInfo.asBuilder().setCompression(
+      concreteprotocol::Compression::SEED);
+  ASSERT_TRUE(fourierBsk.isUsableFor(compressedInfo));
+  auto otherInfo = bsk.getInfo();
+  otherInfo.asBuilder().getParams().setBaseLog(11);
+  ASSERT_FALSE(fourierBsk.isUsableFor(otherInfo));
+
+  ServerKeyset keyset;
+  keyset.lweBootstrapKeys.push_back(bsk);
+  keyset.fourierLweBootstrapKeys.push_back(fourierBsk);
+  RuntimeContext context{keyset};
+  ASSERT_EQ(context.fourier_bootstrap_key_buffer(0), fourierBuffer->data());
+}
+
+} // namespace
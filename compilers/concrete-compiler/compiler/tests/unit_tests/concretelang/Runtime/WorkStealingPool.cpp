@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "concretelang/Runtime/work_stealing_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using mlir::concretelang::ConcurrentScope;
+using mlir::concretelang::WorkStealingPool;
+
+TEST(WorkStealingPool, runs_every_submitted_task) {
+  WorkStealingPool pool(4);
+  std::atomic<int> counter{0};
+  std::vector<WorkStealingPool::Future> futures;
+  for (int i = 0; i < 100; i++)
+    futures.push_back(pool.submit([&]() { counter++; }));
+  for (auto &future : futures)
+    pool.wait(future);
+  ASSERT_EQ(counter.load(), 100);
+}
+
+TEST(WorkStealingPool, waiting_from_a_task_does_not_deadlock) {
+  // A single worker must run the nested tasks itself while waiting on them.
+  WorkStealingPool pool(1);
+  std::atomic<int> counter{0};
+  auto outer = pool.submit([&]() {
+    std::vector<WorkStealingPool::Future> inner;
+    for (int i = 0; i < 8; i++)
+      inner.push_back(pool.submit([&]() { counter++; }));
+    for (auto &future : inner)
+      pool.wait(future);
+  });
+  pool.wait(outer);
+  ASSERT_TRUE(outer->isDone());
+  ASSERT_EQ(counter.load(), 8);
+}
+
+TEST(WorkStealingPool, waiting_until_a_condition_runs_later_tasks) {
+  // The single worker waits on a condition set by a task submitted after it
+  // started waiting, which only that worker can run.
+  WorkStealingPool pool(1);
+  std::atomic<bool> started{false};
+  std::atomic<bool> set{false};
+  auto waiter = pool.submit([&]() {
+    started = true;
+    pool.waitUntil([&]() { return set.load(); });
+  });
+  while (!started)
+    std::this_thread::yield();
+  pool.submit([&]() {
+    set = true;
+    pool.notifyWaiters();
+  });
+  while (!waiter->isDone())
+    std::this_thread::yield();
+  ASSERT_TRUE(set.load());
+}
+
+TEST(WorkStealingPool, tasks_run_in_a_concurrent_scope) {
+  WorkStealingPool pool(2);
+  ASSERT_FALSE(ConcurrentScope::active());
+  std::atomic<bool> inScope{false};
+  auto task = pool.submit([&]() { inScope = ConcurrentScope::active(); });
+  pool.wait(task);
+  ASSERT_TRUE(inScope.load());
+  ASSERT_FALSE(ConcurrentScope::active());
+}
+
+TEST(WorkStealingPool, waiting_rethrows_the_task_exception) {
+  WorkStealingPool pool(2);
+  auto task = pool.submit([]() { throw std::runtime_error("task failed"); });
+  ASSERT_THROW(pool.wait(task), std::runtime_error);
+  ASSERT_TRUE(task->isDone());
+  // The worker survives the exception and keeps running tasks.
+  std::atomic<bool> ran{false};
+  auto next = pool.submit([&]() { ran = true; });
+  pool.wait(next);
+  ASSERT_TRUE(ran.load());
+}
+
+} // namespace
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 
 #include "concretelang/Runtime/wrappers.h"
 
@@ -11,4 +13,113 @@ TEST(WrappersDeathTest, bad_alloc) {
       "malloc\\(17179869183 GB\\).*Backtrace:.*");
 }
 
+/// Checks the matrix product against one multiply-accumulate per lwe
+/// coefficient, with shapes that are not multiples of the kernel blocks and
+/// a transposed view of the cleartexts.
+void checkMatmul(size_t rows, size_t inner, size_t columns, size_t lwe_size,
+                 bool transposed) {
+  std::mt19937_64 gen(rows * inner * columns + lwe_size);
+  std::vector<uint64_t> lhs(rows * inner * lwe_size);
+  for (auto &v : lhs)
+    v = gen();
+  std::vector<uint64_t> rhs(inner * columns);
+  for (auto &v : rhs)
+    v = gen() % 4 == 0 ? 0 : gen();
+  uint64_t rhs_stride0 = transposed ? 1 : columns;
+  uint64_t rhs_stride1 = transposed ? inner : 1;
+
+  std::vector<uint64_t> expected(rows * columns * lwe_size, 0);
+  for (size_t i = 0; i < rows; i++)
+    for (size_t j = 0; j < columns; j++)
+      for (size_t k = 0; k < inner; k++)
+        for (size_t l = 0; l < lwe_size; l++)
+          expected[(i * columns + j) * lwe_size + l] +=
+              lhs[(i * inner + k) * lwe_size + l] *
+              rhs[k * rhs_stride0 + j * rhs_stride1];
+
+  std::vector<uint64_t> out(rows * columns * lwe_size, 42);
+  memref_matmul_cleartext_lwe_ciphertext_u64(
+      out.data(), out.data(), 0, rows, columns, lwe_size, columns * lwe_size,
+      lwe_size, 1, lhs.data(), lhs.data(), 0, rows, inner, lwe_size,
+      inner * lwe_size, lwe_size, 1, rhs.data(), rhs.data(), 0, inner,
+      columns, rhs_stride0, rhs_stride1);
+
+  ASSERT_EQ(out, expected);
+}
+
+TEST(Wrappers, matmul_cleartext_lwe_ciphertext) {
+  checkMatmul(1, 1, 1, 1, false);
+  checkMatmul(3, 5, 7, 601, false);
+  checkMatmul(2, 9, 8, 513, true);
+  checkMatmul(4, 3, 2, 1025, true);
+}
+
+/// Checks the fused batched multiply-add against the unfused operations, the
+/// result being written in place of the addends.
+void checkBatchedMulAdd(size_t batch_size, size_t lwe_size) {
+  std::mt19937_64 gen(batch_size + lwe_size);
+  std::vector<uint64_t> cts(batch_size * lwe_size);
+  for (auto &v : cts)
+    v = gen();
+  std::vector<uint64_t> cleartexts(batch_size);
+  for (auto &v : cleartexts)
+    v = gen() % 3 == 0 ? 1 : gen();
+  std::vector<uint64_t> addends(batch_size * lwe_size);
+  for (auto &v : addends)
+    v = gen();
+
+  std::vector<uint64_t> expected(batch_size * lwe_size);
+  for (size_t i = 0; i < batch_size; i++)
+    for (size_t l = 0; l < lwe_size; l++)
+      expected[i * lwe_size + l] =
+          cts[i * lwe_size + l] * cleartexts[i] + addends[i * lwe_size + l];
+
+  memref_batched_mul_cleartext_add_lwe_ciphertext_u64(
+      addends.data(), addends.data(), 0, batch_size, lwe_size, lwe_size, 1,
+      cts.data(), cts.data(), 0, batch_size, lwe_size, lwe_size, 1,
+      cleartexts.data(), cleartexts.data(), 0, batch_size, 1, addends.data(),
+      addends.data(), 0, batch_size, lwe_size, lwe_size, 1);
+
+  ASSERT_EQ(addends, expected);
+}
+
+TEST(Wrappers, batched_mul_cleartext_add_lwe_ciphertext) {
+  checkBatchedMulAdd(1, 1);
+  checkBatchedMulAdd(7, 601);
+  // Large enough to be split over the batch threads
+  checkBatchedMulAdd(200, 1025);
+}
+
+TEST(Wrappers, batched_leveled_strided) {
+  size_t batch_size = 5;
+  size_t lwe_size = 33;
+  std::mt19937_64 gen(batch_size * lwe_size);
+  std::vector<uint64_t> cts(batch_size * lwe_size);
+  for (auto &v : cts)
+    v = gen();
+
+  // Transposed view of the ciphertexts, negated in place
+  std::vector<uint64_t> negated = cts;
+  memref_batched_negate_lwe_ciphertext_u64(
+      negated.data(), negated.data(), 0, lwe_size, batch_size, 1, lwe_size,
+      negated.data(), negated.data(), 0, lwe_size, batch_size, 1, lwe_size);
+  for (size_t i = 0; i < cts.size(); i++)
+    ASSERT_EQ(negated[i], -cts[i]);
+
+  // Every other plaintext of a buffer twice as large
+  std::vector<uint64_t> plaintexts(2 * batch_size);
+  for (auto &v : plaintexts)
+    v = gen();
+  std::vector<uint64_t> out(batch_size * lwe_size, 42);
+  memref_batched_add_plaintext_lwe_ciphertext_u64(
+      out.data(), out.data(), 0, batch_size, lwe_size, lwe_size, 1, cts.data(),
+      cts.data(), 0, batch_size, lwe_size, lwe_size, 1, plaintexts.data(),
+      plaintexts.data(), 0, batch_size, 2);
+  for (size_t i = 0; i < batch_size; i++)
+    for (size_t l = 0; l < lwe_size; l++)
+      ASSERT_EQ(out[i * lwe_size + l],
+                cts[i * lwe_size + l] +
+                    (l == lwe_size - 1 ? plaintexts[2 * i] : 0));
+}
+
 } // namespace
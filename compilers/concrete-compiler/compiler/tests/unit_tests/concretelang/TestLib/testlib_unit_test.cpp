@@ -127,6 +127,48 @@ func.func @main(%arg0: !FHE.eint<7>, %arg1: !FHE.eint<7>) -> !FHE.eint<7> {
   ASSERT_FALSE(res.has_value());
 }
 
+TEST(CompiledModule, call_batch_2s_1s) {
+  std::string source = R"(
+func.func @main(%arg0: !FHE.eint<7>, %arg1: !FHE.eint<7>) -> !FHE.eint<7> {
+  %1 = "FHE.add_eint"(%arg0, %arg1): (!FHE.eint<7>, !FHE.eint<7>) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+)";
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(source));
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverKeyset, circuit.getServerKeyset());
+
+  std::vector<uint64_t> expected;
+  std::vector<std::vector<TransportValue>> batch;
+  for (auto a : values_7bits())
+    for (auto b : values_7bits()) {
+      if (a > b) {
+        continue;
+      }
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          argA, clientCircuit.prepareInput(Tensor<uint64_t>(a), 0));
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          argB, clientCircuit.prepareInput(Tensor<uint64_t>(b), 1));
+      batch.push_back({argA, argB});
+      expected.push_back(a + b);
+    }
+
+  for (bool concurrent : {false, true}) {
+    ServerCircuit::BatchOptions options;
+    options.concurrent = concurrent;
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        returns, serverCircuit.callBatch(serverKeyset, batch, options));
+    ASSERT_EQ(returns.size(), batch.size());
+    for (size_t i = 0; i < returns.size(); i++) {
+      ASSERT_EQ(returns[i].size(), 1u);
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          out, clientCircuit.processOutput(returns[i][0], 0));
+      ASSERT_EQ(out.getTensor<uint64_t>().value()[0], expected[i]);
+    }
+  }
+}
+
 TEST(CompiledModule, call_1s_1t) {
   std::string source = R"(
 func.func @main(%arg0: !FHE.eint<7>) -> tensor<1x!FHE.eint<7>> {
@@ -3,6 +3,9 @@
 
 use core::panic;
 
+use concrete_cpu_noise_model::gaussian_noise::noise::blind_rotate::variance_blind_rotate;
+use concrete_cpu_noise_model::gaussian_noise::noise::multi_bit_blind_rotate::variance_multi_bit_blind_rotate;
+use concrete_optimizer::computing_cost::complexity_model::ComplexityModel;
 use concrete_optimizer::computing_cost::cpu::CpuComplexity;
 use concrete_optimizer::config;
 use concrete_optimizer::config::ProcessingUnit;
@@ -25,7 +28,8 @@ use concrete_optimizer::optimization::dag::solo_key::optimize_generic::{
 use concrete_optimizer::optimization::decomposition;
 use concrete_optimizer::optimization::decomposition::cmux::MaxVarianceError;
 use concrete_optimizer::parameters::{
-    BrDecompositionParameters, GlweParameters, KsDecompositionParameters,
+    BrDecompositionParameters, GlweParameters, KsDecompositionParameters, LweDimension,
+    PbsParameters,
 };
 use concrete_optimizer::utils::cache::persistent::default_cache_dir;
 use concrete_optimizer::utils::viz::Viz;
@@ -116,6 +120,80 @@ pub fn get_noise_br(
     }
 }
 
+// Grouping factors supported by the multi-bit fft noise model.
+const MULTI_BIT_GROUPING_FACTORS: std::ops::RangeInclusive<u32> = 2..=4;
+
+/// Returns the grouping factor, bounded by `max_grouping_factor`, of the fastest multi-bit
+/// bootstrap that is not noisier than the classic bootstrap with the same parameters, or 0 when
+/// the classic bootstrap should be kept. A multi-bit bootstrap satisfying this can replace the
+/// classic one without changing the error probability of the optimized circuit.
+pub fn get_multi_bit_grouping_factor(
+    options: &ffi::Options,
+    log2_polynomial_size: u64,
+    glwe_dimension: u64,
+    lwe_dim: u64,
+    pbs_level: u64,
+    pbs_log2_base: u64,
+    max_grouping_factor: u32,
+) -> u32 {
+    let glwe_params = GlweParameters {
+        log2_polynomial_size,
+        glwe_dimension,
+    };
+    let pbs_params = PbsParameters {
+        internal_lwe_dimension: LweDimension(lwe_dim),
+        br_decomposition_parameter: BrDecompositionParameters {
+            level: pbs_level,
+            log2_base: pbs_log2_base,
+        },
+        output_glwe_params: glwe_params,
+    };
+    let variance_bsk =
+        glwe_params.minimal_variance(options.ciphertext_modulus_log, options.security_level);
+    let classic_variance = variance_blind_rotate(
+        lwe_dim,
+        glwe_dimension,
+        glwe_params.polynomial_size(),
+        pbs_log2_base,
+        pbs_level,
+        options.ciphertext_modulus_log,
+        options.fft_precision,
+        variance_bsk,
+    );
+    let complexity_model = CpuComplexity::default();
+    let mut best_complexity =
+        complexity_model.pbs_complexity(pbs_params, options.ciphertext_modulus_log);
+    let mut best_grouping_factor = 0;
+    for grouping_factor in MULTI_BIT_GROUPING_FACTORS {
+        if grouping_factor > max_grouping_factor || lwe_dim % grouping_factor as u64 != 0 {
+            continue;
+        }
+        let variance = variance_multi_bit_blind_rotate(
+            lwe_dim,
+            glwe_dimension,
+            glwe_params.polynomial_size(),
+            pbs_log2_base,
+            pbs_level,
+            options.ciphertext_modulus_log,
+            options.fft_precision,
+            variance_bsk,
+            grouping_factor,
+            false,
+        );
+        let complexity = complexity_model.multi_bit_pbs_complexity(
+            pbs_params,
+            options.ciphertext_modulus_log,
+            grouping_factor,
+            false,
+        );
+        if variance <= classic_variance && complexity < best_complexity {
+            best_complexity = complexity;
+            best_grouping_factor = grouping_factor;
+        }
+    }
+    best_grouping_factor
+}
+
 fn optimize_bootstrap(precision: u64, noise_factor: f64, options: &ffi::Options) -> ffi::Solution {
     // Support composable since there is no dag
     let processing_unit = processing_unit(options);
@@ -556,6 +634,10 @@ impl Dag {
         self.0.viz_string()
     }
 
+    fn fingerprint(&self) -> String {
+        self.0.fingerprint()
+    }
+
     fn get_input_indices(&self) -> Vec<ffi::OperatorIndex> {
         self.0
             .get_input_operators_iter()
@@ -1035,6 +1117,17 @@ mod ffi {
             pbs_log2_base: u64,
         ) -> f64;
 
+        #[namespace = "concrete_optimizer::utils"]
+        fn get_multi_bit_grouping_factor(
+            options: &Options,
+            log2_polynomial_size: u64,
+            glwe_dimension: u64,
+            lwe_dim: u64,
+            pbs_level: u64,
+            pbs_log2_base: u64,
+            max_grouping_factor: u32,
+        ) -> u32;
+
         #[namespace = "concrete_optimizer::dag"]
         fn empty() -> Box<Dag>;
 
@@ -1042,6 +1135,8 @@ mod ffi {
 
         fn dump(self: &Dag) -> String;
 
+        fn fingerprint(self: &Dag) -> String;
+
         fn dump(self: &DagBuilder) -> String;
 
         unsafe fn add_input(
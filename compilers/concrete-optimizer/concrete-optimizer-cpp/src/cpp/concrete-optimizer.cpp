@@ -1445,6 +1445,8 @@ void concrete_optimizer$utils$cxxbridge1$generate_virtual_keyset_info(::rust::Ve
 ::concrete_optimizer::ExternalPartition *concrete_optimizer$utils$cxxbridge1$get_external_partition(::rust::String *name, ::std::uint64_t log2_polynomial_size, ::std::uint64_t glwe_dimension, ::std::uint64_t internal_dim, double max_variance, double variance) noexcept;
 
 double concrete_optimizer$utils$cxxbridge1$get_noise_br(::concrete_optimizer::Options const &options, ::std::uint64_t log2_polynomial_size, ::std::uint64_t glwe_dimension, ::std::uint64_t lwe_dim, ::std::uint64_t pbs_level, ::std::uint64_t pbs_log2_base) noexcept;
+
+::std::uint32_t concrete_optimizer$utils$cxxbridge1$get_multi_bit_grouping_factor(::concrete_optimizer::Options const &options, ::std::uint64_t log2_polynomial_size, ::std::uint64_t glwe_dimension, ::std::uint64_t lwe_dim, ::std::uint64_t pbs_level, ::std::uint64_t pbs_log2_base, ::std::uint32_t max_grouping_factor) noexcept;
 } // extern "C"
 } // namespace utils
 
@@ -1459,6 +1461,8 @@ extern "C" {
 
 void concrete_optimizer$cxxbridge1$Dag$dump(::concrete_optimizer::Dag const &self, ::rust::String *return$) noexcept;
 
+void concrete_optimizer$cxxbridge1$Dag$fingerprint(::concrete_optimizer::Dag const &self, ::rust::String *return$) noexcept;
+
 void concrete_optimizer$cxxbridge1$DagBuilder$dump(::concrete_optimizer::DagBuilder const &self, ::rust::String *return$) noexcept;
 
 ::concrete_optimizer::dag::OperatorIndex concrete_optimizer$cxxbridge1$DagBuilder$add_input(::concrete_optimizer::DagBuilder &self, ::std::uint8_t out_precision, ::rust::Slice<::std::uint64_t const> out_shape, ::concrete_optimizer::Location const &location) noexcept;
@@ -1598,6 +1602,10 @@ namespace utils {
 double get_noise_br(::concrete_optimizer::Options const &options, ::std::uint64_t log2_polynomial_size, ::std::uint64_t glwe_dimension, ::std::uint64_t lwe_dim, ::std::uint64_t pbs_level, ::std::uint64_t pbs_log2_base) noexcept {
   return concrete_optimizer$utils$cxxbridge1$get_noise_br(options, log2_polynomial_size, glwe_dimension, lwe_dim, pbs_level, pbs_log2_base);
 }
+
+::std::uint32_t get_multi_bit_grouping_factor(::concrete_optimizer::Options const &options, ::std::uint64_t log2_polynomial_size, ::std::uint64_t glwe_dimension, ::std::uint64_t lwe_dim, ::std::uint64_t pbs_level, ::std::uint64_t pbs_log2_base, ::std::uint32_t max_grouping_factor) noexcept {
+  return concrete_optimizer$utils$cxxbridge1$get_multi_bit_grouping_factor(options, log2_polynomial_size, glwe_dimension, lwe_dim, pbs_level, pbs_log2_base, max_grouping_factor);
+}
 } // namespace utils
 
 namespace dag {
@@ -1616,6 +1624,12 @@ namespace dag {
   return ::std::move(return$.value);
 }
 
+::rust::String Dag::fingerprint() const noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$cxxbridge1$Dag$fingerprint(*this, &return$.value);
+  return ::std::move(return$.value);
+}
+
 ::rust::String DagBuilder::dump() const noexcept {
   ::rust::MaybeUninit<::rust::String> return$;
   concrete_optimizer$cxxbridge1$DagBuilder$dump(*this, &return$.value);
@@ -233,6 +233,31 @@ TEST test_multi_parameters_2_precision_crt() {
   assert(circuit_solution.circuit_keys.conversion_keyswitch_keys.size() == 0);
 }
 
+TEST test_multi_bit_grouping_factor() {
+  auto options = default_options();
+  // With a coarse blind rotation decomposition, the decomposition noise
+  // dominates and is divided by the grouping factor, so every multi-bit
+  // bootstrap is less noisy than the classic one.
+  uint64_t log2_polynomial_size = 11;
+  uint64_t glwe_dimension = 1;
+  uint64_t lwe_dim = 840;
+  uint64_t pbs_level = 3;
+  uint64_t pbs_log2_base = 8;
+
+  // Multi-bit bootstrap disabled
+  assert(concrete_optimizer::utils::get_multi_bit_grouping_factor(
+             options, log2_polynomial_size, glwe_dimension, lwe_dim,
+             pbs_level, pbs_log2_base, 1) == 0);
+
+  // The largest allowed grouping factor is the fastest
+  assert(concrete_optimizer::utils::get_multi_bit_grouping_factor(
+             options, log2_polynomial_size, glwe_dimension, lwe_dim,
+             pbs_level, pbs_log2_base, 3) == 3);
+  assert(concrete_optimizer::utils::get_multi_bit_grouping_factor(
+             options, log2_polynomial_size, glwe_dimension, lwe_dim,
+             pbs_level, pbs_log2_base, 4) == 4);
+}
+
 int main() {
 
   test_v0();
@@ -243,6 +268,7 @@ int main() {
   test_multi_parameters_1_precision();
   test_multi_parameters_2_precision();
   test_multi_parameters_2_precision_crt();
+  test_multi_bit_grouping_factor();
 
   return 0;
 }
@@ -5,6 +5,7 @@ use crate::optimization::dag::multi_parameters::partition_cut::ExternalPartition
 use std::{
     collections::{HashMap, HashSet},
     fmt,
+    fmt::Write,
 };
 
 use super::operator::{
@@ -919,6 +920,61 @@ impl Dag {
     pub fn get_circuit_count(&self) -> usize {
         self.get_circuits_iter().count()
     }
+
+    /// Returns a description of the dag that only holds what the optimization depends on.
+    ///
+    /// Operator locations, circuit names, lookup table contents and comments are left out, so
+    /// that isomorphic dags share the same fingerprint, and therefore the same solution.
+    pub fn fingerprint(&self) -> String {
+        let mut circuits: Vec<&String> = vec![];
+        let mut out = String::new();
+        for (i, operator) in self.operators.iter().enumerate() {
+            let tag = &self.circuit_tags[i];
+            let position = circuits.iter().position(|c| *c == tag);
+            let circuit = position.unwrap_or_else(|| {
+                circuits.push(tag);
+                circuits.len() - 1
+            });
+            let operator = match operator {
+                Operator::Lut {
+                    input,
+                    out_precision,
+                    ..
+                } => Operator::Lut {
+                    input: *input,
+                    table: FunctionTable::UNKWOWN,
+                    out_precision: *out_precision,
+                },
+                Operator::LinearNoise {
+                    inputs,
+                    complexity,
+                    weights,
+                    out_shape,
+                    ..
+                } => Operator::LinearNoise {
+                    inputs: inputs.clone(),
+                    complexity: *complexity,
+                    weights: weights.clone(),
+                    out_shape: out_shape.clone(),
+                    comment: String::new(),
+                },
+                operator => operator.clone(),
+            };
+            writeln!(
+                out,
+                "{i} {circuit} {:?} {} {:?} <- {operator:?}",
+                self.output_state[i], self.out_precisions[i], self.out_shapes[i].dimensions_size,
+            )
+            .unwrap();
+        }
+        let mut composition: Vec<_> = self.composition.clone().into_iter().collect();
+        composition.sort_by_key(|(to, _)| to.0);
+        for (to, mut froms) in composition {
+            froms.sort_by_key(|from| from.0);
+            writeln!(out, "{froms:?} -> {to:?}").unwrap();
+        }
+        out
+    }
 }
 
 #[cfg(test)]
@@ -1184,4 +1240,27 @@ mod tests {
             assert_eq!(expected, actual, "{i}-th operation");
         }
     }
+
+    #[test]
+    fn fingerprint_ignores_names_locations_and_tables() {
+        let build = |name: &str, location: Location, table: Vec<u64>| {
+            let mut graph = Dag::new();
+            let mut builder = graph.builder(name);
+            let a = builder.add_input(3, Shape::vector(4), location.clone());
+            let b = builder.add_lut(a, FunctionTable { values: table }, 3, location);
+            let _ = builder.add_dot([b], [2], Location::Unknown);
+            graph
+        };
+        let reference = build("main", Location::Unknown, vec![0; 8]).fingerprint();
+        let renamed = build(
+            "other",
+            Location::Line(std::path::PathBuf::from("file.py"), 3),
+            (0..8).collect(),
+        );
+        assert_eq!(reference, renamed.fingerprint());
+
+        let mut different = build("main", Location::Unknown, vec![0; 8]);
+        let _ = different.add_input(2, Shape::number());
+        assert_ne!(reference, different.fingerprint());
+    }
 }